@@ -58,8 +58,14 @@ AccountList * gnc_accounts_and_all_descendants (AccountList *accounts);
 %ignore gnc_account_get_descendants;
 %ignore gnc_account_get_descendants_sorted;
 %ignore gnc_accounts_and_all_descendants;
+/* Wrapped per language as they take C arrays. */
+%ignore xaccAccountGetSplitsAtDates;
+%ignore xaccAccountGetBalancesAtDates;
 %include <Account.h>
 
+%ignore gnc_split_cursor_next;
+%include <gnc-split-cursor.h>
+
 %include <Transaction.h>
 
 %include <gnc-lot.h>
@@ -37,6 +37,7 @@
 #include "engine-helpers.h"
 #include "gnc-engine-guile.h"
 #include "policy.h"
+#include "gnc-split-table.h"
 #include "SX-book.h"
 #include "gnc-kvp-guile.h"
 #include "glib-guile.h"
@@ -194,6 +195,12 @@ functions. */
 %typemap(in) char * action;
 
 %include <policy.h>
+
+%newobject gnc_split_table_get_splits;
+%typemap(freearg) SplitList *splits "g_list_free($1);"
+%include <gnc-split-table.h>
+%clear SplitList *splits;
+
 %include <gnc-pricedb.h>
 
 QofSession * qof_session_new (QofBook* book);
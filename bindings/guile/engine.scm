@@ -29,3 +29,29 @@
 (load-and-reexport (sw_engine)
                    (gnucash engine business-core)
                    (gnucash engine gnc-numeric))
+
+(export gnc:account-for-each-split)
+(export gnc:query-for-each-split)
+
+;; call proc on each split of an account, or of the results of a query
+;; for splits. the splits are fetched batch-size at a time instead of
+;; converting the whole split list first.
+(define (split-cursor-for-each proc make-cursor batch-size)
+  (let ((cursor #f))
+    (dynamic-wind
+      (lambda () (set! cursor (make-cursor)))
+      (lambda ()
+        (let lp ((splits (gnc-split-cursor-next-list cursor batch-size)))
+          (unless (null? splits)
+            (for-each proc splits)
+            (lp (gnc-split-cursor-next-list cursor batch-size)))))
+      (lambda () (gnc-split-cursor-free cursor)))))
+
+(define* (gnc:account-for-each-split proc account #:optional (batch-size 256))
+  (split-cursor-for-each
+   proc (lambda () (gnc-split-cursor-new-for-account account)) batch-size))
+
+;; the query must not be run again by proc
+(define* (gnc:query-for-each-split proc query #:optional (batch-size 256))
+  (split-cursor-for-each
+   proc (lambda () (gnc-split-cursor-new-for-query query)) batch-size))
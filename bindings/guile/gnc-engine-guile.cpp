@@ -27,6 +27,7 @@
 #include "swig-runtime.h"
 #include <libguile.h>
 #include <cstring>
+#include <vector>
 
 #include "Account.h"
 #include "engine-helpers.h"
@@ -1840,6 +1841,46 @@ SCM gnc_account_value_ptr_to_scm (GncAccountValue *av)
                      gnc_numeric_to_scm (val));
 }
 
+SCM
+gnc_account_splits_at_dates (Account *acc, SCM dates)
+{
+    static swig_type_info *split_type = nullptr;
+    if (!split_type)
+        split_type = SWIG_TypeQuery ("_p_Split");
+
+    std::vector<time64> c_dates;
+    for (; !scm_is_null (dates); dates = SCM_CDR (dates))
+        c_dates.push_back (scm_to_int64 (SCM_CAR (dates)));
+
+    std::vector<Split*> splits (c_dates.size());
+    xaccAccountGetSplitsAtDates (acc, c_dates.size(), c_dates.data(), splits.data());
+
+    SCM result = SCM_EOL;
+    for (auto it = splits.rbegin(); it != splits.rend(); ++it)
+        result = scm_cons (*it ? SWIG_NewPointerObj (*it, split_type, 0) : SCM_BOOL_F,
+                           result);
+    return result;
+}
+
+SCM
+gnc_split_cursor_next_list (GncSplitCursor *cursor, int n)
+{
+    static swig_type_info *split_type = nullptr;
+    if (!split_type)
+        split_type = SWIG_TypeQuery ("_p_Split");
+
+    if (n <= 0)
+        return SCM_EOL;
+
+    std::vector<Split*> splits (n);
+    splits.resize (gnc_split_cursor_next (cursor, n, splits.data()));
+
+    SCM result = SCM_EOL;
+    for (auto it = splits.rbegin(); it != splits.rend(); ++it)
+        result = scm_cons (SWIG_NewPointerObj (*it, split_type, 0), result);
+    return result;
+}
+
 typedef struct
 {
     SCM proc;
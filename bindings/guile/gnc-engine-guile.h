@@ -31,6 +31,7 @@
 #include "gnc-engine.h"
 #include <gncTaxTable.h>    /* for GncAccountValue */
 #include "gnc-hooks.h"
+#include "gnc-split-cursor.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -71,6 +72,15 @@ GncAccountValue* gnc_scm_to_account_value_ptr(SCM valuearg);
 
 SCM gnc_account_value_ptr_to_scm(GncAccountValue*);
 
+/** Return a list with the last split of acc posted at or before each of
+ *  the dates, which must be sorted, or #f for dates before its first
+ *  split. See xaccAccountGetSplitsAtDates. */
+SCM gnc_account_splits_at_dates(Account* acc, SCM dates);
+
+/** Return a list of the next n splits of the cursor, which is shorter
+ *  or empty at its end. See gnc_split_cursor_next. */
+SCM gnc_split_cursor_next_list(GncSplitCursor* cursor, int n);
+
 /**
  * add Scheme-style danglers from a hook
  */
@@ -60,6 +60,7 @@
 #include "Transaction.h"
 #include "Split.h"
 #include "Account.h"
+#include "gnc-split-cursor.h"
 #include "gnc-commodity.h"
 #include "gnc-environment.h"
 #include "gnc-lot.h"
@@ -119,6 +120,89 @@
 
 %include <gnc-commodity.h>
 
+%inline %{
+/* Wraps xaccAccountGetBalancesAtDates. The dates must be sorted and may be
+ * dates, datetimes or time64 integers. */
+static PyObject *
+gnc_account_get_balances_at_dates (Account *acc, PyObject *dates)
+{
+    PyObject *result = NULL;
+    Py_ssize_t n_dates, i;
+    time64 *c_dates;
+    gnc_numeric *balances;
+
+    PyDateTime_IMPORT;
+    if (!PyList_Check(dates))
+    {
+        PyErr_SetString(PyExc_TypeError, "not a list");
+        return NULL;
+    }
+
+    n_dates = PyList_Size(dates);
+    c_dates = g_new(time64, n_dates);
+    balances = g_new(gnc_numeric, n_dates);
+    for (i = 0; i < n_dates; i++)
+    {
+        PyObject *date = PyList_GetItem(dates, i);
+        if (PyDate_Check(date))
+        {
+            gboolean has_time = PyDateTime_Check(date);
+            struct tm time = {has_time ? PyDateTime_DATE_GET_SECOND(date) : 0,
+                              has_time ? PyDateTime_DATE_GET_MINUTE(date) : 0,
+                              has_time ? PyDateTime_DATE_GET_HOUR(date) : 0,
+                              PyDateTime_GET_DAY(date),
+                              PyDateTime_GET_MONTH(date) - 1,
+                              PyDateTime_GET_YEAR(date) - 1900};
+            c_dates[i] = gnc_mktime(&time);
+        }
+        else if (PyLong_Check(date))
+            c_dates[i] = PyLong_AsLongLong(date);
+        else
+        {
+            PyErr_SetString(PyExc_ValueError, "date, datetime or integer expected");
+            goto out;
+        }
+    }
+
+    xaccAccountGetBalancesAtDates(acc, n_dates, c_dates, balances);
+    result = PyList_New(n_dates);
+    for (i = 0; i < n_dates; i++)
+    {
+        gnc_numeric *balance = malloc(sizeof(gnc_numeric));
+        *balance = balances[i];
+        PyList_SetItem(result, i, SWIG_NewPointerObj(balance, SWIGTYPE_p__gnc_numeric,
+                                                     SWIG_POINTER_OWN));
+    }
+
+out:
+    g_free(c_dates);
+    g_free(balances);
+    return result;
+}
+%}
+
+%inline %{
+/* Wraps gnc_split_cursor_next, returning a list of up to n splits. */
+static PyObject *
+gnc_split_cursor_next_list (GncSplitCursor *cursor, int n)
+{
+    PyObject *result;
+    Split **splits;
+    size_t count, i;
+
+    if (n <= 0)
+        return PyList_New(0);
+
+    splits = g_new(Split *, n);
+    count = gnc_split_cursor_next(cursor, n, splits);
+    result = PyList_New(count);
+    for (i = 0; i < count; i++)
+        PyList_SetItem(result, i, SWIG_NewPointerObj(splits[i], SWIGTYPE_p_Split, 0));
+    g_free(splits);
+    return result;
+}
+%}
+
 %typemap(out) GncOwner * {
     GncOwnerType owner_type = gncOwnerGetType($1);
     PyObject * owner_tuple = PyTuple_New(2);
@@ -725,6 +725,18 @@ def decorate_monetary_list_returning_function(orig_function):
                 for item in orig_function(self, *args) ]
     return new_function
 
+def _iter_split_cursor(new_cursor, instance, batch_size):
+    cursor = new_cursor(instance)
+    try:
+        while True:
+            splits = gnucash_core_c.gnc_split_cursor_next_list(cursor, batch_size)
+            if not splits:
+                return
+            for split in splits:
+                yield Split(instance=split)
+    finally:
+        gnucash_core_c.gnc_split_cursor_free(cursor)
+
 class Split(GnuCashCoreClass):
     """A GnuCash Split
 
@@ -757,6 +769,14 @@ class Account(GnuCashCoreClass):
     """
     _new_instance = 'xaccMallocAccount'
 
+    def iter_splits(self, batch_size=256):
+        """Iterate over the splits of the account in the order of
+        GetSplitList, wrapping batch_size of them at a time instead of
+        building a list of all of them."""
+        return _iter_split_cursor(
+            gnucash_core_c.gnc_split_cursor_new_for_account,
+            self.get_instance(), batch_size)
+
 class GUID(GnuCashCoreClass):
     _new_instance = 'guid_new_return'
 
@@ -994,7 +1014,8 @@ methods_return_instance_lists(
                'get_children': Account,
                'get_children_sorted': Account,
                'get_descendants': Account,
-               'get_descendants_sorted': Account
+               'get_descendants_sorted': Account,
+               'get_balances_at_dates': GncNumeric
                        })
 Account.name = property( Account.GetName, Account.SetName )
 
@@ -1080,6 +1101,14 @@ class Query(GnuCashCoreClass):
         self.__search_for_buf = obj_type
         self._search_for(self.__search_for_buf)
 
+    def iter_splits(self, batch_size=256):
+        """Run a query for splits and iterate over the results, wrapping
+        batch_size of them at a time. The query must not be run again
+        before the iteration is done."""
+        return _iter_split_cursor(
+            gnucash_core_c.gnc_split_cursor_new_for_query,
+            self.get_instance(), batch_size)
+
 Query.add_constructor_and_methods_with_prefix('qof_query_', 'create', exclude=["qof_query_search_for"])
 
 Query.add_method('qof_query_set_book', 'set_book')
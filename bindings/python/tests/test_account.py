@@ -22,6 +22,15 @@ class TestAccount(AccountSession):
         self.assertTrue(self.account.insert_split(SPLIT))
         self.assertTrue(self.account.remove_split(SPLIT))
 
+    def test_iter_splits(self):
+        for i in range(3):
+            self.assertTrue(self.account.insert_split(Split(self.book)))
+        splits = self.account.GetSplitList()
+        self.assertEqual(3, len(splits))
+        for batch_size in (1, 2, 256):
+            self.assertEqual(splits,
+                             list(self.account.iter_splits(batch_size)))
+
     def test_assignlots(self):
         abc = GncCommodity(self.book, 'ABC Fund',
             'COMMODITY','ABC','ABC',100000)
@@ -283,6 +283,34 @@ gnc_cm_event_handler (QofInstance *entity,
         gnc_gui_refresh_internal (FALSE);
 }
 
+/* Events coalesced by qof_event_end_batch: record the whole batch, then
+ * refresh once instead of once per event. */
+static void
+gnc_cm_event_batch_handler (const QofEventBatchEntry *entries,
+                            guint n_entries,
+                            gpointer user_data)
+{
+    guint i;
+
+    for (i = 0; i < n_entries; i++)
+    {
+        const QofEventBatchEntry *entry = &entries[i];
+
+        add_event (&changes, &entry->guid, entry->event_mask, TRUE);
+
+        /* See gnc_cm_event_handler about split events. */
+        if (g_strcmp0 (entry->type, GNC_ID_SPLIT) == 0)
+            add_event_type (&changes, GNC_ID_TRANS, QOF_EVENT_MODIFY, TRUE);
+        else
+            add_event_type (&changes, entry->type, entry->event_mask, TRUE);
+    }
+
+    got_events = TRUE;
+
+    if (suspend_counter == 0)
+        gnc_gui_refresh_internal (FALSE);
+}
+
 static gint handler_id;
 
 void
@@ -300,7 +328,9 @@ gnc_component_manager_init (void)
     changes_backup.event_masks = g_hash_table_new (g_str_hash, g_str_equal);
     changes_backup.entity_events = guid_hash_table_new ();
 
-    handler_id = qof_event_register_handler (gnc_cm_event_handler, NULL);
+    handler_id = qof_event_register_batch_handler (gnc_cm_event_handler,
+                                                   gnc_cm_event_batch_handler,
+                                                   QOF_EVENT_NONE, NULL);
 }
 
 void
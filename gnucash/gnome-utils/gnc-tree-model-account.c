@@ -89,6 +89,41 @@ static void gnc_tree_model_account_event_handler (QofInstance *entity,
         QofEventId event_type,
         GncTreeModelAccount *model,
         GncEventData *ed);
+static void gnc_tree_model_account_batch_handler (const QofEventBatchEntry *entries,
+        guint n_entries,
+        GncTreeModelAccount *model);
+
+/** The balances shown in the balance columns, each in the commodity
+ *  of its account. */
+typedef enum
+{
+    ACCOUNT_BALANCE_CURRENT,
+    ACCOUNT_BALANCE_CLEARED,
+    ACCOUNT_BALANCE_RECONCILED,
+    ACCOUNT_BALANCE_PRESENT,
+    ACCOUNT_BALANCE_FUTURE_MIN,
+    ACCOUNT_BALANCE_PERIOD_START,
+    ACCOUNT_BALANCE_PERIOD_END,
+    ACCOUNT_BALANCE_NUM_KINDS
+} AccountBalanceKind;
+
+/** The sums of the balances of all accounts in a subtree that share a
+ *  commodity. */
+typedef struct
+{
+    const gnc_commodity *commodity;
+    gnc_numeric sum[ACCOUNT_BALANCE_NUM_KINDS];
+} CommoditySums;
+
+/** The balances of an account and of its subtree.  The subtree sums are
+ *  built from the sums of the children, so computing a column for the
+ *  whole tree visits every account once. */
+typedef struct
+{
+    guint computed;    /**< Bit mask of the AccountBalanceKinds present. */
+    gnc_numeric own[ACCOUNT_BALANCE_NUM_KINDS];
+    GArray *subtree;   /**< CommoditySums of the account and descendants. */
+} AccountBalances;
 
 /** The instance data structure for an account tree model. */
 struct _GncTreeModelAccount
@@ -103,6 +138,11 @@ struct _GncTreeModelAccount
 
     GHashTable *account_values_hash;
 
+    /* Account -> AccountBalances, and the dates they were computed for */
+    GHashTable *account_balances;
+    time64 balances_today;
+    time64 balances_period_start;
+    time64 balances_period_end;
 };
 
 G_DEFINE_TYPE_WITH_CODE (GncTreeModelAccount,
@@ -114,6 +154,15 @@ G_DEFINE_TYPE_WITH_CODE (GncTreeModelAccount,
 /*           Account Tree Model - Misc Functions            */
 /************************************************************/
 
+static void
+account_balances_free (gpointer data)
+{
+    AccountBalances *balances = data;
+
+    g_array_free (balances->subtree, TRUE);
+    g_free (balances);
+}
+
 
 /** Tell the GncTreeModelAccount code to update the color that it will
  *  use for negative numbers.  This function will iterate over all
@@ -189,6 +238,9 @@ gnc_tree_model_account_init (GncTreeModelAccount *model)
     model->account_values_hash = g_hash_table_new_full (g_str_hash, g_str_equal,
                                                        g_free, g_free);
 
+    model->account_balances = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                                     NULL, account_balances_free);
+
     gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_NEGATIVE_IN_RED,
                            gnc_tree_model_account_update_color,
                            model);
@@ -237,6 +289,7 @@ gnc_tree_model_account_dispose (GObject *object)
 
     // destroy the cached account values
     g_hash_table_destroy (model->account_values_hash);
+    g_hash_table_destroy (model->account_balances);
 
     gnc_prefs_remove_cb_by_func (GNC_PREFS_GROUP_GENERAL, GNC_PREF_NEGATIVE_IN_RED,
                                  gnc_tree_model_account_update_color,
@@ -275,8 +328,12 @@ gnc_tree_model_account_new (Account *root)
     model->book = gnc_get_current_book();
     model->root = root;
 
-    model->event_handler_id = qof_event_register_handler
-                             ((QofEventHandler)gnc_tree_model_account_event_handler, model);
+    /* Adding and removing rows can't wait for the end of a batch, the
+     * view has to learn about them one at a time. */
+    model->event_handler_id = qof_event_register_batch_handler
+                             ((QofEventHandler)gnc_tree_model_account_event_handler,
+                              (QofEventBatchHandler)gnc_tree_model_account_batch_handler,
+                              QOF_EVENT_ADD | QOF_EVENT_REMOVE, model);
 
     LEAVE("model %p", model);
     return GTK_TREE_MODEL(model);
@@ -527,6 +584,251 @@ gnc_tree_model_account_set_color (GncTreeModelAccount *model,
         g_value_set_static_string (value, NULL);
 }
 
+/** Forget all balances if the dates they depend on have moved on.
+ *
+ *  @internal
+ */
+static void
+gnc_tree_model_account_check_balance_dates (GncTreeModelAccount *model)
+{
+    time64 today = gnc_time64_get_today_end ();
+    time64 t1 = gnc_accounting_period_fiscal_start ();
+    time64 t2 = gnc_accounting_period_fiscal_end ();
+
+    if (today == model->balances_today && t1 == model->balances_period_start &&
+        t2 == model->balances_period_end)
+        return;
+
+    g_hash_table_remove_all (model->account_balances);
+    model->balances_today = today;
+    model->balances_period_start = t1;
+    model->balances_period_end = t2;
+}
+
+static gboolean
+account_balance_date (GncTreeModelAccount *model, AccountBalanceKind kind,
+                      time64 *date)
+{
+    switch (kind)
+    {
+    case ACCOUNT_BALANCE_PRESENT:
+        *date = model->balances_today;
+        return TRUE;
+    case ACCOUNT_BALANCE_PERIOD_START:
+        *date = model->balances_period_start;
+        return TRUE;
+    case ACCOUNT_BALANCE_PERIOD_END:
+        *date = model->balances_period_end;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+static gnc_numeric
+account_own_balance (GncTreeModelAccount *model, Account *account,
+                     AccountBalanceKind kind)
+{
+    time64 date;
+
+    if (account_balance_date (model, kind, &date))
+        return xaccAccountGetBalanceAsOfDate (account, date);
+
+    switch (kind)
+    {
+    case ACCOUNT_BALANCE_CLEARED:
+        return xaccAccountGetClearedBalance (account);
+    case ACCOUNT_BALANCE_RECONCILED:
+        return xaccAccountGetReconciledBalance (account);
+    case ACCOUNT_BALANCE_FUTURE_MIN:
+        return xaccAccountGetProjectedMinimumBalance (account);
+    default:
+        return xaccAccountGetBalance (account);
+    }
+}
+
+/* Convert a balance the way the xaccAccountGet*BalanceInCurrency
+ * functions do: at the latest price, or at the price before the date
+ * the balance was taken. */
+static gnc_numeric
+account_convert_balance (GncTreeModelAccount *model, Account *account,
+                         AccountBalanceKind kind, gnc_numeric balance,
+                         const gnc_commodity *from, const gnc_commodity *to)
+{
+    time64 date;
+
+    if (!from || gnc_numeric_zero_p (balance))
+        return gnc_numeric_zero ();
+
+    if (account_balance_date (model, kind, &date))
+        return xaccAccountConvertBalanceToCurrencyAsOfDate (account, balance,
+                                                            from, to, date);
+
+    return xaccAccountConvertBalanceToCurrency (account, balance, from, to);
+}
+
+static void
+commodity_sums_add (GArray *subtree, const gnc_commodity *commodity,
+                    AccountBalanceKind kind, gnc_numeric amount)
+{
+    CommoditySums *sums, new_sums;
+    guint i;
+
+    for (i = 0; i < subtree->len; i++)
+    {
+        sums = &g_array_index (subtree, CommoditySums, i);
+        if (sums->commodity == commodity)
+        {
+            sums->sum[kind] = gnc_numeric_add (sums->sum[kind], amount,
+                                               gnc_commodity_get_fraction (commodity),
+                                               GNC_HOW_RND_ROUND_HALF_UP);
+            return;
+        }
+    }
+
+    new_sums.commodity = commodity;
+    for (i = 0; i < ACCOUNT_BALANCE_NUM_KINDS; i++)
+        new_sums.sum[i] = gnc_numeric_zero ();
+    new_sums.sum[kind] = amount;
+    g_array_append_val (subtree, new_sums);
+}
+
+/** Look up the balances of an account, computing the requested kind for
+ *  the account and, bottom up, for any descendants that don't have it
+ *  yet.
+ *
+ *  @internal
+ */
+static AccountBalances *
+gnc_tree_model_account_get_balances (GncTreeModelAccount *model,
+                                     Account *account,
+                                     AccountBalanceKind kind)
+{
+    AccountBalances *balances;
+    const gnc_commodity *commodity;
+    GList *children, *node;
+    guint i;
+
+    balances = g_hash_table_lookup (model->account_balances, account);
+    if (!balances)
+    {
+        balances = g_new0 (AccountBalances, 1);
+        balances->subtree = g_array_new (FALSE, FALSE, sizeof (CommoditySums));
+        g_hash_table_insert (model->account_balances, account, balances);
+    }
+
+    if (balances->computed & (1 << kind))
+        return balances;
+
+    for (i = 0; i < balances->subtree->len; i++)
+        g_array_index (balances->subtree, CommoditySums, i).sum[kind] = gnc_numeric_zero ();
+
+    balances->own[kind] = account_own_balance (model, account, kind);
+    commodity = xaccAccountGetCommodity (account);
+    if (commodity)
+        commodity_sums_add (balances->subtree, commodity, kind, balances->own[kind]);
+
+    children = gnc_account_get_children (account);
+    for (node = children; node; node = g_list_next (node))
+    {
+        AccountBalances *child;
+
+        child = gnc_tree_model_account_get_balances (model, node->data, kind);
+        for (i = 0; i < child->subtree->len; i++)
+        {
+            CommoditySums *sums = &g_array_index (child->subtree, CommoditySums, i);
+            commodity_sums_add (balances->subtree, sums->commodity, kind,
+                                sums->sum[kind]);
+        }
+    }
+    g_list_free (children);
+
+    balances->computed |= 1 << kind;
+    return balances;
+}
+
+/** Compute a balance of an account like the matching
+ *  xaccAccountGet*BalanceInCurrency function, but from the balances
+ *  kept by the model.  The subtree is converted one commodity at a time
+ *  rather than one account at a time.
+ *
+ *  @internal
+ */
+static gnc_numeric
+gnc_tree_model_account_get_balance (GncTreeModelAccount *model,
+                                    Account *account,
+                                    AccountBalanceKind kind,
+                                    gboolean recurse,
+                                    const gnc_commodity *report_commodity)
+{
+    AccountBalances *balances;
+    gnc_numeric total;
+    guint i;
+
+    if (!report_commodity)
+        report_commodity = xaccAccountGetCommodity (account);
+    if (!report_commodity)
+        return gnc_numeric_zero ();
+
+    gnc_tree_model_account_check_balance_dates (model);
+    balances = gnc_tree_model_account_get_balances (model, account, kind);
+
+    if (!recurse)
+        return account_convert_balance (model, account, kind, balances->own[kind],
+                                        xaccAccountGetCommodity (account),
+                                        report_commodity);
+
+    total = gnc_numeric_zero ();
+    for (i = 0; i < balances->subtree->len; i++)
+    {
+        CommoditySums *sums = &g_array_index (balances->subtree, CommoditySums, i);
+        gnc_numeric balance;
+
+        balance = account_convert_balance (model, account, kind, sums->sum[kind],
+                                           sums->commodity, report_commodity);
+        total = gnc_numeric_add (total, balance,
+                                 gnc_commodity_get_fraction (report_commodity),
+                                 GNC_HOW_RND_ROUND_HALF_UP);
+    }
+    return total;
+}
+
+/** Format a balance of an account like gnc_ui_account_get_print_balance
+ *  or, for the report columns, gnc_ui_account_get_print_report_balance.
+ *
+ *  @internal
+ */
+static gchar *
+gnc_tree_model_account_print_balance (GncTreeModelAccount *model,
+                                      Account *account,
+                                      AccountBalanceKind kind,
+                                      gboolean recurse,
+                                      gboolean report,
+                                      gboolean *negative)
+{
+    GNCPrintAmountInfo print_info;
+    gnc_commodity *report_commodity = NULL;
+    gnc_numeric balance;
+
+    if (report)
+        report_commodity = gnc_default_report_currency ();
+
+    balance = gnc_tree_model_account_get_balance (model, account, kind,
+                                                  recurse, report_commodity);
+    if (gnc_reverse_balance (account))
+        balance = gnc_numeric_neg (balance);
+
+    if (negative)
+        *negative = gnc_numeric_negative_p (balance);
+
+    if (report)
+        print_info = gnc_commodity_print_info (report_commodity, TRUE);
+    else
+        print_info = gnc_account_print_info (account, TRUE);
+
+    return g_strdup (gnc_print_amount_with_bidi_ltr_isolate (balance, print_info));
+}
+
 static gchar *
 gnc_tree_model_account_compute_period_balance (GncTreeModelAccount *model,
                                                Account *acct,
@@ -534,8 +836,7 @@ gnc_tree_model_account_compute_period_balance (GncTreeModelAccount *model,
                                                gboolean *negative)
 {
     GNCPrintAmountInfo print_info;
-    time64 t1, t2;
-    gnc_numeric b3;
+    gnc_numeric b1, b2, b3;
 
     if (negative)
         *negative = FALSE;
@@ -543,13 +844,15 @@ gnc_tree_model_account_compute_period_balance (GncTreeModelAccount *model,
     if (acct == model->root)
         return g_strdup ("");
 
-    t1 = gnc_accounting_period_fiscal_start ();
-    t2 = gnc_accounting_period_fiscal_end ();
-
-    if (t1 > t2)
+    gnc_tree_model_account_check_balance_dates (model);
+    if (model->balances_period_start > model->balances_period_end)
         return g_strdup ("");
 
-    b3 = xaccAccountGetBalanceChangeForPeriod (acct, t1, t2, recurse);
+    b1 = gnc_tree_model_account_get_balance (model, acct, ACCOUNT_BALANCE_PERIOD_START,
+                                             recurse, NULL);
+    b2 = gnc_tree_model_account_get_balance (model, acct, ACCOUNT_BALANCE_PERIOD_END,
+                                             recurse, NULL);
+    b3 = gnc_numeric_sub (b2, b1, GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED);
     if (gnc_reverse_balance (acct))
         b3 = gnc_numeric_neg (b3);
 
@@ -578,6 +881,7 @@ gnc_tree_model_account_clear_cache (GncTreeModelAccount *model)
         g_hash_table_destroy (model->account_values_hash);
         model->account_values_hash = g_hash_table_new_full (g_str_hash, g_str_equal,
                                                            g_free, g_free);
+        g_hash_table_remove_all (model->account_balances);
 
         gtk_tree_model_foreach (GTK_TREE_MODEL(model), row_changed_foreach_func, NULL);
     }
@@ -601,6 +905,8 @@ clear_account_cached_values (GncTreeModelAccount *model, GHashTable *hash, Accou
         gtk_tree_path_free (path);
     }
 
+    g_hash_table_remove (model->account_balances, account);
+
     guid_to_string_buff (xaccAccountGetGUID (account), acct_guid_str);
 
     // loop over the columns and remove any found
@@ -743,40 +1049,40 @@ gnc_tree_model_account_get_value (GtkTreeModel *tree_model,
 
     case GNC_TREE_MODEL_ACCOUNT_COL_PRESENT:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetPresentBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_PRESENT,
+                 TRUE, FALSE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_PRESENT_REPORT:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_report_balance (xaccAccountGetPresentBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_PRESENT,
+                 TRUE, TRUE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_COLOR_PRESENT:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetPresentBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_PRESENT,
+                 TRUE, FALSE, &negative);
         gnc_tree_model_account_set_color (model, negative, value);
         g_free (string);
         break;
 
     case GNC_TREE_MODEL_ACCOUNT_COL_BALANCE:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetBalanceInCurrency,
-                 account, FALSE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_CURRENT,
+                 FALSE, FALSE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_BALANCE_REPORT:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_report_balance (xaccAccountGetBalanceInCurrency,
-                 account, FALSE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_CURRENT,
+                 FALSE, TRUE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_COLOR_BALANCE:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetBalanceInCurrency,
-                 account, FALSE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_CURRENT,
+                 FALSE, FALSE, &negative);
         gnc_tree_model_account_set_color (model, negative, value);
         g_free (string);
         break;
@@ -806,34 +1112,34 @@ gnc_tree_model_account_get_value (GtkTreeModel *tree_model,
 
     case GNC_TREE_MODEL_ACCOUNT_COL_CLEARED:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetClearedBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_CLEARED,
+                 TRUE, FALSE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_CLEARED_REPORT:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_report_balance (xaccAccountGetClearedBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_CLEARED,
+                 TRUE, TRUE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_COLOR_CLEARED:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetClearedBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_CLEARED,
+                 TRUE, FALSE, &negative);
         gnc_tree_model_account_set_color (model, negative, value);
         g_free (string);
         break;
 
     case GNC_TREE_MODEL_ACCOUNT_COL_RECONCILED:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetReconciledBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_RECONCILED,
+                 TRUE, FALSE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_RECONCILED_REPORT:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_report_balance (xaccAccountGetReconciledBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_RECONCILED,
+                 TRUE, TRUE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_RECONCILED_DATE:
@@ -844,48 +1150,48 @@ gnc_tree_model_account_get_value (GtkTreeModel *tree_model,
 
     case GNC_TREE_MODEL_ACCOUNT_COL_COLOR_RECONCILED:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetReconciledBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_RECONCILED,
+                 TRUE, FALSE, &negative);
         gnc_tree_model_account_set_color (model, negative, value);
         g_free (string);
         break;
 
     case GNC_TREE_MODEL_ACCOUNT_COL_FUTURE_MIN:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetProjectedMinimumBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_FUTURE_MIN,
+                 TRUE, FALSE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_FUTURE_MIN_REPORT:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_report_balance (xaccAccountGetProjectedMinimumBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_FUTURE_MIN,
+                 TRUE, TRUE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_COLOR_FUTURE_MIN:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetProjectedMinimumBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_FUTURE_MIN,
+                 TRUE, FALSE, &negative);
         gnc_tree_model_account_set_color (model, negative, value);
         g_free (string);
         break;
 
     case GNC_TREE_MODEL_ACCOUNT_COL_TOTAL:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_CURRENT,
+                 TRUE, FALSE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_TOTAL_REPORT:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_report_balance (xaccAccountGetBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_CURRENT,
+                 TRUE, TRUE, &negative);
         g_value_take_string (value, string);
         break;
     case GNC_TREE_MODEL_ACCOUNT_COL_COLOR_TOTAL:
         g_value_init (value, G_TYPE_STRING);
-        string = gnc_ui_account_get_print_balance (xaccAccountGetBalanceInCurrency,
-                 account, TRUE, &negative);
+        string = gnc_tree_model_account_print_balance (model, account, ACCOUNT_BALANCE_CURRENT,
+                 TRUE, FALSE, &negative);
         gnc_tree_model_account_set_color (model, negative, value);
         g_free (string);
         break;
@@ -1433,6 +1739,10 @@ gnc_tree_model_account_event_handler (QofInstance *entity,
     if (event_type != QOF_EVENT_ADD)
         gnc_tree_model_account_clear_cached_values (model, account);
 
+    /* the subtree sums of the old or new parent are out of date */
+    if (event_type == QOF_EVENT_ADD || event_type == QOF_EVENT_REMOVE)
+        g_hash_table_remove_all (model->account_balances);
+
     /* What to do, that to do. */
     switch (event_type)
     {
@@ -1500,3 +1810,48 @@ gnc_tree_model_account_event_handler (QofInstance *entity,
     LEAVE(" ");
     return;
 }
+
+/** This function handles the events of an event batch.  Between them,
+ *  the accounts of a bulk operation like an import get an event for
+ *  every split added to them.  Clear the cached values of each changed
+ *  account and its ancestors and update its row once instead.
+ *
+ *  @internal
+ */
+static void
+gnc_tree_model_account_batch_handler (const QofEventBatchEntry *entries,
+                                      guint n_entries,
+                                      GncTreeModelAccount *model)
+{
+    GHashTable *changed;
+    GHashTableIter iter;
+    gpointer account;
+    guint i;
+
+    g_return_if_fail (model);    /* Required */
+
+    ENTER("%u entries, model %p", n_entries, model);
+    changed = g_hash_table_new (g_direct_hash, g_direct_equal);
+    for (i = 0; i < n_entries; i++)
+    {
+        Account *acc;
+
+        if (g_strcmp0 (entries[i].type, GNC_ID_ACCOUNT) != 0)
+            continue;
+
+        acc = xaccAccountLookup (&entries[i].guid, model->book);
+        if (!acc || gnc_account_get_root (acc) != model->root)
+            continue;
+
+        for (; acc && !g_hash_table_contains (changed, acc);
+             acc = gnc_account_get_parent (acc))
+            g_hash_table_add (changed, acc);
+    }
+
+    g_hash_table_iter_init (&iter, changed);
+    while (g_hash_table_iter_next (&iter, &account, NULL))
+        clear_account_cached_values (model, model->account_values_hash, account);
+
+    g_hash_table_destroy (changed);
+    LEAVE(" ");
+}
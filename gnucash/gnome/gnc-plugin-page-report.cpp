@@ -762,8 +762,9 @@ gnc_plugin_page_report_load_cb (GncHtml * html, URLType type,
 
 
 /** This function is called when one of the options for a report
- *  page has changed.  It is responsible for marking the report as
- *  dirty, and causing the report to reload using the new options.
+ *  page has changed.  It is responsible for causing the report to
+ *  reload using the new options.  The report isn't marked dirty: it's
+ *  rendered again because its options key has changed.
  *
  *  @note This function currently also calls the main window code to
  *  update it if the name of the report has changed.  This code should
@@ -778,7 +779,6 @@ gnc_plugin_page_report_option_change_cb(gpointer data)
     GncPluginPage *page;
     GncPluginPageReport *report;
     GncPluginPageReportPrivate *priv;
-    SCM dirty_report = scm_c_eval_string("gnc:report-set-dirty?!");
 
     g_return_if_fail(GNC_IS_PLUGIN_PAGE_REPORT(data));
     report = GNC_PLUGIN_PAGE_REPORT(data);
@@ -788,7 +788,7 @@ gnc_plugin_page_report_option_change_cb(gpointer data)
     DEBUG( "option_change" );
     if (priv->cur_report == SCM_BOOL_F)
         return;
-    DEBUG( "set-dirty, queue-draw" );
+    DEBUG( "queue-draw" );
 
     /* Update the page (i.e. the notebook tab and window title) */
     std::string old_name{gnc_plugin_page_get_page_name(GNC_PLUGIN_PAGE(report))};
@@ -805,9 +805,6 @@ gnc_plugin_page_report_option_change_cb(gpointer data)
         g_free(clean_name);
     }
 
-    /* it's probably already dirty, but make sure */
-    scm_call_2(dirty_report, priv->cur_report, SCM_BOOL_T);
-
     gnc_plugin_set_actions_enabled(G_ACTION_MAP(priv->action_group),
                                    disable_during_load_actions, FALSE);
     // prevent closing this page while loading...
@@ -1459,7 +1456,6 @@ gnc_plugin_page_report_reload_cb (GSimpleAction *simple,
     GncPluginPageReport *report = (GncPluginPageReport*)user_data;
     GncPluginPage *page;
     GncPluginPageReportPrivate *priv;
-    SCM dirty_report;
 
     DEBUG( "reload" );
     page = GNC_PLUGIN_PAGE(report);
@@ -1468,10 +1464,10 @@ gnc_plugin_page_report_reload_cb (GSimpleAction *simple,
         return;
 
     DEBUG( "reload-redraw" );
-    dirty_report = scm_c_eval_string("gnc:report-set-dirty?!");
-    scm_call_2(dirty_report, priv->cur_report, SCM_BOOL_T);
 
-    /* now queue the fact that we need to reload this report */
+    /* now queue the fact that we need to reload this report. It's only
+     * rendered again if the book, the preferences or its options have
+     * changed since it was last rendered. */
     // Disable some actions reported to crash while loading
     gnc_plugin_set_actions_enabled(G_ACTION_MAP(priv->action_group),
                                    disable_during_load_actions, FALSE);
@@ -0,0 +1,453 @@
+/*
+ * gnucash-benchmark.cpp -- Whole-book benchmarks for GnuCash
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, contact:
+ *
+ * Free Software Foundation           Voice:  +1-617-542-5942
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org
+ */
+
+/* gnucash-benchmark generates a book with the test-engine-stuff
+ * generators, seeded so that the same parameters always produce the
+ * same book, and times saving and loading it with the XML and SQLite
+ * backends, scrubbing it, and running reports on it with gnucash-cli.
+ * The results are written as JSON. It isn't built by default; build the
+ * gnucash-benchmark target.
+ */
+
+#include <config.h>
+
+#include "gnucash-core-app.hpp"
+
+#include <glib.h>
+#include <gnc-engine.h>
+#include <Account.h>
+#include <Scrub.h>
+#include <ScrubBusiness.h>
+#include <TransLog.h>
+#include <gnc-pricedb.h>
+#include <qofsession.h>
+#include <test-engine-stuff.h>
+
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* This static indicates the debugging module that this .o belongs to.  */
+static QofLogModule log_module = GNC_MOD_GUI;
+
+namespace Gnucash {
+
+    struct BenchResult
+    {
+        std::string name;
+        double wall_time;  // seconds
+        double cpu_time;   // seconds, user + system
+        long peak_rss;     // kilobytes, -1 if not available
+        int status;        // 0 for success, -1 if skipped
+    };
+
+    class GnucashBenchmark : public CoreApp
+    {
+    public:
+        GnucashBenchmark (const char* app_name);
+        void parse_command_line (int argc, char **argv);
+        int start (int argc, char **argv);
+    private:
+        void configure_program_options (void);
+        void generate_book (QofBook *book);
+        int save_book (QofSession *session, const std::string& uri);
+        int load_book (const std::string& uri, QofSession **session);
+        void run_phase (const std::string& name, std::function<int()> phase);
+        void run_report (const std::string& report, const std::string& datafile);
+        void write_results (std::ostream& out);
+
+        int m_accounts = 100;
+        int m_transactions = 10000;
+        int m_prices = 1000;
+        unsigned int m_seed = 1;
+        std::vector<std::string> m_reports;
+        boost::optional <std::string> m_output_file;
+        boost::optional <std::string> m_work_dir;
+        boost::optional <std::string> m_cli;
+
+        std::vector<BenchResult> m_results;
+    };
+
+}
+
+static double
+process_cpu_time (void)
+{
+#ifdef HAVE_SYS_RESOURCE_H
+    struct rusage usage;
+    getrusage (RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+        usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+#else
+    return static_cast<double>(std::clock ()) / CLOCKS_PER_SEC;
+#endif
+}
+
+#ifdef HAVE_SYS_RESOURCE_H
+static long
+rusage_peak_rss (const struct rusage& usage)
+{
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // macOS reports bytes, everyone else KiB.
+#else
+    return usage.ru_maxrss;
+#endif
+}
+#endif
+
+/* The operating system only keeps the high water mark for the whole
+ * process, so a phase's peak is the largest of it and all of the
+ * phases before it. */
+static long
+process_peak_rss (void)
+{
+#ifdef HAVE_SYS_RESOURCE_H
+    struct rusage usage;
+    getrusage (RUSAGE_SELF, &usage);
+    return rusage_peak_rss (usage);
+#else
+    return -1;
+#endif
+}
+
+static std::string
+json_string (const std::string& str)
+{
+    std::string rv{"\""};
+    for (auto c : str)
+    {
+        switch (c)
+        {
+        case '"':  rv += "\\\""; break;
+        case '\\': rv += "\\\\"; break;
+        case '\n': rv += "\\n"; break;
+        case '\t': rv += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buf[8];
+                snprintf (buf, sizeof buf, "\\u%04x", c);
+                rv += buf;
+            }
+            else
+                rv += c;
+        }
+    }
+    return rv + "\"";
+}
+
+Gnucash::GnucashBenchmark::GnucashBenchmark (const char *app_name) : Gnucash::CoreApp (app_name)
+{
+    configure_program_options();
+}
+
+void
+Gnucash::GnucashBenchmark::parse_command_line (int argc, char **argv)
+{
+    Gnucash::CoreApp::parse_command_line (argc, argv);
+
+    if (!m_log_to_filename || m_log_to_filename->empty())
+        m_log_to_filename = "stderr";
+
+    if (m_reports.empty())
+        m_reports = {"Account Summary", "Balance Sheet", "Income Statement",
+                     "Transaction Report"};
+
+    if (!m_cli)
+    {
+        auto dir = g_path_get_dirname (argv[0]);
+        auto cli = g_build_filename (dir, PROJECT_NAME "-cli", nullptr);
+        m_cli = cli;
+        g_free (cli);
+        g_free (dir);
+    }
+}
+
+// Define command line options specific to gnucash-benchmark.
+void
+Gnucash::GnucashBenchmark::configure_program_options (void)
+{
+    bpo::options_description bench_options("Benchmark Options");
+    bench_options.add_options()
+    ("accounts", bpo::value (&m_accounts)->default_value (m_accounts),
+     "Number of accounts in the generated book")
+    ("transactions", bpo::value (&m_transactions)->default_value (m_transactions),
+     "Number of transactions in the generated book")
+    ("prices", bpo::value (&m_prices)->default_value (m_prices),
+     "Number of prices in the generated book")
+    ("seed", bpo::value (&m_seed)->default_value (m_seed),
+     "Seed for the book generator; the same seed and sizes always generate the same book")
+    ("report", bpo::value (&m_reports),
+     "Name of a report to run on the generated book. This can be invoked multiple times. Defaults to a few standard reports.")
+    ("work-dir", bpo::value (&m_work_dir),
+     "Directory for the generated files; defaults to a new temporary directory")
+    ("cli", bpo::value (&m_cli),
+     "The gnucash-cli used to run the reports; defaults to the one next to this program")
+    ("output-file", bpo::value (&m_output_file),
+     "Write the JSON results to this file instead of standard output");
+
+    m_opt_desc_display->add (bench_options);
+    m_opt_desc_all.add (bench_options);
+}
+
+void
+Gnucash::GnucashBenchmark::generate_book (QofBook *book)
+{
+    srand (m_seed);
+
+    for (int i = 0; i < m_accounts; ++i)
+        get_random_account (book);
+
+    add_random_transactions_to_book (book, m_transactions);
+
+    auto db = gnc_pricedb_get_db (book);
+    for (int i = 0; i < m_prices; )
+    {
+        auto price = get_random_price (book);
+        /* Adding fails if there's already a price for the commodity
+         * pair and time, so try another one. */
+        if (gnc_pricedb_add_price (db, price))
+            ++i;
+        gnc_price_unref (price);
+    }
+}
+
+/* Returns -1 if there's no backend for the URI, e.g. SQLite when
+ * GnuCash is built without SQL support. */
+int
+Gnucash::GnucashBenchmark::save_book (QofSession *session, const std::string& uri)
+{
+    qof_session_begin (session, uri.c_str(), SESSION_NEW_OVERWRITE);
+    auto error = qof_session_get_error (session);
+    if (error == ERR_BACKEND_BAD_URL || error == ERR_BACKEND_NO_HANDLER)
+    {
+        std::cerr << "No backend for " << uri << ", skipping it." << std::endl;
+        return -1;
+    }
+    if (error == ERR_BACKEND_NO_ERR)
+    {
+        /* The session only saves dirty books and the book is clean after
+         * the first save. */
+        qof_book_mark_session_dirty (qof_session_get_book (session));
+        qof_session_save (session, nullptr);
+        error = qof_session_get_error (session);
+    }
+    if (error != ERR_BACKEND_NO_ERR)
+        PERR ("Saving %s failed: %s", uri.c_str(),
+              qof_session_get_error_message (session));
+    qof_session_end (session);
+    return error == ERR_BACKEND_NO_ERR ? 0 : 1;
+}
+
+int
+Gnucash::GnucashBenchmark::load_book (const std::string& uri, QofSession **session)
+{
+    *session = qof_session_new (qof_book_new ());
+    qof_session_begin (*session, uri.c_str(), SESSION_READ_ONLY);
+    if (qof_session_get_error (*session) == ERR_BACKEND_NO_ERR)
+        qof_session_load (*session, nullptr);
+    auto error = qof_session_get_error (*session);
+    if (error != ERR_BACKEND_NO_ERR)
+    {
+        PERR ("Loading %s failed: %s", uri.c_str(),
+              qof_session_get_error_message (*session));
+        return 1;
+    }
+    return 0;
+}
+
+void
+Gnucash::GnucashBenchmark::run_phase (const std::string& name,
+                                      std::function<int()> phase)
+{
+    std::cerr << name << "..." << std::endl;
+    auto cpu_start = process_cpu_time ();
+    auto wall_start = std::chrono::steady_clock::now ();
+    auto status = phase ();
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now () - wall_start;
+    m_results.push_back ({name, wall.count (), process_cpu_time () - cpu_start,
+                          process_peak_rss (), status});
+}
+
+/* Reports are run in a separate gnucash-cli process so that each one is
+ * measured on its own and starts with a freshly loaded book, the same as
+ * gnucash-cli --report run. */
+void
+Gnucash::GnucashBenchmark::run_report (const std::string& report,
+                                       const std::string& datafile)
+{
+    auto name = "report: " + report;
+    std::cerr << name << "..." << std::endl;
+
+    auto output = g_build_filename (m_work_dir->c_str(), "report.html", nullptr);
+    std::vector<std::string> args{*m_cli, "--report", "run", "--name", report,
+                                  "--output-file", output, datafile};
+    g_free (output);
+    std::vector<char*> argv;
+    for (auto& arg : args)
+        argv.push_back (const_cast<char*>(arg.c_str()));
+    argv.push_back (nullptr);
+
+    BenchResult result{name, 0.0, 0.0, -1, 1};
+    GError *error = nullptr;
+    auto wall_start = std::chrono::steady_clock::now ();
+#if defined HAVE_SYS_RESOURCE_H && defined HAVE_SYS_WAIT_H
+    GPid pid;
+    if (g_spawn_async (nullptr, argv.data(), nullptr, G_SPAWN_DO_NOT_REAP_CHILD,
+                       nullptr, nullptr, &pid, &error))
+    {
+        int status;
+        struct rusage usage;
+        if (wait4 (pid, &status, 0, &usage) == pid)
+        {
+            result.cpu_time = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+                usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+            result.peak_rss = rusage_peak_rss (usage);
+            result.status = WIFEXITED (status) ? WEXITSTATUS (status) : 1;
+        }
+        g_spawn_close_pid (pid);
+    }
+#else
+    int status;
+    if (g_spawn_sync (nullptr, argv.data(), nullptr, G_SPAWN_DEFAULT, nullptr,
+                      nullptr, nullptr, nullptr, &status, &error))
+        result.status = g_spawn_check_exit_status (status, nullptr) ? 0 : 1;
+#endif
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now () - wall_start;
+    result.wall_time = wall.count ();
+    if (error)
+    {
+        std::cerr << "Failed to run " << *m_cli << ": " << error->message << std::endl;
+        g_error_free (error);
+    }
+    m_results.push_back (result);
+}
+
+void
+Gnucash::GnucashBenchmark::write_results (std::ostream& out)
+{
+    out << "{\n  \"context\": {\n"
+        << "    \"seed\": " << m_seed << ",\n"
+        << "    \"accounts\": " << m_accounts << ",\n"
+        << "    \"transactions\": " << m_transactions << ",\n"
+        << "    \"prices\": " << m_prices << "\n"
+        << "  },\n  \"benchmarks\": [";
+    auto sep = "\n";
+    for (const auto& result : m_results)
+    {
+        out << sep << "    {\"name\": " << json_string (result.name)
+            << ", \"wall_time\": " << result.wall_time
+            << ", \"cpu_time\": " << result.cpu_time
+            << ", \"peak_rss_kb\": " << result.peak_rss
+            << ", \"status\": " << result.status << "}";
+        sep = ",\n";
+    }
+    out << "\n  ]\n}" << std::endl;
+}
+
+int
+Gnucash::GnucashBenchmark::start ([[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    Gnucash::CoreApp::start();
+    xaccLogDisable ();
+
+    if (!m_work_dir)
+    {
+        GError *error = nullptr;
+        auto dir = g_dir_make_tmp ("gnucash-benchmark-XXXXXX", &error);
+        if (!dir)
+        {
+            std::cerr << error->message << std::endl;
+            g_error_free (error);
+            return 1;
+        }
+        m_work_dir = dir;
+        g_free (dir);
+    }
+    auto xml_file = g_build_filename (m_work_dir->c_str(), "benchmark.gnucash", nullptr);
+    auto sql_file = g_build_filename (m_work_dir->c_str(), "benchmark.sqlite", nullptr);
+    std::string xml_path{xml_file}, xml_uri{std::string{"xml://"} + xml_file};
+    std::string sql_uri{std::string{"sqlite3://"} + sql_file};
+    g_free (xml_file);
+    g_free (sql_file);
+
+    auto session = qof_session_new (qof_book_new ());
+    auto book = qof_session_get_book (session);
+    run_phase ("generate", [&]{ generate_book (book); return 0; });
+    run_phase ("save xml", [&]{ return save_book (session, xml_uri); });
+    run_phase ("save sqlite", [&]{ return save_book (session, sql_uri); });
+    auto have_sql = m_results.back().status == 0;
+    qof_session_destroy (session);
+
+    if (have_sql)
+    {
+        run_phase ("load sqlite", [&]{ return load_book (sql_uri, &session); });
+        qof_session_destroy (session);
+    }
+
+    run_phase ("load xml", [&]{ return load_book (xml_uri, &session); });
+    run_phase ("scrub", [&]{
+        auto root = gnc_book_get_root_account (qof_session_get_book (session));
+        xaccAccountTreeScrubOrphans (root, nullptr);
+        xaccAccountTreeScrubImbalance (root, nullptr);
+        gncScrubBusinessAccountTree (root, nullptr);
+        return 0;
+    });
+    qof_session_destroy (session);
+
+    for (const auto& report : m_reports)
+        run_report (report, xml_path);
+
+    if (m_output_file)
+    {
+        std::ofstream out{*m_output_file};
+        write_results (out);
+    }
+    else
+        write_results (std::cout);
+
+    for (const auto& result : m_results)
+        if (result.status > 0)
+            return 1;
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *app_name = PROJECT_NAME "-benchmark";
+    Gnucash::GnucashBenchmark application (app_name);
+    application.parse_command_line (argc, argv);
+    auto rv = application.start (argc, argv);
+    gnc_engine_shutdown ();
+    return rv;
+}
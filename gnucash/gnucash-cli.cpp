@@ -66,6 +66,9 @@ namespace Gnucash {
         boost::optional <std::string> m_report_name;
         boost::optional <std::string> m_export_type;
         boost::optional <std::string> m_output_file;
+        boost::optional <std::string> m_manifest;
+        int m_jobs = 0;
+        int m_timeout = 600;
     };
 
 }
@@ -114,13 +117,23 @@ Gnucash::GnucashCli::configure_program_options (void)
      "  list: \tLists available reports.\n"
      "  show: \tDescribe the options modified in the named report. A datafile \
 may be specified to describe some saved options.\n"
-     "  run: \tRun the named report in the given GnuCash datafile.\n"))
+     "  run: \tRun the named report in the given GnuCash datafile.\n"
+     "  run-batch: \tRun all reports of a manifest in the given GnuCash datafile.\n"))
     ("name", bpo::value (&m_report_name),
      _("Name of the report to run\n"))
     ("export-type", bpo::value (&m_export_type),
      _("Specify export type\n"))
     ("output-file", bpo::value (&m_output_file),
-     _("Output file for report\n"));
+     _("Output file for report\n"))
+    ("manifest", bpo::value (&m_manifest),
+     _("File listing the reports to run with run-batch, one per line: \
+the report name or GUID, the output file, optionally the export type and then \
+any options to set as Section/Name=value with a Scheme value, separated by tabs\n"))
+    ("jobs", bpo::value (&m_jobs),
+     _("Number of reports run-batch runs at once, defaults to the number of processors\n"))
+    ("timeout", bpo::value (&m_timeout),
+     _("Seconds per report after which run-batch stops a process running reports, \
+0 for no limit, defaults to 600. Not applied on Windows\n"));
     m_opt_desc_display->add (report_options);
     m_opt_desc_all.add (report_options);
 
@@ -187,6 +200,24 @@ Gnucash::GnucashCli::start ([[maybe_unused]] int argc, [[maybe_unused]] char **a
                 return Gnucash::run_report(m_file_to_load, m_report_name,
                                            m_export_type, m_output_file);
         }
+        else if (*m_report_cmd == "run-batch")
+        {
+            if (!m_file_to_load || m_file_to_load->empty())
+            {
+                std::cerr << _("Missing data file parameter") << "\n\n"
+                          << *m_opt_desc_display.get() << std::endl;
+                return 1;
+            }
+            if (!m_manifest || m_manifest->empty())
+            {
+                std::cerr << _("Missing --manifest parameter") << "\n\n"
+                          << *m_opt_desc_display.get() << std::endl;
+                return 1;
+            }
+            return Gnucash::run_report_batch (m_file_to_load, *m_manifest,
+                                              m_jobs > 0 ? m_jobs : g_get_num_processors (),
+                                              m_timeout);
+        }
 
         // The command "list" does *not* test&pass the m_file_to_load
         // argument because the reports are global rather than
@@ -27,6 +27,10 @@
 #ifdef __MINGW32__
 #include <Windows.h>
 #include <fcntl.h>
+#else
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #endif
 
 #include "gnucash-commands.hpp"
@@ -40,6 +44,7 @@
 #include <qoflog.h>
 
 #include <boost/locale.hpp>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -110,18 +115,133 @@ struct run_report_args {
     const std::string& output_file;
 };
 
-static inline void
+static inline bool
 write_report_file (const char *html, const char* file)
 {
-    if (!file || !html || !*html) return;
+    if (!file || !html || !*html) return true;
     auto ofs{gnc_open_filestream(file)};
     if (!ofs)
     {
         std::cerr << "Failed to open file " << file << " for writing\n";
-        return;
+        return false;
     }
     ofs << html << std::endl;
     // ofs destructor will close the file
+    return true;
+}
+
+/* The options of a manifest entry as the list of (section name value)
+ * the gnc:cmdline- functions take. */
+static SCM
+scm_report_options (const std::vector<Gnucash::ReportOption>& options)
+{
+    auto settings = SCM_EOL;
+    for (auto option = options.rbegin(); option != options.rend(); ++option)
+        settings = scm_cons (scm_list_3 (scm_from_locale_string (option->section.c_str()),
+                                         scm_from_locale_string (option->name.c_str()),
+                                         scm_from_locale_string (option->value.c_str())),
+                             settings);
+    return settings;
+}
+
+/* Render a report of the loaded book into output_file, or to stdout if it's
+ * empty, after setting its options. Returns false after printing why if
+ * that fails. */
+static bool
+render_report (const std::string& report_name, const std::string& export_type,
+               const std::string& output_file,
+               const std::vector<Gnucash::ReportOption>& options = {})
+{
+    auto get_report_cmd = scm_c_eval_string ("gnc:cmdline-get-report-id");
+    auto run_export_cmd = scm_c_eval_string ("gnc:cmdline-template-export");
+    /* See scm_run_report for why this isn't scm_from_utf8_string(). */
+    auto report = scm_from_locale_string (report_name.c_str());
+    auto type = !export_type.empty() ?
+                scm_from_locale_string (export_type.c_str()) : SCM_BOOL_F;
+    auto settings = scm_report_options (options);
+
+    if (!export_type.empty())
+    {
+        SCM retval = scm_call_3 (run_export_cmd, report, type, settings);
+        SCM query_result = scm_c_eval_string ("gnc:html-document?");
+        SCM get_export_string = scm_c_eval_string ("gnc:html-document-export-string");
+        SCM get_export_error = scm_c_eval_string ("gnc:html-document-export-error");
+
+        /* The options couldn't be set, that's been reported already. */
+        if (scm_is_false (retval))
+            return false;
+
+        if (scm_is_false (scm_call_1 (query_result, retval)))
+        {
+            std::cerr << _("This report must be upgraded to \
+return a document object with export-string or export-error.") << std::endl;
+            return false;
+        }
+
+        SCM export_string = scm_call_1 (get_export_string, retval);
+        SCM export_error = scm_call_1 (get_export_error, retval);
+
+        if (scm_is_string (export_string))
+        {
+            auto output = scm_to_utf8_string (export_string);
+            auto written = true;
+            if (!output_file.empty())
+            {
+                written = write_report_file(output, output_file.c_str());
+            }
+            else
+            {
+                std::cout << output << std::endl;
+            }
+            g_free (output);
+            if (!written)
+                return false;
+        }
+        else if (scm_is_string (export_error))
+        {
+            auto err = scm_to_utf8_string (export_error);
+            std::cerr << err << std::endl;
+            g_free (err);
+            return false;
+        }
+        else
+        {
+            std::cerr << _("This report must be upgraded to \
+return a document object with export-string or export-error.") << std::endl;
+            return false;
+        }
+    }
+    else
+    {
+        SCM id = scm_call_2 (get_report_cmd, report, settings);
+
+        if (scm_is_false (id))
+            return false;
+        char *html, *errmsg;
+
+        if (gnc_run_report_with_error_handling (scm_to_int(id), &html, &errmsg))
+        {
+            auto written = true;
+            if (!output_file.empty())
+            {
+                written = write_report_file(html, output_file.c_str());
+            }
+            else
+            {
+                std::cout << html << std::endl;
+            }
+            g_free (html);
+            if (!written)
+                return false;
+        }
+        else
+        {
+            std::cerr << errmsg << std::endl;
+            g_free (errmsg);
+            return false;
+        }
+    }
+    return true;
 }
 
 static void
@@ -142,8 +262,6 @@ scm_run_report (void *data,
 
     auto datafile = args->file_to_load.c_str();
     auto check_report_cmd = scm_c_eval_string ("gnc:cmdline-check-report");
-    auto get_report_cmd = scm_c_eval_string ("gnc:cmdline-get-report-id");
-    auto run_export_cmd = scm_c_eval_string ("gnc:cmdline-template-export");
     /* We generally insist on using scm_from_utf8_string() throughout GnuCash
      * because all GUI-sourced strings and all file-sourced strings are encoded
      * that way. In this case, though, the input is coming from a shell window
@@ -172,81 +290,204 @@ scm_run_report (void *data,
     if (qof_session_get_error (session) != ERR_BACKEND_NO_ERR)
         scm_cleanup_and_exit_with_failure (session);
 
-    if (!args->export_type.empty())
-    {
-        SCM retval = scm_call_2 (run_export_cmd, report, type);
-        SCM query_result = scm_c_eval_string ("gnc:html-document?");
-        SCM get_export_string = scm_c_eval_string ("gnc:html-document-export-string");
-        SCM get_export_error = scm_c_eval_string ("gnc:html-document-export-error");
+    if (!render_report (args->run_report, args->export_type, args->output_file))
+        scm_cleanup_and_exit_with_failure (nullptr);
 
-        if (scm_is_false (scm_call_1 (query_result, retval)))
+    qof_session_destroy (session);
+
+    qof_event_resume ();
+    gnc_shutdown_cli (0);
+    return;
+}
+
+struct run_batch_args {
+    const std::string& file_to_load;
+    const std::vector<Gnucash::BatchReport>& reports;
+    int jobs;
+    int timeout;
+};
+
+/* Render every jobs-th report starting with the first one, return the
+ * number that failed. */
+static int
+render_batch_reports (const std::vector<Gnucash::BatchReport>& reports,
+                      size_t first, size_t jobs)
+{
+    int failures = 0;
+    for (auto i = first; i < reports.size(); i += jobs)
+    {
+        auto& entry{reports[i]};
+        PINFO ("Running report %s into %s", entry.report.c_str(),
+               entry.output_file.c_str());
+        if (!render_report (entry.report, entry.export_type, entry.output_file,
+                            entry.options))
         {
-            std::cerr << _("This report must be upgraded to \
-return a document object with export-string or export-error.") << std::endl;
-            scm_cleanup_and_exit_with_failure (nullptr);
+            std::cerr << bl::format (std::string{_("Report '{1}' failed.")}) % entry.report
+                      << std::endl;
+            ++failures;
         }
+    }
+    return failures;
+}
 
-        SCM export_string = scm_call_1 (get_export_string, retval);
-        SCM export_error = scm_call_1 (get_export_error, retval);
+#ifndef __MINGW32__
+static SCM
+fork_worker ([[maybe_unused]] void *data)
+{
+    return scm_fork ();
+}
 
-        if (scm_is_string (export_string))
+/* primitive-fork throws a system-error whose last argument is the list
+ * holding errno, keep that in data. */
+static SCM
+fork_failed (void *data, SCM key, SCM args)
+{
+    auto error = static_cast<int*>(data);
+    if (scm_is_eq (key, scm_from_utf8_symbol ("system-error")) &&
+        scm_ilength (args) == 4 && scm_is_pair (scm_cadddr (args)) &&
+        scm_is_integer (scm_car (scm_cadddr (args))))
+        *error = scm_to_int (scm_car (scm_cadddr (args)));
+    return scm_from_int (-1);
+}
+
+struct batch_worker {
+    pid_t pid;
+    size_t first;
+    gint64 deadline;
+};
+
+/* Wait for the workers to finish, stopping those that take longer than
+ * timeout seconds for each of their reports. Return the number that
+ * failed. */
+static int
+wait_for_batch_workers (std::vector<batch_worker>& workers,
+                        const std::vector<Gnucash::BatchReport>& reports,
+                        size_t jobs, int timeout)
+{
+    int failures = 0;
+    while (!workers.empty())
+    {
+        for (auto worker = workers.begin(); worker != workers.end();)
         {
-            auto output = scm_to_utf8_string (export_string);
-            if (!args->output_file.empty())
-            {
-                write_report_file(output, args->output_file.c_str());
-            }
-            else
+            int status;
+            auto pid = waitpid (worker->pid, &status, WNOHANG);
+            if (pid == 0)
             {
-                std::cout << output << std::endl;
+                if (timeout <= 0 || g_get_monotonic_time () < worker->deadline)
+                {
+                    ++worker;
+                    continue;
+                }
+                for (auto i = worker->first; i < reports.size(); i += jobs)
+                    std::cerr << bl::format (std::string{_("Report '{1}' may not have finished, its worker was stopped after {2} seconds per report.")})
+                        % reports[i].report % timeout << std::endl;
+                kill (worker->pid, SIGKILL);
+                waitpid (worker->pid, &status, 0);
+                ++failures;
             }
-            g_free (output);
-        }
-        else if (scm_is_string (export_error))
-        {
-            auto err = scm_to_utf8_string (export_error);
-            std::cerr << err << std::endl;
-            g_free (err);
-            scm_cleanup_and_exit_with_failure (nullptr);
-        }
-        else
-        {
-            std::cerr << _("This report must be upgraded to \
-return a document object with export-string or export-error.") << std::endl;
-            scm_cleanup_and_exit_with_failure (nullptr);
+            else if (pid < 0 || !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+                ++failures;
+            worker = workers.erase (worker);
         }
+        if (!workers.empty())
+            g_usleep (G_USEC_PER_SEC / 10);
     }
-    else
-    {
-        SCM id = scm_call_1(get_report_cmd, report);
+    return failures;
+}
+#endif
 
-        if (scm_is_false (id))
+static void
+scm_run_report_batch (void *data,
+                      [[maybe_unused]] int argc, [[maybe_unused]] char **argv)
+{
+    auto args = static_cast<run_batch_args*>(data);
+
+    scm_c_eval_string("(debug-set! stack 200000)");
+    scm_c_use_module ("gnucash utilities");
+    scm_c_use_module ("gnucash app-utils");
+    scm_c_use_module ("gnucash reports");
+
+    gnc_report_init ();
+    Gnucash::gnc_load_scm_config ([](const gchar *msg){ PINFO ("%s", msg); });
+    gnc_prefs_init ();
+    qof_event_suspend ();
+
+    /* Check all of them before spending time on loading the book. */
+    auto check_report_cmd = scm_c_eval_string ("gnc:cmdline-check-report");
+    for (const auto& entry : args->reports)
+    {
+        auto report = scm_from_locale_string (entry.report.c_str());
+        auto type = !entry.export_type.empty() ?
+                    scm_from_locale_string (entry.export_type.c_str()) : SCM_BOOL_F;
+        if (scm_is_false (scm_call_3 (check_report_cmd, report, type,
+                                      scm_report_options (entry.options))))
             scm_cleanup_and_exit_with_failure (nullptr);
-        char *html, *errmsg;
+    }
 
-        if (gnc_run_report_with_error_handling (scm_to_int(id), &html, &errmsg))
+    auto datafile = args->file_to_load.c_str();
+    PINFO ("Loading datafile %s...\n", datafile);
+
+    auto session = gnc_get_current_session ();
+    if (!session)
+        scm_cleanup_and_exit_with_failure (session);
+
+    qof_session_begin (session, datafile, SESSION_READ_ONLY);
+    if (qof_session_get_error (session) != ERR_BACKEND_NO_ERR)
+        scm_cleanup_and_exit_with_failure (session);
+
+    qof_session_load (session, report_session_percentage);
+    if (qof_session_get_error (session) != ERR_BACKEND_NO_ERR)
+        scm_cleanup_and_exit_with_failure (session);
+
+    size_t jobs = std::clamp<size_t> (args->jobs, 1, args->reports.size());
+    int failures = 0;
+#ifndef __MINGW32__
+    /* Guile can't run reports on several threads at once, so each worker
+     * is a fork sharing the loaded book copy-on-write. Workers only write
+     * their output files and leave the session alone. They're forked with
+     * primitive-fork, which stops guile's finalizer and signal delivery
+     * threads first: only the forking thread survives in the child, and
+     * one of them might hold a lock the worker needs. A single job is
+     * forked too when it has a timeout, so that it can be stopped. */
+    if (jobs > 1 || args->timeout > 0)
+    {
+        std::cout.flush ();
+        std::cerr.flush ();
+        fflush (nullptr);
+
+        std::vector<batch_worker> workers;
+        for (size_t first = 0; first < jobs; ++first)
         {
-            if (!args->output_file.empty())
+            int error = 0;
+            auto pid = scm_to_int (scm_internal_catch (SCM_BOOL_T, fork_worker, nullptr,
+                                                       fork_failed, &error));
+            if (pid == 0)
+                _exit (render_batch_reports (args->reports, first, jobs) ? 1 : 0);
+            if (pid < 0)
             {
-                write_report_file(html, args->output_file.c_str());
+                PERR ("Failed to start a worker: %s", g_strerror (error));
+                failures += render_batch_reports (args->reports, first, jobs);
             }
             else
             {
-                std::cout << html << std::endl;
+                auto num_reports = (args->reports.size() - first + jobs - 1) / jobs;
+                auto deadline = g_get_monotonic_time () +
+                    static_cast<gint64>(num_reports) * args->timeout * G_USEC_PER_SEC;
+                workers.push_back ({pid, first, deadline});
             }
-            g_free (html);
-        }
-        else
-        {
-            std::cerr << errmsg << std::endl;
-            g_free (errmsg);
         }
+
+        failures += wait_for_batch_workers (workers, args->reports, jobs,
+                                            args->timeout);
     }
+    else
+#endif
+        failures = render_batch_reports (args->reports, 0, 1);
 
     qof_session_destroy (session);
 
     qof_event_resume ();
-    gnc_shutdown_cli (0);
+    gnc_shutdown_cli (failures ? 1 : 0);
     return;
 }
 
@@ -416,6 +657,32 @@ Gnucash::run_report (const bo_str& file_to_load,
     return 0;
 }
 
+int
+Gnucash::run_report_batch (const bo_str& file_to_load,
+                           const std::string& manifest, int jobs, int timeout)
+{
+    std::ifstream in{manifest};
+    if (!in)
+    {
+        std::cerr << bl::format (std::string{_("Failed to open manifest {1}")}) % manifest
+                  << std::endl;
+        return 1;
+    }
+
+    std::vector<BatchReport> reports;
+    if (!parse_report_manifest (in, manifest, reports))
+        return 1;
+
+    if (reports.empty())
+        return 0;
+
+    auto args = run_batch_args { file_to_load ? *file_to_load : empty_string,
+                                 reports, jobs, timeout };
+    scm_boot_guile (0, nullptr, scm_run_report_batch, &args);
+
+    return 0;
+}
+
 int
 Gnucash::report_show (const bo_str& file_to_load,
                       const bo_str& show_report)
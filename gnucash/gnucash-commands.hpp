@@ -25,6 +25,7 @@
 #ifndef GNUCASH_COMMANDS_HPP
 #define GNUCASH_COMMANDS_HPP
 
+#include <iosfwd>
 #include <string>
 #include <vector>
 #include <boost/optional.hpp>
@@ -34,6 +35,32 @@ using StrVec = std::vector<std::string>;
 
 namespace Gnucash {
 
+    /** A report option a batch manifest sets. */
+    struct ReportOption
+    {
+        std::string section;
+        std::string name;
+        std::string value;          /**< Scheme datum, e.g. "Title" or 12 */
+    };
+
+    /** One entry of a report batch manifest. */
+    struct BatchReport
+    {
+        std::string report;         /**< Report name or GUID */
+        std::string output_file;
+        std::string export_type;    /**< Empty to write html */
+        std::vector<ReportOption> options;
+    };
+
+    /** Read the entries of a report batch manifest into reports. Each line
+     *  holds a report name or GUID, the output file, optionally an export
+     *  type and then any number of options to set, written
+     *  Section/Name=value, all separated by tabs. Empty lines and lines
+     *  starting with # are skipped. Returns false after printing which line
+     *  of the manifest called name isn't valid. */
+    bool parse_report_manifest (std::istream& in, const std::string& name,
+                                std::vector<BatchReport>& reports);
+
     int check_finance_quote (void);
     int add_quotes (const bo_str& uri);
     int report_quotes (const char* source,
@@ -43,6 +70,15 @@ namespace Gnucash {
                     const bo_str& run_report,
                     const bo_str& export_type,
                     const bo_str& output_file);
+    /** Load a datafile once and run all the reports listed in a manifest,
+     *  see parse_report_manifest, on up to jobs processes at once. A
+     *  process running reports is stopped when it takes more than timeout
+     *  seconds per report, unless timeout is 0. The timeout isn't applied
+     *  on Windows, where the reports all run in one process. Exits with
+     *  status 1 if any report failed. */
+    int run_report_batch (const bo_str& file_to_load,
+                          const std::string& manifest,
+                          int jobs, int timeout);
     int report_list (void);
     int report_show (const bo_str& file_to_load,
                      const bo_str& run_report);
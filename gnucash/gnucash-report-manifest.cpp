@@ -0,0 +1,92 @@
+/*
+ * gnucash-report-manifest.cpp -- Reading the manifest of gnucash-cli run-batch
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, contact:
+ *
+ * Free Software Foundation           Voice:  +1-617-542-5942
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org
+ */
+#include <config.h>
+
+#include "gnucash-commands.hpp"
+
+#include <glib/gi18n.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/locale.hpp>
+#include <iostream>
+
+namespace bl = boost::locale;
+
+/* Split a Section/Name=value field, the section ends at the first / and
+ * the name at the first = after it. */
+static bool
+parse_report_option (const std::string& field, Gnucash::ReportOption& option)
+{
+    auto slash = field.find ('/');
+    if (slash == std::string::npos)
+        return false;
+    auto equal = field.find ('=', slash + 1);
+    if (equal == std::string::npos)
+        return false;
+
+    option.section = boost::trim_copy (field.substr (0, slash));
+    option.name = boost::trim_copy (field.substr (slash + 1, equal - slash - 1));
+    option.value = boost::trim_copy (field.substr (equal + 1));
+    return !option.section.empty() && !option.name.empty() &&
+        !option.value.empty();
+}
+
+bool
+Gnucash::parse_report_manifest (std::istream& in, const std::string& name,
+                                std::vector<BatchReport>& reports)
+{
+    std::string line;
+    for (auto line_no = 1; std::getline (in, line); ++line_no)
+    {
+        boost::trim (line);
+        if (line.empty() || line.front() == '#')
+            continue;
+
+        StrVec fields;
+        boost::split (fields, line, boost::is_any_of ("\t"));
+        for (auto& field : fields)
+            boost::trim (field);
+
+        auto valid = fields.size() >= 2 && !fields[0].empty() && !fields[1].empty();
+        BatchReport entry;
+        if (valid)
+        {
+            entry.report = fields[0];
+            entry.output_file = fields[1];
+            if (fields.size() > 2)
+                entry.export_type = fields[2];
+            for (size_t i = 3; valid && i < fields.size(); ++i)
+            {
+                ReportOption option;
+                valid = parse_report_option (fields[i], option);
+                entry.options.push_back (std::move (option));
+            }
+        }
+        if (!valid)
+        {
+            std::cerr << bl::format (std::string{_("Invalid line {1} in manifest {2}")})
+                % line_no % name << std::endl;
+            return false;
+        }
+        reports.push_back (std::move (entry));
+    }
+    return true;
+}
@@ -0,0 +1,94 @@
+/********************************************************************\
+ * gnc-imp-parallel.hpp - run import work on several threads        *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+/** @file
+     @brief Run import work on several threads
+     *
+     gnc-imp-parallel.hpp
+ */
+
+#ifndef GNC_IMP_PARALLEL_HPP
+#define GNC_IMP_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+/** Call func (begin, end) for contiguous chunks covering [0, count).
+ *  Counts large enough to be worth it are split over one thread per
+ *  processor, the first chunk running on the calling thread.
+ *
+ *  Each call must only touch its own part of the data and may not use
+ *  the engine, which isn't thread safe. As the chunks are fixed by count
+ *  the results don't depend on the number of threads or their timing.
+ *
+ *  @param count Number of items to process
+ *  @param func Callable taking the begin and end index of a chunk
+ *  @param min_chunk Don't use threads for less items per thread than this
+ *  @exception Rethrows the exception of the first chunk that failed,
+ *             after all chunks have finished.
+ */
+template <typename Func> void
+gnc_imp_parallel_for (size_t count, Func func, size_t min_chunk = 1024)
+{
+    size_t num_threads = std::max (std::thread::hardware_concurrency (), 1u);
+    auto num_chunks = std::min (num_threads, count / std::max (min_chunk, size_t{1}));
+    if (num_chunks < 2)
+    {
+        func (size_t{0}, count);
+        return;
+    }
+
+    auto chunk_size = (count + num_chunks - 1) / num_chunks;
+    std::vector<std::future<void>> chunks;
+    for (auto begin = chunk_size; begin < count; begin += chunk_size)
+        chunks.push_back (std::async (std::launch::async, func, begin,
+                                      std::min (begin + chunk_size, count)));
+
+    std::exception_ptr error;
+    try
+    {
+        func (size_t{0}, chunk_size);
+    }
+    catch (...)
+    {
+        error = std::current_exception ();
+    }
+    for (auto& chunk : chunks)
+    {
+        try
+        {
+            chunk.get ();
+        }
+        catch (...)
+        {
+            if (!error)
+                error = std::current_exception ();
+        }
+    }
+    if (error)
+        std::rethrow_exception (error);
+}
+
+#endif
@@ -46,10 +46,12 @@
 #include <boost/regex/icu.hpp>
 
 #include "gnc-import-tx.hpp"
+#include "gnc-imp-parallel.hpp"
 #include "gnc-imp-props-tx.hpp"
 #include "gnc-tokenizer-csv.hpp"
 #include "gnc-tokenizer-fw.hpp"
 #include "gnc-imp-settings-csv-tx.hpp"
+#include <gnc-locale-utils.h>
 
 G_GNUC_UNUSED static QofLogModule log_module = GNC_MOD_IMPORT;
 
@@ -749,16 +751,37 @@ GncTxImport::check_for_column_type (GncTransPropType type)
                         != m_settings.m_column_types.end());
 }
 
-/* A helper function intended to be called only from set_column_type */
-void GncTxImport::update_pre_trans_split_props (uint32_t row, uint32_t col, GncTransPropType old_type, GncTransPropType new_type)
+/* Parsing these properties involves looking up accounts or commodities
+ * in the book. Account properties also update the commodity counters in
+ * the GncPreTrans a line is finally linked to. */
+static bool
+prop_uses_engine (GncTransPropType prop)
+{
+    return (prop == GncTransPropType::ACCOUNT) ||
+           (prop == GncTransPropType::TACCOUNT) ||
+           (prop == GncTransPropType::COMMODITY);
+}
+
+/* A helper function intended to be called only from set_column_type
+ * Returns a new GncPreTrans for the line with the transaction related
+ * property changes applied. It doesn't change any shared state. */
+std::shared_ptr<GncPreTrans>
+GncTxImport::update_pre_trans_props (uint32_t row, uint32_t col, GncTransPropType old_type, GncTransPropType new_type)
 {
     /* Deliberately make a copy of the GncPreTrans. It may be the original one was shared
      * with a previous line and should no longer be after the transprop is changed.
-     * This doesn't apply for the GncPreSplit so we just get a pointer to it for easier processing.
      */
     auto split_props = std::get<PL_PRESPLIT>(m_parsed_lines[row]);
     auto trans_props = std::make_shared<GncPreTrans> (*(split_props->get_pre_trans()).get());
 
+    /* Reset date and currency formats for each trans/split props object
+     * to ensure column updates use the most recent one
+     */
+    trans_props->set_date_format (m_settings.m_date_format);
+    trans_props->set_multi_split (m_settings.m_multi_split);
+    split_props->set_date_format (m_settings.m_date_format);
+    split_props->set_currency_format (m_settings.m_currency_format);
+
     /* Deal with trans properties first as this may change the trans->split relationships
         * in case of multi-split imports */
     if ((old_type > GncTransPropType::NONE) && (old_type <= GncTransPropType::TRANS_PROPS))
@@ -780,6 +803,12 @@ void GncTxImport::update_pre_trans_split_props (uint32_t row, uint32_t col, GncT
     if ((old_type == GncTransPropType::ACCOUNT) || (new_type == GncTransPropType::ACCOUNT))
         trans_props->reset_cross_split_counters();
 
+    return trans_props;
+}
+
+/* A helper function intended to be called only from set_column_type */
+void GncTxImport::link_pre_trans (uint32_t row, std::shared_ptr<GncPreTrans> trans_props)
+{
     /* All transaction related value updates are finished now,
      * time to determine what to do with the updated GncPreTrans copy.
      *
@@ -790,6 +819,7 @@ void GncTxImport::update_pre_trans_split_props (uint32_t row, uint32_t col, GncT
      * In all other cases our new GncPreTrans should be used for this line
      * and be marked as the new potential m_parent for subsequent lines.
      */
+    auto split_props = std::get<PL_PRESPLIT>(m_parsed_lines[row]);
     if (m_settings.m_multi_split && trans_props->is_part_of( m_parent))
         split_props->set_pre_trans (m_parent);
     else
@@ -797,6 +827,12 @@ void GncTxImport::update_pre_trans_split_props (uint32_t row, uint32_t col, GncT
         split_props->set_pre_trans (trans_props);
         m_parent = trans_props;
     }
+}
+
+/* A helper function intended to be called only from set_column_type */
+void GncTxImport::update_pre_split_props (uint32_t row, uint32_t col, GncTransPropType old_type, GncTransPropType new_type)
+{
+    auto split_props = std::get<PL_PRESPLIT>(m_parsed_lines[row]);
 
     /* Finally handle any split related property changes */
     if ((old_type > GncTransPropType::TRANS_PROPS) && (old_type <= GncTransPropType::SPLIT_PROPS))
@@ -852,7 +888,18 @@ void GncTxImport::update_pre_trans_split_props (uint32_t row, uint32_t col, GncT
             split_props->set(new_type, value);
         }
     }
+}
+
+/* A helper function intended to be called only from set_column_type */
+void GncTxImport::update_line_status (uint32_t row)
+{
+    auto split_props = std::get<PL_PRESPLIT>(m_parsed_lines[row]);
     m_multi_currency |= split_props->get_pre_trans()->is_multi_currency();
+
+    /* Report errors if there are any */
+    auto all_errors = split_props->get_pre_trans()->errors();
+    all_errors.merge (split_props->errors());
+    std::get<PL_ERROR>(m_parsed_lines[row]) = std::move(all_errors);
 }
 
 
@@ -881,28 +928,37 @@ GncTxImport::set_column_type (uint32_t position, GncTransPropType type, bool for
     /* Update the preparsed data */
     m_parent = nullptr;
     m_multi_currency = false;
-    for (auto parsed_lines_it = m_parsed_lines.begin();
-            parsed_lines_it != m_parsed_lines.end();
-            ++parsed_lines_it)
+    auto num_lines = static_cast<uint32_t>(m_parsed_lines.size());
+    if (prop_uses_engine (old_type) || prop_uses_engine (type))
     {
-        /* Reset date and currency formats for each trans/split props object
-         * to ensure column updates use the most recent one
-         */
-        auto split_props = std::get<PL_PRESPLIT>(*parsed_lines_it);
-        split_props->get_pre_trans()->set_date_format (m_settings.m_date_format);
-        split_props->get_pre_trans()->set_multi_split (m_settings.m_multi_split);
-        split_props->set_date_format (m_settings.m_date_format);
-        split_props->set_currency_format (m_settings.m_currency_format);
-
-        uint32_t row = parsed_lines_it - m_parsed_lines.begin();
-
-        /* Update the property represented by the new column type */
-        update_pre_trans_split_props (row, position, old_type, type);
+        for (uint32_t row = 0; row < num_lines; row++)
+        {
+            auto trans_props = update_pre_trans_props (row, position, old_type, type);
+            link_pre_trans (row, trans_props);
+            update_pre_split_props (row, position, old_type, type);
+            update_line_status (row);
+        }
+        return;
+    }
 
-        /* Report errors if there are any */
-        auto all_errors = split_props->get_pre_trans()->errors();
-        all_errors.merge (split_props->errors());
-        std::get<PL_ERROR>(*parsed_lines_it) = std::move(all_errors);
+    /* Parsing dates and amounts is what takes time on large files. It only
+     * depends on the line itself so it's done on several threads. Linking
+     * the lines of multi-split transactions depends on the previous line
+     * so that's done in order afterwards. */
+    gnc_localeconv(); // Initializes the cached locale before the threads use it
+    std::vector<std::shared_ptr<GncPreTrans>> new_trans_props (num_lines);
+    gnc_imp_parallel_for (num_lines, [&](size_t begin, size_t end)
+        {
+            for (auto row = begin; row < end; row++)
+            {
+                new_trans_props[row] = update_pre_trans_props (row, position, old_type, type);
+                update_pre_split_props (row, position, old_type, type);
+            }
+        });
+    for (uint32_t row = 0; row < num_lines; row++)
+    {
+        link_pre_trans (row, std::move (new_trans_props[row]));
+        update_line_status (row);
     }
 }
 
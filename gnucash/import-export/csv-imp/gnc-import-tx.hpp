@@ -178,10 +178,15 @@ private:
      */
     std::shared_ptr<DraftTransaction> trans_properties_to_trans (std::vector<parse_line_t>::iterator& parsed_line);
 
-    /* Internal helper function that should only be called from within
+    /* Internal helper functions that should only be called from within
      * set_column_type for consistency (otherwise error messages may not be (re)set)
+     * update_pre_trans_props and update_pre_split_props only touch the given
+     * row so they can run on several rows at once.
      */
-    void update_pre_trans_split_props (uint32_t row, uint32_t col, GncTransPropType old_type, GncTransPropType new_type);
+    std::shared_ptr<GncPreTrans> update_pre_trans_props (uint32_t row, uint32_t col, GncTransPropType old_type, GncTransPropType new_type);
+    void link_pre_trans (uint32_t row, std::shared_ptr<GncPreTrans> trans_props);
+    void update_pre_split_props (uint32_t row, uint32_t col, GncTransPropType old_type, GncTransPropType new_type);
+    void update_line_status (uint32_t row);
 
     CsvTransImpSettings m_settings;
     bool m_skip_errors;
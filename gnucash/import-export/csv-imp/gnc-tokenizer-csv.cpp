@@ -5,14 +5,21 @@
 #include <vector>
 #include <string>
 #include <algorithm>    // copy
+#include <array>
 #include <iterator>     // ostream_operator
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-#include <boost/tokenizer.hpp>
 #include <boost/locale.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include <glib/gi18n.h>
 
+#include "gnc-imp-parallel.hpp"
+
 void
 GncCsvTokenizer::set_separators(const std::string& separators)
 {
@@ -20,13 +27,156 @@ GncCsvTokenizer::set_separators(const std::string& separators)
 }
 
 
-int GncCsvTokenizer::tokenize()
+/* The characters that interrupt plain field content: the separators, the
+ * quote and the escape character. Finding the next one is where splitting
+ * a line spends its time, so with SSE2 16 bytes are checked at once. */
+class CsvSpecialChars
+{
+public:
+    CsvSpecialChars (const std::string& separators)
+    {
+        for (unsigned char c : separators)
+            m_sep[c] = m_special[c] = true;
+        m_special['"'] = m_special['\\'] = true;
+#if defined(__SSE2__)
+        for (int c = 0; c < 256; ++c)
+            if (m_special[c] && m_num_vectors < max_vectors)
+                m_vectors[m_num_vectors++] = _mm_set1_epi8 (static_cast<char>(c));
+            else if (m_special[c])
+                m_use_vectors = false;
+#endif
+    }
+
+    bool is_sep (char c) const { return m_sep[static_cast<unsigned char>(c)]; }
+
+    /* Return the first special character in [begin, end) or end. */
+    const char* find (const char* begin, const char* end) const
+    {
+#if defined(__SSE2__)
+        /* Comparing against each of a long list of separators
+         * is slower than looking up every byte. */
+        if (m_use_vectors)
+        {
+            for (; end - begin >= 16; begin += 16)
+            {
+                auto chunk = _mm_loadu_si128 (reinterpret_cast<const __m128i*>(begin));
+                auto found = _mm_setzero_si128 ();
+                for (size_t i = 0; i < m_num_vectors; ++i)
+                    found = _mm_or_si128 (found, _mm_cmpeq_epi8 (chunk, m_vectors[i]));
+                if (auto mask = _mm_movemask_epi8 (found))
+                    return begin + __builtin_ctz (mask);
+            }
+        }
+#endif
+        while (begin != end && !m_special[static_cast<unsigned char>(*begin)])
+            ++begin;
+        return begin;
+    }
+
+private:
+    std::array<bool, 256> m_sep{};
+    std::array<bool, 256> m_special{};
+#if defined(__SSE2__)
+    static constexpr size_t max_vectors = 8;
+    __m128i m_vectors[max_vectors];
+    size_t m_num_vectors = 0;
+    bool m_use_vectors = true;
+#endif
+};
+
+/* Split a line into fields the way boost::escaped_list_separator did
+ * with \ as escape and " as quote character: separators inside quotes
+ * are kept, quotes are dropped and \n, \", \\ and \<separator> are
+ * unescaped. An empty line has no fields at all. */
+static StrVec
+split_fields (const std::string& line, const CsvSpecialChars& specials)
 {
-    using Tokenizer = boost::tokenizer< boost::escaped_list_separator<char>>;
+    StrVec fields;
+    if (line.empty())
+        return fields;
+
+    bool inside_quotes = false;
+    fields.emplace_back();
+    auto pos = line.data();
+    auto end = pos + line.size();
+    while (pos != end)
+    {
+        auto special = specials.find (pos, end);
+        fields.back().append (pos, special);
+        if (special == end)
+            break;
+        pos = special + 1;
 
-    boost::escaped_list_separator<char> sep("\\", m_sep_str, "\"");
+        if (*special == '\\')
+        {
+            if (pos == end)
+                throw std::range_error ("cannot end with escape");
+            if (*pos == 'n')
+                fields.back().push_back ('\n');
+            else if (*pos == '"' || *pos == '\\' || specials.is_sep (*pos))
+                fields.back().push_back (*pos);
+            else
+                throw std::range_error ("unknown escape sequence");
+            ++pos;
+        }
+        else if (specials.is_sep (*special))
+        {
+            if (inside_quotes)
+                fields.back().push_back (*special);
+            else
+                fields.emplace_back();
+        }
+        else
+            inside_quotes = !inside_quotes;
+    }
+    return fields;
+}
 
-    StrVec vec;
+/* Split one logical line into fields. */
+static StrVec
+tokenize_line (std::string line, const std::string& sep_str,
+               const CsvSpecialChars& specials)
+{
+    // Deal with backslashes that are not meant to be escapes
+    // split_fields would choke on this.
+    auto bs_pos = line.find ('\\');
+    while (bs_pos != std::string::npos)
+    {
+        if ((bs_pos == line.size()) ||                                 // got trailing single backslash
+            (line.find_first_of ("\"\\n", bs_pos + 1) != bs_pos + 1))  // backslash is not part of known escapes \\, \" or \n
+            line = line.substr(0, bs_pos) + "\\\\" + line.substr(bs_pos + 1);
+        bs_pos += 2;
+        bs_pos = line.find ('\\', bs_pos);
+    }
+
+    // Deal with repeated " ("") in strings.
+    // This is commonly used as escape mechanism for double quotes in csv files.
+    // However split_fields just eats them.
+    bs_pos = line.find ("\"\"");
+    while (bs_pos != std::string::npos)
+    {
+        // Only make changes in case the double quotes are part of a larger field
+        // In other words a field which only contains two double quotes represent an
+        // empty field. We don't need to touch those.
+        // The way to determine whether the double quotes represent an empty string
+        // is by checking whether the character in front or after are either
+        // a field separator or the beginning or end of of the string.
+        if (!(((bs_pos == 0) ||                                          // quotes are at start of line
+               (sep_str.find (line[bs_pos-1]) != std::string::npos))    // quotes preceded by field separator
+              &&
+              ((bs_pos + 2 >= line.length()) ||                          // quotes are at end of line
+               (sep_str.find (line[bs_pos+2]) != std::string::npos))))   // quotes followed by field separator
+            // Only make changes in case the double quotes are not an empty field
+            line.replace (bs_pos, 2, "\\\"");
+        bs_pos = line.find ("\"\"", bs_pos + 2);
+    }
+
+    return split_fields (line, specials);
+}
+
+int GncCsvTokenizer::tokenize()
+{
+    StrVec lines;
     std::string line;
     std::string buffer;
 
@@ -36,74 +186,49 @@ int GncCsvTokenizer::tokenize()
     m_tokenized_contents.clear();
     std::istringstream in_stream(m_utf8_contents);
 
-    try
+    /* Finding where a line ends requires tracking quotes from the start of
+     * the file, so that's done first. The lines are then independent and
+     * get split into fields on several threads. */
+    while (std::getline (in_stream, buffer))
     {
-        while (std::getline (in_stream, buffer))
+        // --- deal with line breaks in quoted strings
+        buffer = boost::trim_copy (buffer); // Removes trailing newline and spaces
+        last_quote = buffer.find_first_of('"');
+        while (last_quote != std::string::npos)
         {
-            // --- deal with line breaks in quoted strings
-            buffer = boost::trim_copy (buffer); // Removes trailing newline and spaces
-            last_quote = buffer.find_first_of('"');
-            while (last_quote != std::string::npos)
-            {
-                if (last_quote == 0) // Test separately because last_quote - 1 would be out of range
-                    inside_quotes = !inside_quotes;
-                else if (buffer[ last_quote - 1 ] != '\\')
-                    inside_quotes = !inside_quotes;
+            if (last_quote == 0) // Test separately because last_quote - 1 would be out of range
+                inside_quotes = !inside_quotes;
+            else if (buffer[ last_quote - 1 ] != '\\')
+                inside_quotes = !inside_quotes;
 
-                last_quote = buffer.find_first_of('"',last_quote+1);
-            }
+            last_quote = buffer.find_first_of('"',last_quote+1);
+        }
 
-            line.append(buffer);
-            if (inside_quotes)
-            {
-                line.append(" ");
-                continue;
-            }
-            // ---
+        line.append(buffer);
+        if (inside_quotes)
+        {
+            line.append(" ");
+            continue;
+        }
+        // ---
 
-            // Deal with backslashes that are not meant to be escapes
-            // The boost::tokenizer with escaped_list_separator as we use
-            // it would choke on this.
-            auto bs_pos = line.find ('\\');
-            while (bs_pos != std::string::npos)
-            {
-                if ((bs_pos == line.size()) ||                                 // got trailing single backslash
-                    (line.find_first_of ("\"\\n", bs_pos + 1) != bs_pos + 1))  // backslash is not part of known escapes \\, \" or \n
-                    line = line.substr(0, bs_pos) + "\\\\" + line.substr(bs_pos + 1);
-                bs_pos += 2;
-                bs_pos = line.find ('\\', bs_pos);
-            }
+        lines.push_back (std::move (line));
+        line.clear();
+    }
 
-            // Deal with repeated " ("") in strings.
-            // This is commonly used as escape mechanism for double quotes in csv files.
-            // However boost just eats them.
-            bs_pos = line.find ("\"\"");
-            while (bs_pos != std::string::npos)
+    CsvSpecialChars specials{m_sep_str};
+    m_tokenized_contents.resize (lines.size());
+    try
+    {
+        gnc_imp_parallel_for (lines.size(), [this, &lines, &specials](size_t begin, size_t end)
             {
-                // Only make changes in case the double quotes are part of a larger field
-                // In other words a field which only contains two double quotes represent an
-                // empty field. We don't need to touch those.
-                // The way to determine whether the double quotes represent an empty string
-                // is by checking whether the character in front or after are either
-                // a field separator or the beginning or end of of the string.
-                if (!(((bs_pos == 0) ||                                          // quotes are at start of line
-                       (m_sep_str.find (line[bs_pos-1]) != std::string::npos))    // quotes preceded by field separator
-                      &&
-                      ((bs_pos + 2 >= line.length()) ||                          // quotes are at end of line
-                       (m_sep_str.find (line[bs_pos+2]) != std::string::npos))))   // quotes followed by field separator
-                    // Only make changes in case the double quotes are not an empty field
-                    line.replace (bs_pos, 2, "\\\"");
-                bs_pos = line.find ("\"\"", bs_pos + 2);
-            }
-
-            Tokenizer tok(line, sep);
-            vec.assign(tok.begin(),tok.end());
-            m_tokenized_contents.push_back(vec);
-            line.clear();
-        }
+                for (auto i = begin; i < end; ++i)
+                    m_tokenized_contents[i] = tokenize_line (std::move (lines[i]), m_sep_str, specials);
+            });
     }
-    catch (boost::escaped_list_error &e)
+    catch (std::range_error &e)
     {
+        m_tokenized_contents.clear();
         throw (std::range_error N_("There was an error parsing the file."));
     }
 
@@ -199,6 +199,17 @@ TEST_F (GncTokenizerTest, tokenize_semicolon_sep)
     test_gnc_tokenize_helper (";", semicolon_separated);
 }
 
+static tokenize_csv_test_data multi_separated [] = {
+        { "Date,Num;Description\tNotes", 4, { "Date","Num","Description","Notes",NULL,NULL,NULL,NULL } },
+        { "\"A quoted field longer than sixteen characters, with; separators\";next", 2, { "A quoted field longer than sixteen characters, with; separators","next",NULL,NULL,NULL,NULL,NULL,NULL } },
+        { "An unquoted field longer than sixteen characters\\nwith an escaped newline,,", 3, { "An unquoted field longer than sixteen characters\nwith an escaped newline","","",NULL,NULL,NULL,NULL,NULL } },
+        { NULL, 0, { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL } },
+};
+TEST_F (GncTokenizerTest, tokenize_multi_sep)
+{
+    test_gnc_tokenize_helper (",;\t", multi_separated);
+}
+
 
 
 void
@@ -52,6 +52,7 @@
 #include "import-settings.h"
 #include "import-backend.h"
 #include "import-account-matcher.h"
+#include "import-match-index.hpp"
 #include "import-pending-matches.h"
 #include "gnc-component-manager.h"
 #include "guid.h"
@@ -542,6 +543,9 @@ on_matcher_ok_clicked (GtkButton *button, GNCImportMainMatcher *info)
     /* Don't run any queries and/or split sorts while processing the matcher
     results. */
     gnc_suspend_gui_refresh ();
+    /* Handlers that accept batches get one per entity at the end rather
+    than one per split/transaction/account change. */
+    qof_event_begin_batch ();
     bool first_tran = true;
     bool append_text = gtk_toggle_button_get_active ((GtkToggleButton*) info->append_text);
     GList *accounts_modified = NULL;
@@ -588,11 +592,13 @@ on_matcher_ok_clicked (GtkButton *button, GNCImportMainMatcher *info)
 
     gnc_gen_trans_list_delete (info);
 
-    /* Allow GUI refresh again. */
-    gnc_resume_gui_refresh ();
-
     /* DEBUG ("End") */
     g_list_free_full (accounts_modified, (GDestroyNotify)xaccAccountCommitEdit);
+
+    qof_event_end_batch ();
+
+    /* Allow GUI refresh again. */
+    gnc_resume_gui_refresh ();
 }
 
 void
@@ -2282,61 +2288,12 @@ filter_existing_splits_on_account_and_date (GNCImportMainMatcher *gui)
     return retval;
 }
 
-/* Create a hash by account of all splits that could match one of the imported
- * transactions based on their account and date and organized per account.
- */
-static GHashTable*
-create_hash_of_potential_matches (GList *candidate_splits,
-                                  GHashTable *account_hash)
-{
-    for (GList* candidate = candidate_splits; candidate != NULL;
-         candidate = g_list_next (candidate))
-    {
-        auto split = static_cast<Split*>(candidate->data);
-        if (gnc_import_split_has_online_id (split))
-            continue;
-        /* In this context an open transaction represents a freshly
-         * downloaded one. That can't possibly be a match yet */
-        if (xaccTransIsOpen(xaccSplitGetParent(split)))
-            continue;
-        Account *split_account = xaccSplitGetAccount (split);
-        /* g_hash_table_steal_extended would do the two calls in one shot but is
-         * not available until GLib 2.58.
-         */
-        auto split_list = static_cast<GSList*>(g_hash_table_lookup (account_hash, split_account));
-        g_hash_table_steal (account_hash, split_account);
-        split_list = g_slist_prepend (split_list, split);
-        g_hash_table_insert (account_hash, split_account, split_list);
-    }
-    return account_hash;
-}
-
-typedef struct _match_struct
-{
-    GNCImportTransInfo* transaction_info;
-    gint display_threshold;
-    gint date_threshold;
-    gint date_not_threshold;
-    double fuzzy_amount;
-} match_struct;
-
-static void
-match_helper (Split* data, match_struct* s)
-{
-    split_find_match (s->transaction_info, data,
-                      s->display_threshold,
-                      s->date_threshold,
-                      s->date_not_threshold,
-                      s->fuzzy_amount);
-}
-
 /* Iterate through the imported transactions selecting matches from the
- * potential match lists in the account hash and update the matcher with the
- * results.
+ * potential matches in the index and update the matcher with the results.
  */
 
 static void
-perform_matching (GNCImportMainMatcher *gui, GHashTable *account_hash)
+perform_matching (GNCImportMainMatcher *gui, const GncImportMatchIndex& index)
 {
     GtkTreeModel* model = gtk_tree_view_get_model (gui->view);
     gint display_threshold =
@@ -2352,11 +2309,9 @@ perform_matching (GNCImportMainMatcher *gui, GHashTable *account_hash)
          imported_txn = g_slist_next (imported_txn))
     {
         auto txn_info = static_cast<GNCImportTransInfo*>(imported_txn->data);
-        Account *importaccount = xaccSplitGetAccount (gnc_import_TransInfo_get_fsplit (txn_info));
-        match_struct s = {txn_info, display_threshold, date_threshold, date_not_threshold, fuzzy_amount};
 
-        g_slist_foreach (static_cast<GSList*>(g_hash_table_lookup (account_hash, importaccount)),
-                         (GFunc) match_helper, &s);
+        index.find_matches (txn_info, display_threshold, date_threshold,
+                            date_not_threshold, fuzzy_amount);
 
         // Sort the matches, select the best match, and set the action.
         gnc_import_TransInfo_init_matches (txn_info, gui->user_settings);
@@ -2379,17 +2334,13 @@ perform_matching (GNCImportMainMatcher *gui, GHashTable *account_hash)
 void
 gnc_gen_trans_list_create_matches (GNCImportMainMatcher *gui)
 {
-    GHashTable* account_hash =
-        g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
-                              (GDestroyNotify)g_slist_free);
     g_assert (gui);
     GList *candidate_splits = filter_existing_splits_on_account_and_date (gui);
 
-    create_hash_of_potential_matches (candidate_splits, account_hash);
-    perform_matching (gui, account_hash);
+    GncImportMatchIndex index{candidate_splits};
+    perform_matching (gui, index);
 
     g_list_free (candidate_splits);
-    g_hash_table_destroy (account_hash);
     return;
 }
 
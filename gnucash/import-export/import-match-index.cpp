@@ -0,0 +1,209 @@
+/********************************************************************\
+ * import-match-index.cpp -- Index of existing splits for matching  *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+#include <config.h>
+
+#include <gtk/gtk.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "import-match-index.hpp"
+#include "import-utilities.h"
+#include "Account.h"
+#include "Split.h"
+#include "engine-helpers.h"
+
+/* split_find_match() compares descriptions with strncasecmp, which folds
+ * case one byte at a time, so do the same. */
+static std::string
+fold_case (const char* str)
+{
+    std::string folded{str ? str : ""};
+    for (auto& c : folded)
+        c = std::tolower (static_cast<unsigned char>(c));
+    return folded;
+}
+
+static bool
+is_ascii (const char* str)
+{
+    for (; *str; ++str)
+        if (static_cast<unsigned char>(*str) & 0x80)
+            return false;
+    return true;
+}
+
+static time64
+days_apart (time64 a, time64 b)
+{
+    return llabs (a - b) / 86400;
+}
+
+GncImportMatchIndex::GncImportMatchIndex (GList* candidate_splits)
+{
+    for (auto node = candidate_splits; node; node = g_list_next (node))
+    {
+        auto split = static_cast<Split*>(node->data);
+        if (gnc_import_split_has_online_id (split))
+            continue;
+        /* In this context an open transaction represents a freshly
+         * downloaded one. That can't possibly be a match yet */
+        if (xaccTransIsOpen (xaccSplitGetParent (split)))
+            continue;
+        auto amount = gnc_numeric_to_double (xaccSplitGetAmount (split));
+        auto date = xaccTransGetDate (xaccSplitGetParent (split));
+        m_accounts[xaccSplitGetAccount (split)].candidates.push_back ({split, amount, date});
+    }
+
+    /* The matcher used to prepend each account's splits to a list and
+     * score them in that order; keep it so that matches with equal scores
+     * are still listed in the same order. */
+    for (auto& [account, index] : m_accounts)
+    {
+        std::reverse (index.candidates.begin (), index.candidates.end ());
+        build_index (index);
+    }
+}
+
+void
+GncImportMatchIndex::build_index (AccountIndex& index)
+{
+    auto& candidates = index.candidates;
+    index.by_amount.reserve (candidates.size ());
+    index.by_description.reserve (candidates.size ());
+    for (size_t i = 0; i < candidates.size (); ++i)
+    {
+        auto split = candidates[i].split;
+        auto trans = xaccSplitGetParent (split);
+        index.by_amount.emplace_back (candidates[i].amount, i);
+        auto descr = xaccTransGetDescription (trans);
+        index.by_description.emplace_back (fold_case (descr), i);
+        if (descr && !is_ascii (descr))
+            index.non_ascii_description.push_back (i);
+
+        auto number_str = gnc_get_num_action (trans, split);
+        if (!number_str)
+            continue;
+        index.by_number_string.emplace (number_str, i);
+        char *endptr;
+        errno = 0;
+        auto number = strtol (number_str, &endptr, 10);
+        if (!errno && endptr != number_str)
+            index.by_number.emplace (number, i);
+    }
+    std::sort (index.by_amount.begin (), index.by_amount.end ());
+    std::sort (index.by_description.begin (), index.by_description.end ());
+}
+
+void
+GncImportMatchIndex::find_matches (GNCImportTransInfo* trans_info,
+                                   gint display_threshold,
+                                   gint date_threshold,
+                                   gint date_not_threshold,
+                                   double fuzzy_amount_difference) const
+{
+    auto fsplit = gnc_import_TransInfo_get_fsplit (trans_info);
+    auto iter = m_accounts.find (xaccSplitGetAccount (fsplit));
+    if (iter == m_accounts.end ())
+        return;
+    auto& index = iter->second;
+    auto score = [&](size_t i)
+    {
+        split_find_match (trans_info, index.candidates[i].split,
+                          display_threshold, date_threshold,
+                          date_not_threshold, fuzzy_amount_difference);
+    };
+
+    /* A split whose amount doesn't match gets -5 for it and can get at
+     * most +3 for the date, so it needs at least display_threshold + 2
+     * from the number, memo and description. The memo is worth at most
+     * +2, so below a threshold of 1 nothing can be excluded. The same
+     * goes for a one character description because split_find_match()
+     * then gives every split at least +1 for it. */
+    auto trans = gnc_import_TransInfo_get_trans (trans_info);
+    auto descr = xaccTransGetDescription (trans);
+    auto descr_prefix_len = descr ? strlen (descr) / 2 : 0;
+    if (display_threshold < 1 || (descr && *descr && descr_prefix_len == 0))
+    {
+        for (size_t i = 0; i < index.candidates.size (); ++i)
+            score (i);
+        return;
+    }
+
+    std::vector<size_t> selected;
+
+    /* Every split with a matching or fuzzy matching amount. The range is
+     * a little wider than the fuzzy amount so that rounding can't leave
+     * out a split split_find_match() would accept. */
+    auto amount = gnc_numeric_to_double (xaccSplitGetAmount (fsplit));
+    auto width = fuzzy_amount_difference >= 1e-6 ? fuzzy_amount_difference : 1e-6;
+    width += 1e-9 * (1.0 + fabs (amount));
+    auto amount_begin = std::lower_bound (index.by_amount.begin (), index.by_amount.end (),
+                                          std::make_pair (amount - width, size_t{0}));
+    for (auto it = amount_begin; it != index.by_amount.end () && it->first <= amount + width; ++it)
+        selected.push_back (it->second);
+
+    /* The others need a matching number or description, and with
+     * at most +8 for those they also need a date that isn't penalized. */
+    auto download_time = xaccTransGetDate (trans);
+    auto add_if_near = [&](size_t i)
+    {
+        auto days = days_apart (index.candidates[i].date, download_time);
+        if (days == 0 || days <= date_threshold || days <= date_not_threshold)
+            selected.push_back (i);
+    };
+
+    auto number_str = gnc_get_num_action (trans, fsplit);
+    if (number_str && *number_str)
+    {
+        auto number = strtol (number_str, nullptr, 10);
+        auto numbers = index.by_number.equal_range (number);
+        for (auto it = numbers.first; it != numbers.second; ++it)
+            add_if_near (it->second);
+        auto number_strings = index.by_number_string.equal_range (number_str);
+        for (auto it = number_strings.first; it != number_strings.second; ++it)
+            add_if_near (it->second);
+    }
+
+    if (descr && *descr)
+    {
+        auto prefix = fold_case (descr).substr (0, descr_prefix_len);
+        auto descr_begin = std::lower_bound (index.by_description.begin (),
+                                             index.by_description.end (),
+                                             std::make_pair (prefix, size_t{0}));
+        for (auto it = descr_begin; it != index.by_description.end () &&
+                 it->first.compare (0, prefix.size (), prefix) == 0; ++it)
+            add_if_near (it->second);
+        /* An exact match is checked with Unicode case folding. */
+        for (auto i : index.non_ascii_description)
+            add_if_near (i);
+    }
+
+    std::sort (selected.begin (), selected.end ());
+    selected.erase (std::unique (selected.begin (), selected.end ()), selected.end ());
+    for (auto i : selected)
+        score (i);
+}
@@ -0,0 +1,101 @@
+/********************************************************************\
+ * import-match-index.hpp -- Index of existing splits for matching  *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+/** @addtogroup Import_Export
+    @{ */
+/** @file import-match-index.hpp
+    @brief Index of the existing splits an imported transaction may match
+*/
+
+#ifndef IMPORT_MATCH_INDEX_HPP
+#define IMPORT_MATCH_INDEX_HPP
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "import-backend.h"
+
+/** Finds the existing splits that imported transactions may match
+ * without scoring every imported transaction against every existing
+ * split in its account.
+ *
+ * split_find_match() adds at most +8 for the number, memo and
+ * description together and subtracts 5 when the amount differs by more
+ * than the fuzzy amount, so with a display threshold of at least 1 a
+ * split whose amount doesn't match can only be displayed if its date
+ * isn't far off and its number or the first half of its description
+ * matches. The index keeps each account's splits sorted by amount, by
+ * number and by case-folded description so that those splits can be
+ * looked up directly. Every split found is then scored by
+ * split_find_match() in the same order as a full scan would use, so the
+ * match lists are exactly the ones a full scan produces. When the
+ * settings or the imported transaction don't allow excluding anything
+ * the index falls back to scoring all of the account's splits.
+ */
+class GncImportMatchIndex
+{
+public:
+    /** Index the candidate splits, skipping those that can't be matched:
+     * splits with an online id and splits of open transactions.
+     *
+     * @param candidate_splits The splits to index. The list isn't kept.
+     */
+    GncImportMatchIndex (GList* candidate_splits);
+
+    /** Score the indexed splits that may match trans_info with
+     * split_find_match(), adding the matches to trans_info's match list.
+     * The parameters are passed to split_find_match().
+     */
+    void find_matches (GNCImportTransInfo* trans_info,
+                       gint display_threshold,
+                       gint date_threshold,
+                       gint date_not_threshold,
+                       double fuzzy_amount_difference) const;
+
+private:
+    struct Candidate
+    {
+        Split* split;
+        double amount;
+        time64 date;
+    };
+
+    struct AccountIndex
+    {
+        /* In the order a full scan would score them. */
+        std::vector<Candidate> candidates;
+        std::vector<std::pair<double, size_t>> by_amount;
+        std::unordered_multimap<long, size_t> by_number;
+        std::unordered_multimap<std::string, size_t> by_number_string;
+        std::vector<std::pair<std::string, size_t>> by_description;
+        /* Descriptions qof_utf8_strcasecmp may match without sharing
+         * a case-folded prefix with the imported one. */
+        std::vector<size_t> non_ascii_description;
+    };
+
+    static void build_index (AccountIndex& index);
+
+    std::unordered_map<const Account*, AccountIndex> m_accounts;
+};
+
+#endif
+/** @} */
@@ -0,0 +1,199 @@
+/********************************************************************
+ * gtest-import-match-index.cpp --                                  *
+ *                        unit tests for import-match-index.        *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ *******************************************************************/
+
+#include <gtest/gtest.h>
+#include <config.h>
+#include <gtk/gtk.h>
+#include <import-backend.h>
+#include <import-match-index.hpp>
+#include <gnc-session.h>
+#include <gnc-ui-util.h>
+#include <qofbook.h>
+#include <Account.h>
+#include <Transaction.h>
+#include <Split.h>
+#include <random>
+#include <vector>
+
+using MatchV = std::vector<std::pair<Split*, gint>>;
+
+static const char* descriptions[] =
+{
+    "", "A", "Grocery Store", "GROCERY STORE 1234", "grocery", "Rent",
+    "Rent March", "Salary", "Äpfel und Birnen", "äpfel und birnen",
+    "Café", "CAFÉ", "ATM Withdrawal",
+};
+static const char* numbers[] = { "", "12", "012", "13", "abc", "12a" };
+static const char* memos[] = { "", "memo", "MEMO", "other" };
+static const gint64 amounts[] = { 1000, 1001, 1099, 1100, 1250, 2000, -1000, 0 };
+
+class ImportMatchIndexTest : public ::testing::Test
+{
+protected:
+    ImportMatchIndexTest() :
+        m_book{gnc_get_current_book()}, m_root{gnc_account_create_root(m_book)},
+        m_rng{20240229}
+    {
+        auto create_account = [this](const char* name)->Account* {
+            auto account = xaccMallocAccount(this->m_book);
+            xaccAccountBeginEdit(account);
+            xaccAccountSetType(account, ACCT_TYPE_BANK);
+            xaccAccountSetName(account, name);
+            xaccAccountSetCommodity(account, gnc_default_currency());
+            xaccAccountBeginEdit(m_root);
+            gnc_account_append_child(m_root, account);
+            xaccAccountCommitEdit(m_root);
+            xaccAccountCommitEdit(account);
+            return account;
+        };
+        m_bank = create_account("Bank");
+        m_other = create_account("Other");
+        m_expense = create_account("Expense");
+    }
+    ~ImportMatchIndexTest()
+    {
+        xaccAccountBeginEdit(m_root);
+        xaccAccountDestroy(m_root); //It does the commit
+        gnc_clear_current_session();
+    }
+
+    template <typename T, size_t N> const T& pick(const T (&values)[N])
+    {
+        return values[std::uniform_int_distribution<size_t>{0, N - 1}(m_rng)];
+    }
+
+    Transaction* create_transaction(Account* account, bool commit)
+    {
+        auto trans = xaccMallocTransaction(m_book);
+        xaccTransBeginEdit(trans);
+        xaccTransSetCurrency(trans, gnc_default_currency());
+        xaccTransSetDescription(trans, pick(descriptions));
+        xaccTransSetNum(trans, pick(numbers));
+        auto days = std::uniform_int_distribution<time64>{0, 30}(m_rng);
+        auto hours = std::uniform_int_distribution<time64>{0, 23}(m_rng);
+        xaccTransSetDatePostedSecs(trans, m_base_time + days * 86400 + hours * 3600);
+        auto amount = gnc_numeric_create(pick(amounts), 100);
+        auto split = xaccMallocSplit(m_book);
+        xaccSplitSetParent(split, trans);
+        xaccSplitSetAccount(split, account);
+        xaccSplitSetMemo(split, pick(memos));
+        xaccSplitSetAmount(split, amount);
+        xaccSplitSetValue(split, amount);
+        auto balance = xaccMallocSplit(m_book);
+        xaccSplitSetParent(balance, trans);
+        xaccSplitSetAccount(balance, m_expense);
+        xaccSplitSetAmount(balance, gnc_numeric_neg(amount));
+        xaccSplitSetValue(balance, gnc_numeric_neg(amount));
+        if (commit)
+            xaccTransCommitEdit(trans);
+        return trans;
+    }
+
+    static MatchV get_matches(GNCImportTransInfo* info)
+    {
+        MatchV matches;
+        for (auto node = gnc_import_TransInfo_get_match_list(info); node;
+             node = g_list_next(node))
+        {
+            auto match = static_cast<GNCImportMatchInfo*>(node->data);
+            matches.emplace_back(gnc_import_MatchInfo_get_split(match),
+                                 gnc_import_MatchInfo_get_probability(match));
+        }
+        return matches;
+    }
+
+    QofBook* m_book;
+    Account* m_root;
+    Account* m_bank;
+    Account* m_other;
+    Account* m_expense;
+    std::mt19937 m_rng;
+    time64 m_base_time = 1700000000;
+};
+
+TEST_F(ImportMatchIndexTest, test_same_matches_as_full_scan)
+{
+    GList* candidates = nullptr;
+    for (int i = 0; i < 300; ++i)
+    {
+        auto trans = create_transaction(i % 3 ? m_bank : m_other, true);
+        candidates = g_list_prepend(candidates, xaccTransGetSplit(trans, 0));
+        /* The balancing splits aren't in the imported account so they
+         * must never be matched. */
+        candidates = g_list_prepend(candidates, xaccTransGetSplit(trans, 1));
+    }
+    candidates = g_list_reverse(candidates);
+    GncImportMatchIndex index{candidates};
+
+    /* The old matcher prepended the splits of each account to a list. */
+    std::vector<Split*> full_scan;
+    for (auto node = candidates; node; node = g_list_next(node))
+    {
+        auto split = static_cast<Split*>(node->data);
+        if (xaccSplitGetAccount(split) == m_bank)
+            full_scan.insert(full_scan.begin(), split);
+    }
+
+    const gint thresholds[] = { -3, 0, 1, 2, 5 };
+    for (int i = 0; i < 60; ++i)
+    {
+        auto scanned_trans = create_transaction(m_bank, false);
+        auto indexed_trans = xaccTransClone(scanned_trans);
+        xaccTransBeginEdit(indexed_trans);
+        auto scanned = gnc_import_TransInfo_new(scanned_trans, m_bank);
+        auto indexed = gnc_import_TransInfo_new(indexed_trans, m_bank);
+        auto threshold = thresholds[i % G_N_ELEMENTS(thresholds)];
+        auto fuzzy = i % 2 ? 2.0 : 0.0;
+
+        for (auto split : full_scan)
+            split_find_match(scanned, split, threshold, 4, 14, fuzzy);
+        index.find_matches(indexed, threshold, 4, 14, fuzzy);
+
+        EXPECT_EQ(get_matches(scanned), get_matches(indexed))
+            << "description \"" << xaccTransGetDescription(scanned_trans)
+            << "\" num \"" << xaccTransGetNum(scanned_trans)
+            << "\" threshold " << threshold;
+
+        gnc_import_TransInfo_delete(scanned);
+        gnc_import_TransInfo_delete(indexed);
+    }
+    g_list_free(candidates);
+}
+
+TEST_F(ImportMatchIndexTest, test_skips_open_transactions)
+{
+    auto trans = create_transaction(m_bank, false);
+    auto split = xaccTransGetSplit(trans, 0);
+    auto candidates = g_list_prepend(nullptr, split);
+    GncImportMatchIndex index{candidates};
+
+    auto imported_trans = xaccTransClone(trans);
+    xaccTransBeginEdit(imported_trans);
+    auto imported = gnc_import_TransInfo_new(imported_trans, m_bank);
+    index.find_matches(imported, -10, 4, 14, 2.0);
+    EXPECT_TRUE(get_matches(imported).empty());
+
+    gnc_import_TransInfo_delete(imported);
+    xaccTransCommitEdit(trans);
+    g_list_free(candidates);
+}
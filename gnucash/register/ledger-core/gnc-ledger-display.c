@@ -78,6 +78,9 @@ struct gnc_ledger_display
 
     gint number_of_subaccounts;
 
+    /* GUID of each loaded transaction -> GList of its loaded splits */
+    GHashTable *loaded_trans;
+
     gint component_id;
 };
 
@@ -563,6 +566,7 @@ gnc_ledger_display_set_watches (GNCLedgerDisplay* ld, GList* splits)
     GList* node;
 
     gnc_gui_component_clear_watches (ld->component_id);
+    g_hash_table_remove_all (ld->loaded_trans);
 
     gnc_gui_component_watch_entity_type (ld->component_id,
                                          GNC_ID_ACCOUNT,
@@ -573,11 +577,118 @@ gnc_ledger_display_set_watches (GNCLedgerDisplay* ld, GList* splits)
     {
         Split* split = node->data;
         Transaction* trans = xaccSplitGetParent (split);
+        const GncGUID* guid = xaccTransGetGUID (trans);
+        GList* trans_splits = g_hash_table_lookup (ld->loaded_trans, guid);
+
+        /* The hash table owns the list, so keep its head in place. */
+        if (trans_splits)
+        {
+            trans_splits = g_list_insert (trans_splits, split, 1);
+            continue;
+        }
 
-        gnc_gui_component_watch_entity (ld->component_id,
-                                        xaccTransGetGUID (trans),
+        gnc_gui_component_watch_entity (ld->component_id, guid,
                                         QOF_EVENT_MODIFY);
+        g_hash_table_insert (ld->loaded_trans, guid_copy (guid),
+                             g_list_prepend (NULL, split));
+    }
+}
+
+gboolean
+gnc_ledger_display_collect_changes (GHashTable* changes,
+                                    GHashTable* loaded_trans, QofBook* book,
+                                    GList** removed, GList** candidates)
+{
+    GHashTableIter iter;
+    gpointer key, value;
+
+    g_hash_table_iter_init (&iter, changes);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+        const GncGUID* guid = key;
+        const EventInfo* info = value;
+        Transaction* trans;
+        Split* split;
+        GList* node;
+
+        if (xaccAccountLookup (guid, book))
+        {
+            if (info->event_mask & (QOF_EVENT_CREATE | QOF_EVENT_DESTROY
+                                    | QOF_EVENT_ADD | QOF_EVENT_REMOVE))
+                return FALSE;
+            continue;
+        }
+
+        /* Committing a transaction generates events for its splits, so
+         * a split that's still around stands for its transaction. */
+        split = xaccSplitLookup (guid, book);
+        if (split)
+        {
+            trans = xaccSplitGetParent (split);
+            if (!trans)
+                continue;
+            guid = xaccTransGetGUID (trans);
+        }
+        else
+        {
+            trans = xaccTransLookup (guid, book);
+            if (info->event_mask & QOF_EVENT_DESTROY)
+                trans = NULL;
+        }
+
+        /* The old splits are only compared by address, they may be gone. */
+        for (node = g_hash_table_lookup (loaded_trans, guid); node;
+             node = node->next)
+            *removed = g_list_prepend (*removed, node->data);
+
+        if (!trans || qof_instance_get_destroying (trans))
+            continue;
+
+        for (node = xaccTransGetSplitList (trans); node; node = node->next)
+            *candidates = g_list_prepend (*candidates, node->data);
     }
+    return TRUE;
+}
+
+/* Bring the split list up to date from the transactions named in changes
+ * instead of running the query over the whole book. Returns FALSE when a
+ * change may affect which accounts the query covers, in which case the
+ * ledger has to be refreshed in full. */
+static gboolean
+gnc_ledger_display_refresh_changes (GNCLedgerDisplay* ld, GHashTable* changes)
+{
+    GList* removed = NULL;
+    GList* candidates = NULL;
+    GList* splits;
+
+    if (ld->needs_refresh)
+        return FALSE;
+
+    if (!gnc_ledger_display_collect_changes (changes, ld->loaded_trans,
+                                             gnc_get_current_book (),
+                                             &removed, &candidates))
+    {
+        g_list_free (removed);
+        g_list_free (candidates);
+        return FALSE;
+    }
+
+    splits = qof_query_update_results (ld->query, removed, candidates);
+    g_list_free (removed);
+    g_list_free (candidates);
+
+    gnc_ledger_display_set_watches (ld, splits);
+
+    if (!gnc_split_register_full_refresh_ok (ld->reg))
+        return TRUE;
+
+    /* The register has no way to patch rows in, so it's reloaded from the
+     * updated split list. */
+    ld->loading = TRUE;
+    gnc_split_register_load (ld->reg, splits,
+                             gnc_ledger_display_leader (ld));
+    ld->loading = FALSE;
+    return TRUE;
 }
 
 static void
@@ -621,6 +732,11 @@ refresh_handler (GHashTable* changes, gpointer user_data)
 
     if (ld->visible)
     {
+        if (changes && gnc_ledger_display_refresh_changes (ld, changes))
+        {
+            LEAVE ("refreshed changed transactions");
+            return;
+        }
         DEBUG ("immediate refresh because ledger is visible");
         gnc_ledger_display_refresh (ld);
     }
@@ -652,6 +768,8 @@ close_handler (gpointer user_data)
     if (ld->excluded_template_acc_hash)
         g_hash_table_destroy (ld->excluded_template_acc_hash);
 
+    g_hash_table_destroy (ld->loaded_trans);
+
     qof_query_destroy (ld->query);
     ld->query = NULL;
 
@@ -824,6 +942,10 @@ gnc_ledger_display_internal (Account* lead_account, Query* q,
     ld->get_parent = NULL;
     ld->user_data = NULL;
     ld->excluded_template_acc_hash = NULL;
+    ld->loaded_trans = g_hash_table_new_full (guid_hash_to_guint,
+                                              guid_g_hash_table_equal,
+                                              (GDestroyNotify)guid_free,
+                                              (GDestroyNotify)g_list_free);
 
     limit = gnc_prefs_get_float (GNC_PREFS_GROUP_GENERAL_REGISTER,
                                  GNC_PREF_MAX_TRANS);
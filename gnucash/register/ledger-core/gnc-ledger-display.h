@@ -121,6 +121,17 @@ GNCLedgerDisplay* gnc_ledger_display_find_by_query (Query* q);
 void gnc_ledger_display_refresh (GNCLedgerDisplay* ledger_display);
 void gnc_ledger_display_refresh_by_split_register (SplitRegister* reg);
 
+/** Gather what qof_query_update_results needs to bring a ledger's splits
+ * up to date from the component manager changes of a refresh. The loaded
+ * splits of each changed transaction, found in loaded_trans by the GUID
+ * of the transaction, are prepended to removed and its current splits to
+ * candidates. Returns FALSE if a change may affect which accounts the
+ * query covers, the ledger must then be refreshed in full. */
+gboolean gnc_ledger_display_collect_changes (GHashTable* changes,
+                                             GHashTable* loaded_trans,
+                                             QofBook* book, GList** removed,
+                                             GList** candidates);
+
 /** Mark the ledger as being in focus (refresh immediately) or not. */
 void gnc_ledger_display_set_focus (GNCLedgerDisplay* ld, gboolean focus);
 
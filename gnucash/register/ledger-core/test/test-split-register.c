@@ -26,6 +26,7 @@
 #include <qof.h>
 #include <TransLog.h>
 
+extern void test_suite_gnc_ledger_display();
 extern void test_suite_split_register_copy_ops();
 
 int
@@ -40,6 +41,7 @@ main (int   argc,
     /* Disable the transaction log */
     xaccLogDisable();
 
+    test_suite_gnc_ledger_display();
     test_suite_split_register_copy_ops();
 
     return g_test_run( );
@@ -0,0 +1,213 @@
+/********************************************************************
+ * utest-gnc-ledger-display.c: GLib g_test test suite for           *
+ * gnc-ledger-display.c.                                            *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * https://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+#include <config.h>
+#include <glib.h>
+#include <unittest-support.h>
+/* Add specific headers for this class */
+#include "gnc-component-manager.h"
+#include "gnc-ledger-display.h"
+
+static const gchar *suitename = "/register/ledger-core/gnc-ledger-display";
+void test_suite_gnc_ledger_display ( void );
+
+typedef struct
+{
+    QofBook *book;
+    Account *acc1;
+    Account *acc2;
+    gnc_commodity *curr;
+
+    Split *loaded_split;
+    Query *query;
+    GHashTable *loaded_trans;
+    /* GUID -> EventInfo, like the component manager records them */
+    GHashTable *changes;
+} Fixture;
+
+static Transaction *
+add_transaction (Fixture *fixture, gint64 amount)
+{
+    Transaction *txn = xaccMallocTransaction (fixture->book);
+    Split *split1 = xaccMallocSplit (fixture->book);
+    Split *split2 = xaccMallocSplit (fixture->book);
+
+    xaccTransBeginEdit (txn);
+    xaccTransSetCurrency (txn, fixture->curr);
+    xaccTransSetDatePostedSecs (txn, gnc_dmy2time64 (21, 4, 2012));
+    xaccSplitSetAmount (split1, gnc_numeric_create (amount, 100));
+    xaccSplitSetValue (split1, gnc_numeric_create (amount, 100));
+    xaccSplitSetAccount (split1, fixture->acc1);
+    xaccSplitSetParent (split1, txn);
+    xaccSplitSetAmount (split2, gnc_numeric_create (-amount, 100));
+    xaccSplitSetValue (split2, gnc_numeric_create (-amount, 100));
+    xaccSplitSetAccount (split2, fixture->acc2);
+    xaccSplitSetParent (split2, txn);
+    xaccTransCommitEdit (txn);
+    return txn;
+}
+
+static void
+record_event (QofInstance *entity, QofEventId event_type,
+              gpointer user_data, gpointer event_data)
+{
+    GHashTable *changes = user_data;
+    const GncGUID *guid = qof_instance_get_guid (entity);
+    EventInfo *info = g_hash_table_lookup (changes, guid);
+
+    if (!info)
+    {
+        info = g_new0 (EventInfo, 1);
+        g_hash_table_insert (changes, guid_copy (guid), info);
+    }
+    info->event_mask |= event_type;
+}
+
+static void
+setup (Fixture *fixture, gconstpointer pData)
+{
+    Transaction *txn;
+    GList *results;
+
+    fixture->book = qof_book_new ();
+    fixture->acc1 = xaccMallocAccount (fixture->book);
+    fixture->acc2 = xaccMallocAccount (fixture->book);
+    fixture->curr = gnc_commodity_new (fixture->book, "Gnu Rand", "CURRENCY", "GNR", "", 100);
+    xaccAccountSetCommodity (fixture->acc1, fixture->curr);
+    xaccAccountSetCommodity (fixture->acc2, fixture->curr);
+
+    txn = add_transaction (fixture, 3200);
+    fixture->loaded_split = xaccTransFindSplitByAccount (txn, fixture->acc1);
+
+    fixture->query = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (fixture->query, fixture->book);
+    xaccQueryAddSingleAccountMatch (fixture->query, fixture->acc1, QOF_QUERY_AND);
+    results = qof_query_run (fixture->query);
+    g_assert_cmpint (g_list_length (results), ==, 1);
+    g_assert_true (results->data == fixture->loaded_split);
+
+    fixture->loaded_trans = g_hash_table_new_full (guid_hash_to_guint,
+                                                   guid_g_hash_table_equal,
+                                                   (GDestroyNotify)guid_free,
+                                                   (GDestroyNotify)g_list_free);
+    g_hash_table_insert (fixture->loaded_trans, guid_copy (xaccTransGetGUID (txn)),
+                         g_list_prepend (NULL, fixture->loaded_split));
+    fixture->changes = g_hash_table_new_full (guid_hash_to_guint,
+                                              guid_g_hash_table_equal,
+                                              (GDestroyNotify)guid_free,
+                                              g_free);
+}
+
+static void
+teardown (Fixture *fixture, gconstpointer pData)
+{
+    g_hash_table_destroy (fixture->changes);
+    g_hash_table_destroy (fixture->loaded_trans);
+    qof_query_destroy (fixture->query);
+    qof_book_destroy (fixture->book);
+}
+
+/* A transaction committed in the queried account is picked up from the
+ * events of its commit, without running the query again: the one
+ * committed while the events weren't recorded doesn't show up. */
+static void
+test_collect_changes_new_transaction (Fixture *fixture, gconstpointer pData)
+{
+    GList *removed = NULL, *candidates = NULL, *results;
+    Transaction *added, *unseen;
+    Split *added_split;
+    gint handler_id;
+
+    handler_id = qof_event_register_handler (record_event, fixture->changes);
+    added = add_transaction (fixture, 1000);
+    qof_event_unregister_handler (handler_id);
+    unseen = add_transaction (fixture, 500);
+    added_split = xaccTransFindSplitByAccount (added, fixture->acc1);
+
+    g_assert_true (gnc_ledger_display_collect_changes (fixture->changes,
+                                                       fixture->loaded_trans,
+                                                       fixture->book,
+                                                       &removed, &candidates));
+    g_assert_null (removed);
+    g_assert_nonnull (g_list_find (candidates, added_split));
+
+    results = qof_query_update_results (fixture->query, removed, candidates);
+    g_assert_cmpint (g_list_length (results), ==, 2);
+    g_assert_nonnull (g_list_find (results, fixture->loaded_split));
+    g_assert_nonnull (g_list_find (results, added_split));
+    g_assert_null (g_list_find (results,
+                                xaccTransFindSplitByAccount (unseen, fixture->acc1)));
+    g_list_free (candidates);
+}
+
+/* The events a transaction generates for its splits stand for the
+ * transaction. */
+static void
+test_collect_changes_split_event (Fixture *fixture, gconstpointer pData)
+{
+    GList *removed = NULL, *candidates = NULL;
+    Transaction *txn = xaccSplitGetParent (fixture->loaded_split);
+    EventInfo *info = g_new0 (EventInfo, 1);
+
+    info->event_mask = QOF_EVENT_MODIFY;
+    g_hash_table_insert (fixture->changes,
+                         guid_copy (xaccSplitGetGUID (fixture->loaded_split)), info);
+
+    g_assert_true (gnc_ledger_display_collect_changes (fixture->changes,
+                                                       fixture->loaded_trans,
+                                                       fixture->book,
+                                                       &removed, &candidates));
+    g_assert_cmpint (g_list_length (removed), ==, 1);
+    g_assert_true (removed->data == fixture->loaded_split);
+    g_assert_cmpint (g_list_length (candidates), ==,
+                     g_list_length (xaccTransGetSplitList (txn)));
+    g_list_free (removed);
+    g_list_free (candidates);
+}
+
+/* Adding an account may change which accounts the query covers. */
+static void
+test_collect_changes_account_added (Fixture *fixture, gconstpointer pData)
+{
+    GList *removed = NULL, *candidates = NULL;
+    EventInfo *info = g_new0 (EventInfo, 1);
+
+    info->event_mask = QOF_EVENT_ADD;
+    g_hash_table_insert (fixture->changes,
+                         guid_copy (xaccAccountGetGUID (fixture->acc2)), info);
+
+    g_assert_false (gnc_ledger_display_collect_changes (fixture->changes,
+                                                        fixture->loaded_trans,
+                                                        fixture->book,
+                                                        &removed, &candidates));
+    g_list_free (removed);
+    g_list_free (candidates);
+}
+
+void
+test_suite_gnc_ledger_display (void)
+{
+    GNC_TEST_ADD (suitename, "collect changes new transaction", Fixture, NULL, setup, test_collect_changes_new_transaction, teardown);
+    GNC_TEST_ADD (suitename, "collect changes split event", Fixture, NULL, setup, test_collect_changes_split_event, teardown);
+    GNC_TEST_ADD (suitename, "collect changes account added", Fixture, NULL, setup, test_collect_changes_account_added, teardown);
+}
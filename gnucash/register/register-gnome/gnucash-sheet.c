@@ -489,22 +489,48 @@ gnucash_sheet_cursor_move (GnucashSheet *sheet, VirtualLocation virt_loc)
 }
 
 
-static gint
+/* Block origins never decrease from one row to the next, hidden blocks
+ * sharing the origin of the block that follows them, so the row is found
+ * with a binary search instead of walking the rows from the top. This
+ * matters for registers of many thousand rows, where it's done on every
+ * draw, scroll and pointer event. */
+gint
 gnucash_sheet_y_pixel_to_block (GnucashSheet *sheet, int y)
 {
     VirtualCellLocation vcell_loc = { 1, 0 };
+    gint low = 1, high = sheet->num_virt_rows;
+    SheetBlock *block;
 
-    for (;
-            vcell_loc.virt_row < sheet->num_virt_rows;
-            vcell_loc.virt_row++)
+    /* Find the first row starting below y. */
+    while (low < high)
     {
-        SheetBlock *block;
+        vcell_loc.virt_row = low + (high - low) / 2;
+        block = gnucash_sheet_get_block (sheet, vcell_loc);
+        if (block && block->origin_y <= y)
+            low = vcell_loc.virt_row + 1;
+        else
+            high = vcell_loc.virt_row;
+    }
 
+    /* The visible block before it contains y unless y is past its end. */
+    for (vcell_loc.virt_row = low - 1; vcell_loc.virt_row >= 1;
+         vcell_loc.virt_row--)
+    {
         block = gnucash_sheet_get_block (sheet, vcell_loc);
         if (!block || !block->visible)
             continue;
 
         if (block->origin_y + block->style->dimensions->height > y)
+            return vcell_loc.virt_row;
+        break;
+    }
+
+    for (vcell_loc.virt_row = low;
+         vcell_loc.virt_row < sheet->num_virt_rows;
+         vcell_loc.virt_row++)
+    {
+        block = gnucash_sheet_get_block (sheet, vcell_loc);
+        if (block && block->visible)
             break;
     }
     return vcell_loc.virt_row;
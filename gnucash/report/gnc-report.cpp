@@ -217,7 +217,7 @@ gnc_run_report_with_error_handling (gint report_id, gchar ** data, gchar **errms
     g_return_val_if_fail (errmsg, FALSE);
     g_return_val_if_fail (!scm_is_false (report), FALSE);
 
-    res = scm_call_1 (scm_c_eval_string ("gnc:render-report"), report);
+    res = scm_call_1 (scm_c_eval_string ("gnc:render-report-cached"), report);
     html = scm_car (res);
     captured_error = scm_cadr (res);
 
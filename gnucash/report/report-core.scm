@@ -46,6 +46,9 @@
 
 (export <report>)
 (export gnc:all-report-template-guids)
+(export gnc:cmdline-check-report)
+(export gnc:cmdline-get-report-id)
+(export gnc:cmdline-template-export)
 (export gnc:custom-report-template-guids)
 (export gnc:custom-report-invoice-template-guids)
 (export gnc:define-report)
@@ -82,6 +85,8 @@
 (export gnc:report-name)
 (export gnc:report-needs-save?)
 (export gnc:report-options)
+(export gnc:report-options-key)
+(export gnc:render-report-cached)
 (export gnc:report-render-html)
 (export gnc:render-report)
 (export gnc:report-serialize)
@@ -762,6 +767,55 @@ not found.")))
   (define (get-report) (gnc:report-render-html report #t))
   (gnc:apply-with-error-handling get-report '()))
 
+;; a string which changes whenever anything that determines the html of
+;; the report, apart from the book contents, is changed: its options,
+;; its stylesheet and the reports embedded in it.
+(define (gnc:report-options-key report)
+  (let ((options (gnc:report-options report))
+        (stylesheet (gnc:report-stylesheet report)))
+    (string-append
+     (gnc:report-type report)
+     (gnc:generate-restore-forms options "options")
+     (if stylesheet
+         (gnc:generate-restore-forms
+          (gnc:html-style-sheet-options stylesheet) "options")
+         "")
+     (string-concatenate
+      (map (lambda (id)
+             (let ((subreport (gnc-report-find id)))
+               (if subreport (gnc:report-options-key subreport) "")))
+           (or (gnc:report-embedded-list options) '()))))))
+
+;; what each report's cached html was rendered from: the book
+;; generation, the day, the preferences reports format amounts and dates
+;; with, and the report's options key.
+(define *rendered-report-keys* (make-weak-key-hash-table))
+
+(define (report-render-key report)
+  (list (qof-book-get-generation (gnc-get-current-book))
+        (gnc:time64-start-day-time (current-time))
+        (qof-date-format-get)
+        (map (lambda (pref) (gnc-prefs-get-bool "general" pref))
+             '("reversed-accounts-none" "reversed-accounts-credit"
+               "reversed-accounts-incomeexpense"))
+        (gnc:report-options-key report)))
+
+;; render report like gnc:render-report, reusing the html it cached
+;; unless the report is dirty or the book, the day, the preferences or
+;; its options key have changed since it was rendered. reloading a
+;; report page and changing its options go through here without marking
+;; the report dirty, so they only render it again if something changed.
+(define (gnc:render-report-cached report)
+  (unless (equal? (report-render-key report)
+                  (hashq-ref *rendered-report-keys* report))
+    (gnc:report-set-dirty?! report #t))
+  (let ((res (gnc:render-report report)))
+    ;; rendering may have committed something, don't count that.
+    (if (car res)
+        (hashq-set! *rendered-report-keys* report (report-render-key report))
+        (hashq-remove! *rendered-report-keys* report))
+    res))
+
 ;; "thunk" should take the report-type and the report template record
 (define (gnc:report-templates-for-each thunk)
   (hash-for-each
@@ -813,7 +867,7 @@ not found.")))
   (apply format (current-error-port) tmpl args)
   #f)
 
-(define (template-export report template export-type dry-run?)
+(define (template-export report template export-type settings dry-run?)
   (let* ((report-guid (gnc:report-template-report-guid template))
          (parent-template-guid (gnc:report-template-parent-type template))
          (template (if parent-template-guid
@@ -832,12 +886,35 @@ not found.")))
                   export-type (string-join (map car export-types) ", ")))
      (dry-run? #t)
      (else
-      (display "Running export..." (current-error-port))
-      (let ((output (export-thunk
-                     (gnc-report-find (gnc:make-report report-guid))
-                     (assoc-ref export-types export-type))))
-        (display "done!\n" (current-error-port))
-        output)))))
+      (let ((new-report (gnc-report-find (gnc:make-report report-guid))))
+        (and (set-cmdline-options! (gnc:report-options new-report) settings)
+             (begin
+               (display "Running export..." (current-error-port))
+               (let ((output (export-thunk
+                              new-report (assoc-ref export-types export-type))))
+                 (display "done!\n" (current-error-port))
+                 output))))))))
+
+;; In: options - the options of a report
+;; In: settings - list of (section name value), value being a string
+;;     holding the scheme datum to set the option to
+;; Out: #t, or #f after printing which setting failed
+(define (set-cmdline-options! options settings)
+  (every
+   (match-lambda
+     ((section name value)
+      (cond
+       ((not (gnc-lookup-option (gnc:optiondb options) section name))
+        (stderr-log "Cannot find option ~a/~a\n" section name))
+       (else
+        (catch #t
+          (lambda ()
+            (gnc-set-option (gnc:optiondb options) section name
+                            (call-with-input-string value read))
+            #t)
+          (lambda _
+            (stderr-log "Cannot set option ~a/~a to ~a\n" section name value)))))))
+   settings))
 
 (define (reportname->templates report)
   (or (and=> (gnc:find-report-template report) list)
@@ -878,8 +955,10 @@ not found.")))
 
 ;; In: report - string matching reportname
 ;; In: export-type - string matching export type (eg CSV TXF etc)
+;; In: settings - optional list of (section name value) options to set,
+;;     see set-cmdline-options!
 ;; Out: if args are valid and runs a single report: #t, otherwise: #f
-(define-public (gnc:cmdline-check-report report export-type)
+(define* (gnc:cmdline-check-report report export-type #:optional (settings '()))
   (let ((templates (reportname->templates report)))
     (cond
      ((null? templates)
@@ -892,21 +971,31 @@ not found.")))
       (gnc:cmdline-report-show report (current-error-port))
       (stderr-log "\n"))
 
+     ((not (set-cmdline-options!
+            (gnc:report-template-new-options (car templates)) settings))
+      #f)
+
      (export-type (template-export report (car templates)
-                                   export-type #t))
+                                   export-type settings #t))
      (else #t))))
 
 ;; In: report - string matching reportname
 ;; In: export-type - string matching export type (eg CSV TXF etc)
+;; In: settings - optional list of options to set, as above
 ;; Out: if error, #f
-(define-public (gnc:cmdline-template-export report export-type)
+(define* (gnc:cmdline-template-export report export-type #:optional (settings '()))
   (match (reportname->templates report)
-    ((template) (template-export report template export-type #f))
+    ((template) (template-export report template export-type settings #f))
     (_ (gnc:error report " does not match unique report") #f)))
 
 ;; In: report - string matching reportname
+;; In: settings - optional list of options to set, as above
 ;; Out: a number, or #f if error
-(define-public (gnc:cmdline-get-report-id report)
+(define* (gnc:cmdline-get-report-id report #:optional (settings '()))
   (match (reportname->templates report)
-    ((template) (gnc:make-report (gnc:report-template-report-guid template)))
+    ((template)
+     (let ((id (gnc:make-report (gnc:report-template-report-guid template))))
+       (and (set-cmdline-options! (gnc:report-options (gnc-report-find id))
+                                  settings)
+            id)))
     (_ (gnc:error report " does not match unique report") #f)))
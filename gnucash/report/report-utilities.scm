@@ -449,11 +449,14 @@
     (gnc:make-gnc-monetary (xaccAccountGetCommodity account) (or bal 0)))
   (define balance 0)
   (map amount->monetary
-       (gnc:account-accumulate-at-dates
-        account dates-list #:split->elt
-        (lambda (s)
-          (if s (set! balance (+ balance (or (split->amount s) 0))))
-          balance))))
+       (if (eq? split->amount xaccSplitGetAmount)
+           ;; the split running balance is the same sum
+           (gnc:account-accumulate-at-dates account dates-list)
+           (gnc:account-accumulate-at-dates
+            account dates-list #:split->elt
+            (lambda (s)
+              (if s (set! balance (+ balance (or (split->amount s) 0))))
+              balance)))))
 
 
 ;; this function will scan through account splitlist, building a list
@@ -470,6 +473,10 @@
 ;;                  gnc:account-get-balances-at-dates.
 ;; out: (list elt0 elt1 ...), each entry is the result of split->elt
 ;;      or nosplit->elt
+;;
+;; split->elt returning one of the split running balances only depends
+;; on the last split before each date; the engine finds those in one
+;; pass without calling back into scheme for each split.
 (define* (gnc:account-accumulate-at-dates
           acc dates #:key
           (nosplit->elt #f)
@@ -478,38 +485,46 @@
   (define to-date (or split->date (compose xaccTransGetDate xaccSplitGetParent)))
   (define (less? a b) (< (to-date a) (to-date b)))
 
-  (let lp ((splits (if split->date
-                       (stable-sort! (xaccAccountGetSplitList acc) less?)
-                       (xaccAccountGetSplitList acc)))
-           (dates (sort dates <))
-           (result '())
-           (last-result nosplit->elt))
-    (match dates
-
-      ;; end of dates. job done!
-      (() (reverse result))
-
-      ((date . rest)
-       (define (before-date? s) (<= (to-date s) date))
-       (define (after-date? s) (< date (to-date s)))
-       (cond
-
-        ;; end of splits, but still has dates. pad with last-result
-        ;; until end of dates.
-        ((null? splits) (lp '() rest (cons last-result result) last-result))
-
-        ;; the next split is still before date.
-        ((and (pair? (cdr splits)) (before-date? (cadr splits)))
-         (lp (cdr splits) dates result (split->elt (car splits))))
-
-        ;; head split after date, accumulate previous result
-        ((after-date? (car splits))
-         (lp splits rest (cons last-result result) last-result))
-
-        ;; head split before date, next split after date, or end.
-        (else
-         (let ((head-result (split->elt (car splits))))
-           (lp (cdr splits) rest (cons head-result result) head-result))))))))
+  (if (and (not split->date)
+           (every exact-integer? dates)
+           (memq split->elt (list xaccSplitGetBalance
+                                  xaccSplitGetNoclosingBalance
+                                  xaccSplitGetClearedBalance
+                                  xaccSplitGetReconciledBalance)))
+      (map (lambda (s) (if s (split->elt s) nosplit->elt))
+           (gnc-account-splits-at-dates acc (sort dates <)))
+      (let lp ((splits (if split->date
+                           (stable-sort! (xaccAccountGetSplitList acc) less?)
+                           (xaccAccountGetSplitList acc)))
+               (dates (sort dates <))
+               (result '())
+               (last-result nosplit->elt))
+        (match dates
+
+          ;; end of dates. job done!
+          (() (reverse result))
+
+          ((date . rest)
+           (define (before-date? s) (<= (to-date s) date))
+           (define (after-date? s) (< date (to-date s)))
+           (cond
+
+            ;; end of splits, but still has dates. pad with last-result
+            ;; until end of dates.
+            ((null? splits) (lp '() rest (cons last-result result) last-result))
+
+            ;; the next split is still before date.
+            ((and (pair? (cdr splits)) (before-date? (cadr splits)))
+             (lp (cdr splits) dates result (split->elt (car splits))))
+
+            ;; head split after date, accumulate previous result
+            ((after-date? (car splits))
+             (lp splits rest (cons last-result result) last-result))
+
+            ;; head split before date, next split after date, or end.
+            (else
+             (let ((head-result (split->elt (car splits))))
+               (lp (cdr splits) rest (cons head-result result) head-result)))))))))
 
 ;; This works similar as above but returns a commodity-collector,
 ;; thus takes care of children accounts with different currencies.
@@ -1245,7 +1260,7 @@
              (gnc-account-get-full-name acc)
              (gnc-commodity-get-mnemonic (xaccAccountGetCommodity acc))
              (xaccAccountGetTypeStr (xaccAccountGetType acc)))
-     (for-each (cut gnc:dump-split <> #f) (xaccAccountGetSplitList acc))
+     (gnc:account-for-each-split (cut gnc:dump-split <> #f) acc)
      (format #t "         Balance: ~a Cleared: ~a Reconciled: ~a\n"
              (gnc:monetary->string
               (gnc:make-gnc-monetary
@@ -362,19 +362,15 @@ developing over time"))
         (define account-balances-alist
           (map
            (lambda (acc)
-             (let* ((comm (xaccAccountGetCommodity acc))
-                    (split->elt (if reverse-bal?
-                                    (lambda (s)
-                                      (gnc:make-gnc-monetary
-                                       comm (- (xaccSplitGetNoclosingBalance s))))
-                                    (lambda (s)
-                                      (gnc:make-gnc-monetary
-                                       comm (xaccSplitGetNoclosingBalance s))))))
+             (let ((comm (xaccAccountGetCommodity acc)))
                (cons acc
-                     (gnc:account-accumulate-at-dates
-                      acc dates-list
-                      #:split->elt split->elt
-                      #:nosplit->elt (gnc:make-gnc-monetary comm 0)))))
+                     (map (lambda (bal)
+                            (gnc:make-gnc-monetary
+                             comm (if reverse-bal? (- bal) bal)))
+                          (gnc:account-accumulate-at-dates
+                           acc dates-list
+                           #:split->elt xaccSplitGetNoclosingBalance
+                           #:nosplit->elt 0)))))
            ;; all selected accounts (of report-specific type), *and*
            ;; their descendants (of any type) need to be scanned.
            (gnc-accounts-and-all-descendants accounts)))
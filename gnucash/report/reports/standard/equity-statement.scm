@@ -165,7 +165,7 @@
   (let ((total-flow (gnc:make-commodity-collector)))
     (for-each
      (lambda (target-account)
-       (for-each
+       (gnc:account-for-each-split
         (lambda (target-account-split)
           (let* ((transaction (xaccSplitGetParent target-account-split))
                  (split-value (xaccSplitGetAmount target-account-split)))
@@ -175,7 +175,7 @@
                          (and (eq? direction 'out)
                               (negative? split-value))))
                 (total-flow 'add (xaccTransGetCurrency transaction) split-value))))
-        (xaccAccountGetSplitList target-account)))
+        target-account))
      target-account-list)
     total-flow))
 
@@ -222,12 +222,11 @@
     (define (account->balancelist account)
       (let ((comm (xaccAccountGetCommodity account)))
         (cons account
-              (gnc:account-accumulate-at-dates
-               account dates-list
-               #:split->elt (lambda (s)
-                              (gnc:make-gnc-monetary
-                               comm (xaccSplitGetNoclosingBalance s)))
-               #:nosplit->elt (gnc:make-gnc-monetary comm 0)))))
+              (map (cut gnc:make-gnc-monetary comm <>)
+                   (gnc:account-accumulate-at-dates
+                    account dates-list
+                    #:split->elt xaccSplitGetNoclosingBalance
+                    #:nosplit->elt 0)))))
 
     ;; This calculates the balances for all the 'account-balances' for
     ;; each element of the list 'dates'. Uses the collector->report-currency-amount
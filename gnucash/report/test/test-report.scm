@@ -1,3 +1,4 @@
+(use-modules (gnucash engine))
 (use-modules (gnucash app-utils))
 (use-modules (gnucash report))
 (use-modules (srfi srfi-64))
@@ -18,6 +19,8 @@
   (test-report-template-getters)
   (test-make-report)
   (test-report)
+  (test-render-report-cached)
+  (test-cmdline-options)
   (test-end "Testing/Temporary/test-report"))
 
 (define test4-guid "54c2fc051af64a08ba2334c2e9179e24")
@@ -232,3 +235,82 @@
     (test-assert "gnc:report-serialize = string"
       (string?
        (gnc:report-serialize report)))))
+
+(define (test-render-report-cached)
+  (define test-uuid "cached-report-guid")
+  (define renders 0)
+  (test-begin "test-render-report-cached")
+  (gnc:define-report
+   'version 1
+   'name "cached report"
+   'report-guid test-uuid
+   'options-generator gnc:new-options
+   'renderer (lambda (obj)
+               (set! renders (1+ renders))
+               (format #f "render ~a" renders)))
+  (let* ((constructor (record-constructor <report>))
+         (options (gnc:make-report-options test-uuid))
+         (report (constructor test-uuid "cached" options #t #t #f #f ""))
+         (book (gnc-get-current-book)))
+    (test-equal "first run renders"
+      "render 1"
+      (car (gnc:render-report-cached report)))
+    (test-equal "unchanged report reuses its html"
+      "render 1"
+      (car (gnc:render-report-cached report)))
+    (gnc:report-set-dirty?! report #t)
+    (test-equal "reload after setting dirty renders again"
+      "render 2"
+      (car (gnc:render-report-cached report)))
+    (let ((acc (xaccMallocAccount book)))
+      (xaccAccountBeginEdit acc)
+      (xaccAccountSetName acc "changed")
+      (xaccAccountCommitEdit acc))
+    (test-equal "changing the book renders again"
+      "render 3"
+      (car (gnc:render-report-cached report)))
+    (test-equal "and reuses that html afterwards"
+      "render 3"
+      (car (gnc:render-report-cached report)))
+    (gnc-set-option options gnc:pagename-general gnc:optname-reportname
+                    "renamed")
+    (test-equal "changing an option renders again"
+      "render 4"
+      (car (gnc:render-report-cached report)))
+    (test-equal "a second render with unchanged options skips the renderer"
+      "render 4"
+      (car (gnc:render-report-cached report)))
+    (gnc-set-option options gnc:pagename-general gnc:optname-reportname
+                    "renamed")
+    (test-equal "setting an option to its current value skips the renderer"
+      "render 4"
+      (car (gnc:render-report-cached report))))
+  (test-end "test-render-report-cached"))
+
+(define (test-cmdline-options)
+  (define (report-name id)
+    (gnc-optiondb-lookup-value (gnc:optiondb (gnc:report-options (gnc-report-find id)))
+                               gnc:pagename-general gnc:optname-reportname))
+  (test-begin "test-cmdline-options")
+  (gnc:define-report
+   'version 1
+   'name "cmdline report"
+   'report-guid "cmdline-report-guid"
+   'options-generator gnc:new-options
+   'renderer (lambda (obj) "cmdline"))
+  (test-assert "valid option settings pass the check"
+    (gnc:cmdline-check-report "cmdline report" #f
+                              '(("General" "Report name" "\"Assets\""))))
+  (test-assert "an unknown option fails the check"
+    (not (gnc:cmdline-check-report "cmdline report" #f
+                                   '(("General" "No such option" "1")))))
+  (test-assert "an unreadable value fails the check"
+    (not (gnc:cmdline-check-report "cmdline report" #f
+                                   '(("General" "Report name" "(unclosed")))))
+  (test-equal "the report gets the options set"
+    "Assets"
+    (report-name (gnc:cmdline-get-report-id
+                  "cmdline report" '(("General" "Report name" "\"Assets\"")))))
+  (test-assert "settings are optional"
+    (number? (gnc:cmdline-get-report-id "cmdline report")))
+  (test-end "test-cmdline-options"))
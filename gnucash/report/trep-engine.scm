@@ -165,6 +165,7 @@ in the Options panel."))
   ;; together with the subtotal functions. Each entry:
   ;;  'sortkey             - sort parameter sent via qof-query
   ;;  'split-sortvalue     - function retrieves number/string for comparing splits
+  ;;  'split-key           - the GncSplitTableKey reading the same value natively
   ;;  'text                - text displayed in Display tab
   ;;  'renderer-fn         - helper function to select subtotal/subheading renderer
   ;;       behaviour varies according to sortkey.
@@ -176,24 +177,28 @@ in the Options panel."))
               (cons 'sortkey (list SPLIT-ACCT-FULLNAME))
               (cons 'split-sortvalue
                     (compose gnc-account-get-full-name xaccSplitGetAccount))
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-ACCOUNT-NAME)
               (cons 'text (G_ "Account Name"))
               (cons 'renderer-fn xaccSplitGetAccount))
 
         (list 'account-code
               (cons 'sortkey (list SPLIT-ACCOUNT ACCOUNT-CODE-))
               (cons 'split-sortvalue (compose xaccAccountGetCode xaccSplitGetAccount))
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-ACCOUNT-CODE)
               (cons 'text (G_ "Account Code"))
               (cons 'renderer-fn xaccSplitGetAccount))
 
         (list 'date
               (cons 'sortkey (list SPLIT-TRANS TRANS-DATE-POSTED))
               (cons 'split-sortvalue (compose xaccTransGetDate xaccSplitGetParent))
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-DATE-POSTED)
               (cons 'text (G_ "Date"))
               (cons 'renderer-fn #f))
 
         (list 'reconciled-date
               (cons 'sortkey (list SPLIT-DATE-RECONCILED))
               (cons 'split-sortvalue xaccSplitGetDateReconciled)
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-DATE-RECONCILED)
               (cons 'text (G_ "Reconciled Date"))
               (cons 'renderer-fn #f))
 
@@ -202,6 +207,7 @@ in the Options panel."))
               (cons 'split-sortvalue (lambda (s)
                                        (length (memv (xaccSplitGetReconcile s)
                                                      (map car reconcile-list)))))
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-RECONCILE)
               (cons 'text (G_ "Reconciled Status"))
               (cons 'renderer-fn (lambda (s)
                                    (assv-ref reconcile-list
@@ -210,24 +216,28 @@ in the Options panel."))
         (list 'register-order
               (cons 'sortkey (list QUERY-DEFAULT-SORT))
               (cons 'split-sortvalue #f)
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-NONE)
               (cons 'text (G_ "Register Order"))
               (cons 'renderer-fn #f))
 
         (list 'corresponding-acc-name
               (cons 'sortkey (list SPLIT-CORR-ACCT-NAME))
               (cons 'split-sortvalue xaccSplitGetCorrAccountFullName)
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-CORR-ACCOUNT-NAME)
               (cons 'text (G_ "Other Account Name"))
               (cons 'renderer-fn (compose xaccSplitGetAccount xaccSplitGetOtherSplit)))
 
         (list 'corresponding-acc-code
               (cons 'sortkey (list SPLIT-CORR-ACCT-CODE))
               (cons 'split-sortvalue xaccSplitGetCorrAccountCode)
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-CORR-ACCOUNT-CODE)
               (cons 'text (G_ "Other Account Code"))
               (cons 'renderer-fn (compose xaccSplitGetAccount xaccSplitGetOtherSplit)))
 
         (list 'amount
               (cons 'sortkey (list SPLIT-VALUE))
               (cons 'split-sortvalue xaccSplitGetValue)
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-VALUE)
               (cons 'text (G_ "Amount"))
               (cons 'renderer-fn #f))
 
@@ -235,6 +245,7 @@ in the Options panel."))
               (cons 'sortkey (list SPLIT-TRANS TRANS-DESCRIPTION))
               (cons 'split-sortvalue (compose xaccTransGetDescription
                                               xaccSplitGetParent))
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-DESCRIPTION)
               (cons 'text (G_ "Description"))
               (cons 'renderer-fn (compose xaccTransGetDescription xaccSplitGetParent)))
 
@@ -242,36 +253,42 @@ in the Options panel."))
             (list 'number
                   (cons 'sortkey (list SPLIT-ACTION))
                   (cons 'split-sortvalue xaccSplitGetAction)
+                  (cons 'split-key GNC-SPLIT-TABLE-KEY-ACTION)
                   (cons 'text (G_ "Number/Action"))
                   (cons 'renderer-fn #f))
 
             (list 'number
                   (cons 'sortkey (list SPLIT-TRANS TRANS-NUM))
                   (cons 'split-sortvalue (compose xaccTransGetNum xaccSplitGetParent))
+                  (cons 'split-key GNC-SPLIT-TABLE-KEY-TRANS-NUM)
                   (cons 'text (G_ "Number"))
                   (cons 'renderer-fn #f)))
 
         (list 't-number
               (cons 'sortkey (list SPLIT-TRANS TRANS-NUM))
               (cons 'split-sortvalue (compose xaccTransGetNum xaccSplitGetParent))
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-TRANS-NUM)
               (cons 'text (G_ "Transaction Number"))
               (cons 'renderer-fn #f))
 
         (list 'memo
               (cons 'sortkey (list SPLIT-MEMO))
               (cons 'split-sortvalue xaccSplitGetMemo)
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-MEMO)
               (cons 'text (G_ "Memo"))
               (cons 'renderer-fn xaccSplitGetMemo))
 
         (list 'notes
               (cons 'sortkey #f)
               (cons 'split-sortvalue (compose xaccTransGetNotes xaccSplitGetParent))
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-NOTES)
               (cons 'text (G_ "Notes"))
               (cons 'renderer-fn (compose xaccTransGetNotes xaccSplitGetParent)))
 
         (list 'none
               (cons 'sortkey '())
               (cons 'split-sortvalue #f)
+              (cons 'split-key GNC-SPLIT-TABLE-KEY-NONE)
               (cons 'text (G_ "None"))
               (cons 'renderer-fn #f))))
 
@@ -295,6 +312,7 @@ in the Options panel."))
   ;; List for date option.
   ;; Defines the different date sorting keys, as an association-list. Each entry:
   ;;  'split-sortvalue     - func retrieves number/string used for comparing splits
+  ;;  'split-period        - the GncSplitTablePeriod computing date-sortvalue natively
   ;;  'text                - text displayed in Display tab
   ;;  'renderer-fn         - func retrieves string for subtotal/subheading renderer
   ;;         #f means the date sortkey is not grouped
@@ -303,18 +321,21 @@ in the Options panel."))
    (list 'none
          (cons 'split-sortvalue #f)
          (cons 'date-sortvalue #f)
+         (cons 'split-period #f)
          (cons 'text (G_ "None"))
          (cons 'renderer-fn #f))
 
    (list 'daily
          (cons 'split-sortvalue (lambda (s) (time64-day (split->time64 s))))
          (cons 'date-sortvalue time64-day)
+         (cons 'split-period GNC-SPLIT-TABLE-PERIOD-DAY)
          (cons 'text (G_ "Daily"))
          (cons 'renderer-fn (lambda (s) (qof-print-date (split->time64 s)))))
 
    (list 'weekly
          (cons 'split-sortvalue (lambda (s) (time64-week (split->time64 s))))
          (cons 'date-sortvalue time64-week)
+         (cons 'split-period GNC-SPLIT-TABLE-PERIOD-WEEK)
          (cons 'text (G_ "Weekly"))
          (cons 'renderer-fn (compose gnc:date-get-week-year-string
                                      gnc-localtime
@@ -323,6 +344,7 @@ in the Options panel."))
    (list 'monthly
          (cons 'split-sortvalue (lambda (s) (time64-month (split->time64 s))))
          (cons 'date-sortvalue time64-month)
+         (cons 'split-period GNC-SPLIT-TABLE-PERIOD-MONTH)
          (cons 'text (G_ "Monthly"))
          (cons 'renderer-fn (compose gnc:date-get-month-year-string
                                      gnc-localtime
@@ -331,6 +353,7 @@ in the Options panel."))
    (list 'quarterly
          (cons 'split-sortvalue (lambda (s) (time64-quarter (split->time64 s))))
          (cons 'date-sortvalue time64-quarter)
+         (cons 'split-period GNC-SPLIT-TABLE-PERIOD-QUARTER)
          (cons 'text (G_ "Quarterly"))
          (cons 'renderer-fn (compose gnc:date-get-quarter-year-string
                                      gnc-localtime
@@ -339,6 +362,7 @@ in the Options panel."))
    (list 'yearly
          (cons 'split-sortvalue (lambda (s) (time64-year (split->time64 s))))
          (cons 'date-sortvalue time64-year)
+         (cons 'split-period GNC-SPLIT-TABLE-PERIOD-YEAR)
          (cons 'text (G_ "Yearly"))
          (cons 'renderer-fn (compose gnc:date-get-year-string
                                      gnc-localtime
@@ -1035,7 +1059,7 @@ be excluded from periodic reporting.")
 ;; ;;;;;;;;;;;;;;;;;;;;
 ;; Here comes the big function that builds the whole table.
 
-(define (make-split-table splits options parameters custom-calculated-cells)
+(define (make-split-table splits split-table options parameters custom-calculated-cells)
 
   (define (report-uses? param)
     (assq-ref parameters param))
@@ -1933,9 +1957,7 @@ be excluded from periodic reporting.")
 
             (cond
              ((and primary-subtotal-comparator
-                   (or (not next)
-                       (not (equal? (primary-subtotal-comparator current)
-                                    (primary-subtotal-comparator next)))))
+                   (gnc-split-table-group-ends split-table work-done 0))
               (when secondary-subtotal-comparator
                 (add-subtotal-row (total-string
                                    (render-summary current 'secondary #f))
@@ -1976,9 +1998,7 @@ be excluded from periodic reporting.")
 
              (else
               (when (and secondary-subtotal-comparator
-                         (or (not next)
-                             (not (equal? (secondary-subtotal-comparator current)
-                                          (secondary-subtotal-comparator next)))))
+                         (gnc-split-table-group-ends split-table work-done 1))
                 (add-subtotal-row (total-string
                                    (render-summary current 'secondary #f))
                                   secondary-subtotal-collectors
@@ -2202,6 +2222,7 @@ be excluded from periodic reporting.")
                          (opt-val pagename-filter optname-closing-transactions)
                          'closing-match))
          (splits '())
+         (split-table #f)
          (subtotal-table? (and (opt-val gnc:pagename-display optname-grid)
                                (if (memq primary-key DATE-SORTING-TYPES)
                                    (keylist-get-info date-subtotal-list
@@ -2361,66 +2382,42 @@ be excluded from periodic reporting.")
                 (CUSTOM-SORTING? secondary-key parameters))))
 
     (define (match? str)
-      (cond
-       (transaction-matcher-regexp
-        (regexp-exec transaction-matcher-regexp str))
-       (transaction-filter-case-insensitive?
-        (string-contains-ci str transaction-matcher))
-       (else
-        (string-contains str transaction-matcher))))
-
-    (define (generic-less? split-X split-Y sortkey date-subtotal-key ascend?)
-      ;; compare splits X and Y, whereby
-      ;; sortkey and date-subtotal-key specify the options used
-      ;; ascend? specifies whether ascending or descending
-      (let* ((comparator-function
-              (if (memq sortkey DATE-SORTING-TYPES)
-                  (let ((date (keylist-get-info
-                               (sortkey-list parameters)
-                               sortkey 'split-sortvalue))
-                        (date-comparator
-                         (keylist-get-info date-subtotal-list
-                                           date-subtotal-key 'date-sortvalue)))
-                    (lambda (s)
-                      (and date-comparator (date-comparator (date s)))))
-                  (or (keylist-get-info (sortkey-list parameters)
-                                        sortkey 'split-sortvalue)
-                      (lambda (s) #f))))
-             (value-of-X (comparator-function split-X))
-             (value-of-Y (comparator-function split-Y))
-             (op (if (string? value-of-X)
-                     (if ascend? gnc:string-locale<? gnc:string-locale>?)
-                     (if ascend? < >))))
-        (and value-of-X (op value-of-X value-of-Y))))
-
-    (define (primary-comparator? X Y)
-      (generic-less? X Y primary-key
-                     primary-date-subtotal
-                     (eq? primary-order 'ascend)))
-
-    (define (secondary-comparator? X Y)
-      (generic-less? X Y secondary-key
-                     secondary-date-subtotal
-                     (eq? secondary-order 'ascend)))
-
-    ;; This will, by default, sort the split list by ascending posted-date.
-    (define (date-comparator? X Y)
-      (generic-less? X Y 'date 'none #t))
+      (regexp-exec transaction-matcher-regexp str))
 
     (define (transaction-filter-match split)
       (or (match? (xaccTransGetDescription (xaccSplitGetParent split)))
           (match? (xaccTransGetNotes (xaccSplitGetParent split)))
           (match? (xaccSplitGetMemo split))))
 
-    (define (is-filter-member split account-list)
-      (define (same-split? s) (equal? s split))
-      (define (from-account? s) (member (xaccSplitGetAccount s) account-list))
-      (let lp ((splits (xaccTransGetSplitList (xaccSplitGetParent split))))
-        (match splits
-          (() #f)
-          (((? same-split?) . rest) (lp rest))
-          (((? from-account?) . _) #t)
-          ((_ . rest) (lp rest)))))
+    (define (sort-key-args sortkey date-subtotal-key)
+      ;; the split-table key and period sorting on sortkey. a date
+      ;; sortkey without a date subtotal leaves the splits in order.
+      (let ((split-key (keylist-get-info (sortkey-list parameters)
+                                         sortkey 'split-key)))
+        (if (memq sortkey DATE-SORTING-TYPES)
+            (let ((period (keylist-get-info date-subtotal-list
+                                            date-subtotal-key 'split-period)))
+              (if period
+                  (list split-key period)
+                  (list GNC-SPLIT-TABLE-KEY-NONE GNC-SPLIT-TABLE-PERIOD-NONE)))
+            (list split-key GNC-SPLIT-TABLE-PERIOD-NONE))))
+
+    (define (group-key-args sortkey date-subtotal-key subtotal?)
+      ;; the split-table key and period of the subtotal groups, which
+      ;; follow the 'split-sortvalue of the primary/secondary-key
+      ;; parameters.
+      (cond
+       ((memq sortkey DATE-SORTING-TYPES)
+        (let ((period (keylist-get-info date-subtotal-list
+                                        date-subtotal-key 'split-period)))
+          (if period
+              (list GNC-SPLIT-TABLE-KEY-DATE-POSTED period)
+              (list GNC-SPLIT-TABLE-KEY-NONE GNC-SPLIT-TABLE-PERIOD-NONE))))
+       ((and subtotal? (SUBTOTAL-ENABLED? sortkey parameters))
+        (list (keylist-get-info (sortkey-list parameters) sortkey 'split-key)
+              GNC-SPLIT-TABLE-PERIOD-NONE))
+       (else
+        (list GNC-SPLIT-TABLE-KEY-NONE GNC-SPLIT-TABLE-PERIOD-NONE))))
 
     (cond
      ((or (null? c_account_1)
@@ -2477,50 +2474,76 @@ be excluded from periodic reporting.")
          query (eq? primary-order 'ascend) (eq? secondary-order 'ascend)
          #t))
 
-      (if (opt-val "__trep" "unique-transactions")
-          (set! splits (xaccQueryGetSplitsUniqueTrans query))
-          (set! splits (qof-query-run query)))
+      (set! split-table
+        (gnc-split-table-new
+         (if (opt-val "__trep" "unique-transactions")
+             (xaccQueryGetSplitsUniqueTrans query)
+             (qof-query-run query))))
 
       (qof-query-destroy query)
 
-      ;; Combined Filter:
+      ;; Combined Filter, applied by the split-table where possible:
       ;; - include/exclude using split->date according to date options
       ;; - include/exclude splits to/from selected accounts
       ;; - substring/regex matcher for Transaction Description/Notes/Memo
       ;; - custom-split-filter, a split->bool function for derived reports
-      (set! splits
-        (filter
-         (lambda (split)
-           (let* ((trans (xaccSplitGetParent split)))
-             (and (case date-source
-                    ((posted) #t)
-                    ((reconciled)
-                     (if (char=? (xaccSplitGetReconcile split) #\y)
-                         (<= begindate (xaccSplitGetDateReconciled split) enddate)
-                         #t))
-                    ((entered) (<= begindate (xaccTransRetDateEntered trans) enddate))
-                    ((custom)
-                     (let ((date (split->date split)))
-                        (if date
-                            (<= begindate date enddate)
-                            split->date-include-false?)))
-                    (else (gnc:warn "invalid date-source" date-source) #t))
-                  (case filter-mode
-                    ((none) #t)
-                    ((include) (is-filter-member split c_account_2))
-                    ((exclude) (not (is-filter-member split c_account_2))))
-                  (or (string-null? transaction-matcher)
-                      (if transaction-filter-exclude?
-                          (not (transaction-filter-match split))
-                          (transaction-filter-match split)))
-                  (or (not custom-split-filter)
-                      (custom-split-filter split)))))
-         splits))
-
+      (case date-source
+        ((posted) #t)
+        ((reconciled)
+         (gnc-split-table-filter-date-reconciled split-table begindate enddate))
+        ((entered)
+         (gnc-split-table-filter-date-entered split-table begindate enddate))
+        ((custom) #t)
+        (else (gnc:warn "invalid date-source" date-source)))
+
+      (case filter-mode
+        ((none) #t)
+        ((include) (gnc-split-table-filter-other-accounts split-table c_account_2 #f))
+        ((exclude) (gnc-split-table-filter-other-accounts split-table c_account_2 #t)))
+
+      (unless transaction-matcher-regexp
+        (gnc-split-table-filter-text split-table transaction-matcher
+                                     transaction-filter-case-insensitive?
+                                     transaction-filter-exclude?))
+
+      (when (or (eq? date-source 'custom)
+                transaction-matcher-regexp
+                custom-split-filter)
+        (let ((filtered
+               (filter
+                (lambda (split)
+                  (and (or (not (eq? date-source 'custom))
+                           (let ((date (split->date split)))
+                             (if date
+                                 (<= begindate date enddate)
+                                 split->date-include-false?)))
+                       (or (not transaction-matcher-regexp)
+                           (string-null? transaction-matcher)
+                           (if transaction-filter-exclude?
+                               (not (transaction-filter-match split))
+                               (transaction-filter-match split)))
+                       (or (not custom-split-filter)
+                           (custom-split-filter split))))
+                (gnc-split-table-get-splits split-table))))
+          (gnc-split-table-free split-table)
+          (set! split-table (gnc-split-table-new filtered))))
+
+      ;; the query sorted the splits unless custom-sort? is needed.
       (when custom-sort?
-        (set! splits (stable-sort! splits date-comparator?))
-        (set! splits (stable-sort! splits secondary-comparator?))
-        (set! splits (stable-sort! splits primary-comparator?)))
+        (apply gnc-split-table-add-sort-key split-table
+               (append (sort-key-args primary-key primary-date-subtotal)
+                       (list (eq? primary-order 'ascend))))
+        (apply gnc-split-table-add-sort-key split-table
+               (append (sort-key-args secondary-key secondary-date-subtotal)
+                       (list (eq? secondary-order 'ascend))))
+        (gnc-split-table-sort split-table))
+
+      (apply gnc-split-table-set-group-key split-table 0
+             (group-key-args primary-key primary-date-subtotal primary-subtotal))
+      (apply gnc-split-table-set-group-key split-table 1
+             (group-key-args secondary-key secondary-date-subtotal secondary-subtotal))
+
+      (set! splits (gnc-split-table-get-splits split-table))
 
       (cond
        ((null? splits)
@@ -2540,7 +2563,7 @@ be excluded from periodic reporting.")
 
        (else
         (let-values (((table grid csvlist)
-                      (make-split-table splits options parameters
+                      (make-split-table splits split-table options parameters
                                         custom-calculated-cells)))
 
           (gnc:html-document-set-title! document report-title)
@@ -2581,7 +2604,9 @@ be excluded from periodic reporting.")
                    csvlist)))))
 
              (else
-              (gnc:html-document-set-export-error document csvlist))))))))))
+              (gnc:html-document-set-export-error document csvlist))))))))
+
+      (gnc-split-table-free split-table)))
 
     (gnc:report-finished)
 
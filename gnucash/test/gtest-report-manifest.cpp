@@ -0,0 +1,93 @@
+/********************************************************************\
+ * gtest-report-manifest.cpp -- Unit tests for the run-batch manifest *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ \ *********************************************************************/
+
+#include <config.h>
+#include "gnucash-commands.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using Gnucash::BatchReport;
+using Gnucash::parse_report_manifest;
+
+TEST(ReportManifest, entries)
+{
+    std::istringstream in{
+        "# report\toutput\texport type\toptions\n"
+        "\n"
+        "Balance Sheet\t/tmp/bs.html\n"
+        "  Income Statement \t /tmp/is.html \t\n"
+        "Tax Schedule Report/TXF Export\t/tmp/tax.txf\tTXF\n"
+        "Balance Sheet\t/tmp/bs2.html\t\tGeneral/Report name=\"Assets\"\t"
+        "General/Balance Sheet Date = (relative . today)\n"};
+    std::vector<BatchReport> reports;
+
+    ASSERT_TRUE (parse_report_manifest (in, "test", reports));
+    ASSERT_EQ (4u, reports.size());
+
+    EXPECT_EQ ("Balance Sheet", reports[0].report);
+    EXPECT_EQ ("/tmp/bs.html", reports[0].output_file);
+    EXPECT_TRUE (reports[0].export_type.empty());
+    EXPECT_TRUE (reports[0].options.empty());
+
+    EXPECT_EQ ("Income Statement", reports[1].report);
+    EXPECT_EQ ("/tmp/is.html", reports[1].output_file);
+    EXPECT_TRUE (reports[1].export_type.empty());
+
+    EXPECT_EQ ("Tax Schedule Report/TXF Export", reports[2].report);
+    EXPECT_EQ ("TXF", reports[2].export_type);
+    EXPECT_TRUE (reports[2].options.empty());
+
+    auto& options{reports[3].options};
+    EXPECT_TRUE (reports[3].export_type.empty());
+    ASSERT_EQ (2u, options.size());
+    EXPECT_EQ ("General", options[0].section);
+    EXPECT_EQ ("Report name", options[0].name);
+    EXPECT_EQ ("\"Assets\"", options[0].value);
+    EXPECT_EQ ("General", options[1].section);
+    EXPECT_EQ ("Balance Sheet Date", options[1].name);
+    EXPECT_EQ ("(relative . today)", options[1].value);
+}
+
+TEST(ReportManifest, invalid_lines)
+{
+    for (auto line : {"Balance Sheet\n",
+                      "\t/tmp/bs.html\n",
+                      "Balance Sheet\t\n",
+                      "Balance Sheet\t/tmp/bs.html\t\tReport name=1\n",
+                      "Balance Sheet\t/tmp/bs.html\t\tGeneral/Report name\n",
+                      "Balance Sheet\t/tmp/bs.html\t\tGeneral/=1\n",
+                      "Balance Sheet\t/tmp/bs.html\t\tGeneral/Report name=\n"})
+    {
+        std::istringstream in{line};
+        std::vector<BatchReport> reports;
+        EXPECT_FALSE (parse_report_manifest (in, "test", reports)) << line;
+    }
+}
+
+TEST(ReportManifest, empty)
+{
+    std::istringstream in{"# nothing to run\n\n"};
+    std::vector<BatchReport> reports;
+
+    EXPECT_TRUE (parse_report_manifest (in, "test", reports));
+    EXPECT_TRUE (reports.empty());
+}
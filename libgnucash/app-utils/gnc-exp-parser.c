@@ -49,12 +49,46 @@ typedef struct ParserNum
     gnc_numeric value;
 } ParserNum;
 
+/* The tree of a formula, built by the parser callbacks of
+ * gnc_exp_parser_compile.  Operators use the parser's op symbols. */
+typedef struct FormulaNode
+{
+    char op;
+    gboolean negate;
+    gnc_numeric value;
+    guint slot;
+    struct FormulaNode *left;
+    struct FormulaNode *right;
+} FormulaNode;
+
+#define FORMULA_NUMBER     'I'
+#define FORMULA_VARIABLE   'V'
+#define FORMULA_STACK_SIZE 64
+
+/* One step of a compiled formula: push a number or variable, or apply
+ * an operator to the top two values of the stack. */
+typedef struct FormulaStep
+{
+    char op;
+    gboolean negate;
+    gnc_numeric value;
+    guint slot;
+} FormulaStep;
+
+struct GncExpFormula
+{
+    GArray *steps;
+    GPtrArray *var_names;
+};
+
 
 /** Static Globals *************************************************/
 static GHashTable   *variable_bindings = NULL;
 static ParseError    last_error        = PARSER_NO_ERROR;
 static GNCParseError last_gncp_error   = NO_ERR;
 static gboolean      parser_inited     = FALSE;
+static GPtrArray    *formula_nodes     = NULL;
+static gboolean      formula_refused   = FALSE;
 
 
 /** Implementations ************************************************/
@@ -600,6 +634,300 @@ gnc_exp_parser_parse_separate_vars (const char * expression,
     return last_error == PARSER_NO_ERROR;
 }
 
+/** Compiled formulas ***********************************************/
+
+static FormulaNode *
+formula_node_new (char op)
+{
+    FormulaNode *node = g_new0 (FormulaNode, 1);
+
+    node->op = op;
+    g_ptr_array_add (formula_nodes, node);
+
+    return node;
+}
+
+static void *
+formula_trans_numeric (const char *digit_str,
+                       gchar      *radix_point,
+                       gchar      *group_char,
+                       char      **rstr)
+{
+    FormulaNode *node;
+    gnc_numeric value;
+
+    if (digit_str == NULL)
+        return NULL;
+
+    /* The parser gives each new variable the value "0", without asking
+     * where the number ends. */
+    if (rstr == NULL)
+        return formula_node_new (FORMULA_VARIABLE);
+
+    if (!xaccParseAmount (digit_str, TRUE, &value, rstr))
+        return NULL;
+
+    node = formula_node_new (FORMULA_NUMBER);
+    node->value = value;
+
+    return node;
+}
+
+static void *
+formula_numeric_ops (char op_sym,
+                     void *left_value,
+                     void *right_value)
+{
+    FormulaNode *node;
+
+    if ((left_value == NULL) || (right_value == NULL))
+        return NULL;
+
+    if (op_sym == ASN_OP)
+    {
+        formula_refused = TRUE;
+        return left_value;
+    }
+
+    node = formula_node_new (op_sym);
+    node->left = left_value;
+    node->right = right_value;
+
+    return node;
+}
+
+static void *
+formula_negate_numeric (void *value)
+{
+    FormulaNode *node = value;
+
+    if (node == NULL)
+        return NULL;
+
+    /* The parser negates a variable in place, so its later uses see the
+     * negated value.  Leave that to the parser. */
+    if (node->op == FORMULA_VARIABLE)
+        formula_refused = TRUE;
+
+    node->negate = !node->negate;
+
+    return node;
+}
+
+static void
+formula_free_numeric (void *value)
+{
+    /* The nodes are freed with formula_nodes. */
+}
+
+static void *
+formula_func_op (const char *fname, int argc, void **argv)
+{
+    /* Functions are evaluated by guile; leave them to the parser. */
+    return NULL;
+}
+
+/* Append the steps computing node to steps and return the depth of the
+ * stack they need. */
+static guint
+formula_add_steps (GArray *steps, const FormulaNode *node)
+{
+    FormulaStep step;
+    guint depth = 1;
+
+    if (node->left)
+    {
+        depth = formula_add_steps (steps, node->left);
+        depth = MAX (depth, formula_add_steps (steps, node->right) + 1);
+    }
+
+    step.op = node->op;
+    step.negate = node->negate;
+    step.value = node->value;
+    step.slot = node->slot;
+    g_array_append_val (steps, step);
+
+    return depth;
+}
+
+GncExpFormula *
+gnc_exp_parser_compile (const char *expression)
+{
+    parser_env_ptr pe;
+    var_store_ptr var;
+    struct lconv *lc;
+    var_store result;
+    GncExpFormula *formula = NULL;
+    char *error_loc;
+
+    if (expression == NULL)
+        return NULL;
+
+    /* Assignments change the variables while the expression is parsed. */
+    if (strchr (expression, ASN_OP))
+        return NULL;
+
+    result.variable_name = NULL;
+    result.value = NULL;
+    result.next_var = NULL;
+
+    formula_nodes = g_ptr_array_new_with_free_func (g_free);
+    formula_refused = FALSE;
+
+    lc = gnc_localeconv ();
+
+    pe = init_parser (NULL, lc->mon_decimal_point, lc->mon_thousands_sep,
+                      formula_trans_numeric, formula_numeric_ops,
+                      formula_negate_numeric, formula_free_numeric,
+                      formula_func_op);
+
+    error_loc = parse_string (&result, expression, pe);
+
+    if (error_loc == NULL && !formula_refused && result.value)
+    {
+        formula = g_new0 (GncExpFormula, 1);
+        formula->var_names = g_ptr_array_new_with_free_func (g_free);
+        formula->steps = g_array_new (FALSE, FALSE, sizeof (FormulaStep));
+
+        for (var = parser_get_vars (pe); var; var = var->next_var)
+        {
+            FormulaNode *node = var->value;
+
+            node->slot = formula->var_names->len;
+            g_ptr_array_add (formula->var_names, g_strdup (var->variable_name));
+        }
+
+        if (formula_add_steps (formula->steps, result.value) > FORMULA_STACK_SIZE)
+        {
+            gnc_exp_formula_free (formula);
+            formula = NULL;
+        }
+    }
+
+    exit_parser (pe);
+
+    g_ptr_array_free (formula_nodes, TRUE);
+    formula_nodes = NULL;
+
+    return formula;
+}
+
+void
+gnc_exp_formula_free (GncExpFormula *formula)
+{
+    if (formula == NULL)
+        return;
+
+    g_array_free (formula->steps, TRUE);
+    g_ptr_array_free (formula->var_names, TRUE);
+    g_free (formula);
+}
+
+guint
+gnc_exp_formula_get_num_vars (const GncExpFormula *formula)
+{
+    g_return_val_if_fail (formula != NULL, 0);
+
+    return formula->var_names->len;
+}
+
+const char *
+gnc_exp_formula_get_var_name (const GncExpFormula *formula, guint slot)
+{
+    g_return_val_if_fail (formula != NULL, NULL);
+    g_return_val_if_fail (slot < formula->var_names->len, NULL);
+
+    return g_ptr_array_index (formula->var_names, slot);
+}
+
+static gnc_numeric
+formula_var_value (const GncExpFormula *formula,
+                   const gnc_numeric * const *bindings,
+                   guint slot)
+{
+    ParserNum *pnum;
+
+    if (bindings && bindings[slot])
+        return *bindings[slot];
+
+    pnum = g_hash_table_lookup (variable_bindings,
+                                g_ptr_array_index (formula->var_names, slot));
+    if (pnum)
+        return pnum->value;
+
+    return gnc_numeric_zero ();
+}
+
+gboolean
+gnc_exp_formula_eval (const GncExpFormula *formula,
+                      const gnc_numeric * const *bindings,
+                      gnc_numeric *value_p)
+{
+    gnc_numeric stack[FORMULA_STACK_SIZE];
+    gnc_numeric value;
+    guint depth = 0;
+    guint i;
+
+    g_return_val_if_fail (formula != NULL, FALSE);
+
+    if (!parser_inited)
+        gnc_exp_parser_real_init ( (bindings == NULL) );
+
+    for (i = 0; i < formula->steps->len; i++)
+    {
+        const FormulaStep *step = &g_array_index (formula->steps, FormulaStep, i);
+
+        switch (step->op)
+        {
+        case FORMULA_NUMBER:
+            value = step->value;
+            break;
+        case FORMULA_VARIABLE:
+            value = formula_var_value (formula, bindings, step->slot);
+            break;
+        case ADD_OP:
+            value = gnc_numeric_add (stack[depth - 2], stack[depth - 1],
+                                     GNC_DENOM_AUTO, GNC_HOW_DENOM_EXACT);
+            depth -= 2;
+            break;
+        case SUB_OP:
+            value = gnc_numeric_sub (stack[depth - 2], stack[depth - 1],
+                                     GNC_DENOM_AUTO, GNC_HOW_DENOM_EXACT);
+            depth -= 2;
+            break;
+        case DIV_OP:
+            value = gnc_numeric_div (stack[depth - 2], stack[depth - 1],
+                                     GNC_DENOM_AUTO, GNC_HOW_DENOM_EXACT);
+            depth -= 2;
+            break;
+        case MUL_OP:
+        default:
+            value = gnc_numeric_mul (stack[depth - 2], stack[depth - 1],
+                                     GNC_DENOM_AUTO, GNC_HOW_DENOM_EXACT);
+            depth -= 2;
+            break;
+        }
+
+        if (step->negate)
+            value = gnc_numeric_neg (value);
+
+        stack[depth++] = value;
+    }
+
+    if (gnc_numeric_check (stack[0]))
+    {
+        last_error = NUMERIC_ERROR;
+        return FALSE;
+    }
+
+    if (value_p)
+        *value_p = gnc_numeric_reduce (stack[0]);
+
+    last_error = PARSER_NO_ERROR;
+
+    return TRUE;
+}
+
 const char *
 gnc_exp_parser_error_string (void)
 {
@@ -89,6 +89,52 @@ gboolean gnc_exp_parser_parse_separate_vars (const char * expression,
         char **error_loc_p,
         GHashTable *varHash );
 
+/**
+ * A formula compiled by gnc_exp_parser_compile, for expressions which
+ * are evaluated many times with different variable values, like the
+ * formulas of Scheduled Transaction template splits.
+ **/
+typedef struct GncExpFormula GncExpFormula;
+
+/**
+ * Compile the given expression into a form that can be evaluated
+ * without parsing it again.  Each variable in the expression gets a
+ * slot, numbered in the order the variables appear.
+ *
+ * Only plain arithmetic on numbers and variables is compiled.  If the
+ * expression assigns variables, calls functions or doesn't parse,
+ * NULL is returned and the expression has to be evaluated with
+ * gnc_exp_parser_parse_separate_vars.
+ **/
+GncExpFormula *gnc_exp_parser_compile (const char *expression);
+
+/* Free a formula returned by gnc_exp_parser_compile. */
+void gnc_exp_formula_free (GncExpFormula *formula);
+
+/* Return the number of variable slots of the formula. */
+guint gnc_exp_formula_get_num_vars (const GncExpFormula *formula);
+
+/* Return the name of the variable in the given slot. */
+const char *gnc_exp_formula_get_var_name (const GncExpFormula *formula,
+                                          guint slot);
+
+/**
+ * Evaluate a compiled formula with the values bound to its variable
+ * slots.  bindings holds one pointer per slot; a slot without a value
+ * (or all of them, if bindings is NULL) takes the value of the parser
+ * variable of that name, or zero like in the parser.  This gives the
+ * same result as gnc_exp_parser_parse_separate_vars with a varHash
+ * holding the same values, or with a NULL varHash if bindings is NULL.
+ *
+ * If the evaluation succeeds, return TRUE and, if value_p is
+ * non-NULL, the value in *value_p.  Otherwise return FALSE and leave
+ * *value_p unchanged; gnc_exp_parser_error_string will describe the
+ * problem.
+ **/
+gboolean gnc_exp_formula_eval (const GncExpFormula *formula,
+                               const gnc_numeric * const *bindings,
+                               gnc_numeric *value_p);
+
 /* If the last parse returned FALSE, return an error string describing
  * the problem. Otherwise, return NULL. */
 const char * gnc_exp_parser_error_string (void);
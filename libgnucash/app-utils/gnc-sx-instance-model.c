@@ -93,6 +93,7 @@ static gint _get_vars_helper(Transaction *txn, void *var_hash_data);
 static GncSxVariable* gnc_sx_variable_new(gchar *name);
 
 static void _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer user_data, gpointer evt_data);
+static void _gnc_sx_instance_batch_handler(const QofEventBatchEntry *entries, guint n_entries, gpointer user_data);
 static gnc_commodity* get_transaction_currency(SxTxnCreationData *creation_data, SchedXaction *sx, Transaction *template_txn);
 /* ------------------------------------------------------------ */
 
@@ -489,6 +490,7 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
     GDate creation_end, remind_end;
     GDate cur_date;
     SXTmpStateData *temporal_state = gnc_sx_create_temporal_state(sx);
+    GList *states, *node;
 
     instances->sx = sx;
 
@@ -518,35 +520,30 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
         }
     }
 
-    /* to-create */
+    /* to-create and reminders */
     g_date_clear(&cur_date, 1);
     cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
     instances->next_instance_date = cur_date;
-    while (g_date_valid(&cur_date) && g_date_compare(&cur_date, &creation_end) <= 0)
+    states = gnc_sx_get_instance_states(sx, temporal_state,
+                                        g_date_compare(&remind_end, &creation_end) > 0
+                                        ? &remind_end : &creation_end);
+    for (node = states; node != NULL; node = node->next)
     {
+        SXTmpStateData *next_state = (SXTmpStateData*)node->data;
+        GncSxInstanceState state = SX_INSTANCE_STATE_TO_CREATE;
         GncSxInstance *inst;
         int seq_num;
-        seq_num = gnc_sx_get_instance_count(sx, temporal_state);
-        inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_TO_CREATE,
-                                   &cur_date, temporal_state, seq_num);
-        instlist = g_list_prepend (instlist, inst);
-        gnc_sx_incr_temporal_state(sx, temporal_state);
-        cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
-    }
 
-    /* reminders */
-    while (g_date_valid(&cur_date) &&
-           g_date_compare(&cur_date, &remind_end) <= 0)
-    {
-        GncSxInstance *inst;
-        int seq_num;
+        if (g_date_compare(&next_state->last_date, &creation_end) > 0)
+            state = SX_INSTANCE_STATE_REMINDER;
         seq_num = gnc_sx_get_instance_count(sx, temporal_state);
-        inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_REMINDER,
-                                   &cur_date, temporal_state, seq_num);
+        inst = gnc_sx_instance_new(instances, state, &next_state->last_date,
+                                   temporal_state, seq_num);
         instlist = g_list_prepend (instlist, inst);
-        gnc_sx_incr_temporal_state(sx, temporal_state);
-        cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
+        gnc_sx_destroy_temporal_state(temporal_state);
+        temporal_state = next_state;
     }
+    g_list_free (states);
 
     instances->instance_list = g_list_reverse (instlist);
 
@@ -733,7 +730,12 @@ gnc_sx_instance_model_init(GncSxInstanceModel *inst)
 {
     g_date_clear(&inst->range_end, 1);
     inst->sx_instance_list = NULL;
-    inst->qof_event_handler_id = qof_event_register_handler(_gnc_sx_instance_event_handler, inst);
+    /* The sx of an item added or removed event is in the event data, which
+     * batches don't keep. */
+    inst->qof_event_handler_id = qof_event_register_batch_handler(_gnc_sx_instance_event_handler,
+                                                                  _gnc_sx_instance_batch_handler,
+                                                                  GNC_EVENT_ITEM_ADDED | GNC_EVENT_ITEM_REMOVED,
+                                                                  inst);
 }
 
 static gint
@@ -744,6 +746,38 @@ _gnc_sx_instance_find_by_sx(GncSxInstances *in_list_instances, SchedXaction *sx_
     return -1;
 }
 
+static void
+_gnc_sx_instance_sx_modified(GncSxInstanceModel *instances, SchedXaction *sx)
+{
+    // only send `updated` if it's actually in the model
+    gboolean sx_is_in_model = (g_list_find_custom(instances->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx) != NULL);
+    if (sx_is_in_model)
+    {
+        if (instances->include_disabled || xaccSchedXactionGetEnabled(sx))
+        {
+            g_signal_emit_by_name(instances, "updated", (gpointer)sx);
+        }
+        else
+        {
+            /* the sx was enabled but is now disabled */
+            g_signal_emit_by_name(instances, "removing", (gpointer)sx);
+        }
+    }
+    else
+    {
+        /* determine if this is a legitimate SX or just a "one-off" / being created */
+        GList *all_sxes = gnc_book_get_schedxactions(gnc_get_current_book())->sx_list;
+        if (g_list_find(all_sxes, sx) && (!instances->include_disabled && xaccSchedXactionGetEnabled(sx)))
+        {
+            /* it's moved from disabled to enabled, add the instances */
+            instances->sx_instance_list
+                = g_list_append(instances->sx_instance_list,
+                                _gnc_sx_gen_instances((gpointer)sx, (gpointer) & instances->range_end));
+            g_signal_emit_by_name(instances, "added", (gpointer)sx);
+        }
+    }
+}
+
 static void
 _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer user_data, gpointer evt_data)
 {
@@ -759,40 +793,8 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
 
     if (GNC_IS_SX(ent))
     {
-        SchedXaction *sx;
-        gboolean sx_is_in_model = FALSE;
-
-        sx = GNC_SX(ent);
-        // only send `updated` if it's actually in the model
-        sx_is_in_model = (g_list_find_custom(instances->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx) != NULL);
         if (event_type & QOF_EVENT_MODIFY)
-        {
-            if (sx_is_in_model)
-            {
-                if (instances->include_disabled || xaccSchedXactionGetEnabled(sx))
-                {
-                    g_signal_emit_by_name(instances, "updated", (gpointer)sx);
-                }
-                else
-                {
-                    /* the sx was enabled but is now disabled */
-                    g_signal_emit_by_name(instances, "removing", (gpointer)sx);
-                }
-            }
-            else
-            {
-                /* determine if this is a legitimate SX or just a "one-off" / being created */
-                GList *all_sxes = gnc_book_get_schedxactions(gnc_get_current_book())->sx_list;
-                if (g_list_find(all_sxes, sx) && (!instances->include_disabled && xaccSchedXactionGetEnabled(sx)))
-                {
-                    /* it's moved from disabled to enabled, add the instances */
-                    instances->sx_instance_list
-                        = g_list_append(instances->sx_instance_list,
-                                        _gnc_sx_gen_instances((gpointer)sx, (gpointer) & instances->range_end));
-                    g_signal_emit_by_name(instances, "added", (gpointer)sx);
-                }
-            }
-        }
+            _gnc_sx_instance_sx_modified(instances, GNC_SX(ent));
         /* else { unsupported event type; ignore } */
     }
     else if (GNC_IS_SXES(ent))
@@ -827,6 +829,29 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
     }
 }
 
+/* An sx modified several times in a batch, like by creating its
+ * instances, is updated once. */
+static void
+_gnc_sx_instance_batch_handler(const QofEventBatchEntry *entries, guint n_entries, gpointer user_data)
+{
+    GncSxInstanceModel *instances = GNC_SX_INSTANCE_MODEL(user_data);
+    QofCollection *col = qof_book_get_collection(gnc_get_current_book(), GNC_ID_SCHEDXACTION);
+    guint i;
+
+    for (i = 0; i < n_entries; i++)
+    {
+        SchedXaction *sx;
+
+        if (g_strcmp0(entries[i].type, GNC_ID_SCHEDXACTION) != 0
+            || !(entries[i].event_mask & QOF_EVENT_MODIFY))
+            continue;
+
+        sx = GNC_SX(qof_collection_lookup_entity(col, &entries[i].guid));
+        if (sx)
+            _gnc_sx_instance_sx_modified(instances, sx);
+    }
+}
+
 typedef struct _HashListPair
 {
     GHashTable *hash;
@@ -1035,6 +1060,62 @@ _get_template_split_account(const SchedXaction* sx,
     return success;
 }
 
+/* The formulas of the template splits, compiled when they are first
+ * evaluated.  They are keyed by their text, so a template split whose
+ * formula is edited gets it compiled again.  Formulas which can't be
+ * compiled map to NULL and are left to the parser. */
+static GHashTable *sx_compiled_formulas = NULL;
+
+static GncExpFormula*
+_get_compiled_formula(const char *formula_str)
+{
+    gpointer formula;
+
+    if (sx_compiled_formulas == NULL)
+    {
+        sx_compiled_formulas =
+            g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                  (GDestroyNotify)gnc_exp_formula_free);
+    }
+
+    if (!g_hash_table_lookup_extended(sx_compiled_formulas, formula_str,
+                                      NULL, &formula))
+    {
+        formula = gnc_exp_parser_compile(formula_str);
+        g_hash_table_insert(sx_compiled_formulas, g_strdup(formula_str),
+                            formula);
+    }
+    return (GncExpFormula*)formula;
+}
+
+static gboolean
+_eval_compiled_formula(const GncExpFormula *formula,
+                       GHashTable *variable_bindings,
+                       gnc_numeric *numeric)
+{
+    const gnc_numeric **bindings = NULL;
+    guint num_vars, slot;
+    gboolean success;
+
+    if (variable_bindings)
+    {
+        num_vars = gnc_exp_formula_get_num_vars(formula);
+        /* One more, so formulas without variables don't get NULL. */
+        bindings = g_new0(const gnc_numeric*, num_vars + 1);
+        for (slot = 0; slot < num_vars; slot++)
+        {
+            GncSxVariable *var = g_hash_table_lookup(
+                variable_bindings, gnc_exp_formula_get_var_name(formula, slot));
+            if (var != NULL)
+                bindings[slot] = &var->value;
+        }
+    }
+
+    success = gnc_exp_formula_eval(formula, bindings, numeric);
+    g_free(bindings);
+    return success;
+}
+
 static void
 _get_sx_formula_value(const SchedXaction* sx,
 		      const Split *template_split,
@@ -1070,15 +1151,29 @@ _get_sx_formula_value(const SchedXaction* sx,
 
     if (formula_str != NULL && strlen(formula_str) != 0)
     {
+        GncExpFormula *formula = _get_compiled_formula(formula_str);
         GHashTable *parser_vars = NULL;
-        if (variable_bindings)
+        gboolean success;
+
+        if (formula != NULL)
         {
-            parser_vars = gnc_sx_instance_get_variables_for_parser(variable_bindings);
+            success = _eval_compiled_formula(formula, variable_bindings,
+                                             numeric);
+            if (!success)
+                parseErrorLoc = formula_str;
+        }
+        else
+        {
+            if (variable_bindings)
+            {
+                parser_vars = gnc_sx_instance_get_variables_for_parser(variable_bindings);
+            }
+            success = gnc_exp_parser_parse_separate_vars(formula_str,
+                                                         numeric,
+                                                         &parseErrorLoc,
+                                                         parser_vars);
         }
-        if (!gnc_exp_parser_parse_separate_vars(formula_str,
-                                                numeric,
-                                                &parseErrorLoc,
-                                                parser_vars))
+        if (!success)
         {
             gchar *err = N_("Error parsing SX [%s] key [%s]=formula [%s] at [%s]: %s.");
             REPORT_ERROR(creation_errors, err,
@@ -1407,6 +1502,8 @@ gnc_sx_instance_model_effect_change(GncSxInstanceModel *model,
         return;
     }
 
+    /* Update the sxes once they all have their transactions. */
+    qof_event_begin_batch();
     for (iter = model->sx_instance_list; iter != NULL; iter = iter->next)
     {
         GList *instance_iter;
@@ -1502,6 +1599,7 @@ gnc_sx_instance_model_effect_change(GncSxInstanceModel *model,
         gnc_sx_set_instance_count(instances->sx, instance_count);
         xaccSchedXactionSetRemOccur(instances->sx, remain_occur_count);
     }
+    qof_event_end_batch();
 }
 
 void
@@ -246,12 +246,100 @@ test_variable_expressions()
     success("variable found");
 }
 
+static void
+test_compiled_formulas (void)
+{
+    const char *formulas[] =
+    {
+        "42", "(42)", "-7 + 2", "1 - 2 * 3 + 4 - 5 * 6 * 7",
+        " (4 + 5 * 2) - 7 / 3", "--3 * -(1 + 2)", "22.32 * 2 + 16.8",
+        "a", "a * 12 + b / 3", "(a - b) * (a + b) / 7", "i * -0.5 + c",
+        NULL
+    };
+    gnc_numeric a = gnc_numeric_create (1234, 100);
+    gnc_numeric b = gnc_numeric_create (-7, 1);
+    gnc_numeric i = gnc_numeric_create (3, 1);
+    const char **formula_str;
+    GncExpFormula *formula;
+    gnc_numeric num;
+
+    for (formula_str = formulas; *formula_str; formula_str++)
+    {
+        GHashTable *vars = g_hash_table_new (g_str_hash, g_str_equal);
+        const gnc_numeric *bindings[3] = { NULL, NULL, NULL };
+        gnc_numeric expected, result;
+        gchar *errLoc = NULL;
+        guint slot;
+
+        g_hash_table_insert (vars, "a", &a);
+        g_hash_table_insert (vars, "b", &b);
+        g_hash_table_insert (vars, "i", &i);
+        do_test (gnc_exp_parser_parse_separate_vars (*formula_str, &expected,
+                                                     &errLoc, vars),
+                 "parse formula");
+
+        formula = gnc_exp_parser_compile (*formula_str);
+        do_test (formula != NULL, "compile formula");
+        if (!formula)
+            continue;
+
+        do_test (gnc_exp_formula_get_num_vars (formula) <= 3, "formula slots");
+        for (slot = 0; slot < gnc_exp_formula_get_num_vars (formula); slot++)
+        {
+            const char *name = gnc_exp_formula_get_var_name (formula, slot);
+            if (g_strcmp0 (name, "a") == 0)
+                bindings[slot] = &a;
+            else if (g_strcmp0 (name, "b") == 0)
+                bindings[slot] = &b;
+            else if (g_strcmp0 (name, "i") == 0)
+                bindings[slot] = &i;
+        }
+
+        result = gnc_numeric_error (-1);
+        do_test (gnc_exp_formula_eval (formula, bindings, &result),
+                 "evaluate formula");
+        do_test (gnc_numeric_equal (result, expected)
+                 && result.denom == expected.denom,
+                 "compiled formula gives the parser's value");
+
+        gnc_exp_formula_free (formula);
+        g_hash_table_destroy (vars);
+    }
+
+    formula = gnc_exp_parser_compile ("a * 2 + a");
+    do_test (formula && gnc_exp_formula_get_num_vars (formula) == 1,
+             "one slot per variable");
+    num = gnc_numeric_error (-1);
+    do_test (gnc_exp_formula_eval (formula, NULL, &num)
+             && gnc_numeric_zero_p (num), "unbound variables are zero");
+    gnc_exp_formula_free (formula);
+
+    formula = gnc_exp_parser_compile ("4 / (a - a)");
+    num = gnc_numeric_create (5, 1);
+    do_test (formula && !gnc_exp_formula_eval (formula, NULL, &num)
+             && gnc_numeric_equal (num, gnc_numeric_create (5, 1))
+             && gnc_exp_parser_error_string () != NULL,
+             "divide by zero");
+    gnc_exp_formula_free (formula);
+
+    do_test (gnc_exp_parser_compile ("(a = 42) + a") == NULL,
+             "assignments aren't compiled");
+    do_test (gnc_exp_parser_compile ("-a + 1") == NULL,
+             "negated variables aren't compiled");
+    do_test (gnc_exp_parser_compile ("plus( 1 : 2 )") == NULL,
+             "function calls aren't compiled");
+    do_test (gnc_exp_parser_compile ("1 +") == NULL,
+             "bad expressions aren't compiled");
+    success ("compiled formulas");
+}
+
 static void
 real_main (void *closure, int argc, char **argv)
 {
     /* set_should_print_success (TRUE); */
     test_parser();
     test_variable_expressions();
+    test_compiled_formulas();
     print_test_results();
     exit(get_rv());
 }
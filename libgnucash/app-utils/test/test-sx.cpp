@@ -339,6 +339,117 @@ test_auto_create_transactions(const char *name, void (*populate_sx)(SchedXaction
     remove_sx(one_sx);
 }
 
+static gint
+count_occurrences_by_stepping(SchedXaction *sx, const GDate *start, const GDate *end)
+{
+    SXTmpStateData *tsd = gnc_sx_create_temporal_state(sx);
+    gint count = 0;
+
+    while (TRUE)
+    {
+        gnc_sx_incr_temporal_state(sx, tsd);
+        if (!g_date_valid(&tsd->last_date) || g_date_compare(&tsd->last_date, end) > 0)
+            break;
+        if (xaccSchedXactionHasOccurDef(sx) && tsd->num_occur_rem < 0)
+            break;
+        if (g_date_compare(&tsd->last_date, start) >= 0)
+            ++count;
+    }
+    gnc_sx_destroy_temporal_state(tsd);
+    return count;
+}
+
+static gboolean
+check_occurrence_counts(SchedXaction *sx, const GDate *from)
+{
+    int i;
+
+    for (i = 0; i < 200; i++)
+    {
+        GDate start = *from, end;
+
+        g_date_add_days(&start, get_random_int_in_range(0, 400));
+        end = start;
+        g_date_add_days(&end, get_random_int_in_range(0, 120));
+        if (gnc_sx_get_num_occur_daterange(sx, &start, &end) !=
+            count_occurrences_by_stepping(sx, &start, &end))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static gboolean
+check_instance_states(SchedXaction *sx, const GDate *end)
+{
+    SXTmpStateData *tsd = gnc_sx_create_temporal_state(sx);
+    GList *states = gnc_sx_get_instance_states(sx, NULL, end);
+    gboolean ok = TRUE;
+    GList *node;
+
+    for (node = states; node && ok; node = node->next)
+    {
+        SXTmpStateData *state = (SXTmpStateData*)node->data;
+        GDate next = xaccSchedXactionGetNextInstance(sx, tsd);
+        GList *rest = gnc_sx_get_instance_states(sx, tsd, end);
+
+        ok = (g_date_compare(&next, &state->last_date) == 0 &&
+              g_list_length(rest) == g_list_length(node));
+        g_list_free_full(rest, (GDestroyNotify)gnc_sx_destroy_temporal_state);
+        gnc_sx_incr_temporal_state(sx, tsd);
+        ok = ok && state->num_inst == tsd->num_inst &&
+             state->num_occur_rem == tsd->num_occur_rem;
+    }
+    if (ok)
+    {
+        GDate next = xaccSchedXactionGetNextInstance(sx, tsd);
+        ok = !g_date_valid(&next) || g_date_compare(&next, end) > 0;
+    }
+    g_list_free_full(states, (GDestroyNotify)gnc_sx_destroy_temporal_state);
+    gnc_sx_destroy_temporal_state(tsd);
+    return ok;
+}
+
+static void
+test_occurrence_calendar()
+{
+    SchedXaction *sx;
+    GDate start, end, last;
+    GList *schedule = NULL;
+    Recurrence *r;
+
+    g_date_clear(&start, 1);
+    gnc_gdate_set_today(&start);
+    g_date_subtract_days(&start, 30);
+    end = start;
+    g_date_add_days(&end, 300);
+
+    sx = add_daily_sx("calendar", &start, NULL, NULL);
+    do_test(check_occurrence_counts(sx, &start), "daily counts");
+    do_test(check_instance_states(sx, &end), "daily instances");
+
+    /* Every change to the SX must drop what the calendar holds. */
+    r = g_new0(Recurrence, 1);
+    recurrenceSet(r, 1, PERIOD_MONTH, &start, WEEKEND_ADJ_BACK);
+    schedule = g_list_append(schedule, r);
+    gnc_sx_set_schedule(sx, schedule);
+    do_test(check_occurrence_counts(sx, &start), "monthly counts");
+    do_test(check_instance_states(sx, &end), "monthly instances");
+
+    last = start;
+    g_date_add_months(&last, 2);
+    xaccSchedXactionSetLastOccurDate(sx, &last);
+    xaccSchedXactionSetNumOccur(sx, 4);
+    do_test(check_occurrence_counts(sx, &start), "limited counts");
+    do_test(check_instance_states(sx, &end), "limited instances");
+
+    xaccSchedXactionSetEndDate(sx, &end);
+    xaccSchedXactionSetRemOccur(sx, 2);
+    do_test(check_occurrence_counts(sx, &start), "end date counts");
+    do_test(check_instance_states(sx, &end), "end date instances");
+
+    remove_sx(sx);
+}
+
 static void
 real_main(void *closure, int argc, char **argv)
 {
@@ -354,6 +465,7 @@ real_main(void *closure, int argc, char **argv)
     }
     test_basic();
     test_state_changes();
+    test_occurrence_calendar();
 
     test_auto_create_transactions("make_one_transaction", make_one_transaction, 1);
     test_auto_create_transactions("make_one_zero_transaction", make_one_zero_transaction, 1);
@@ -137,13 +137,18 @@ time64_to_dom_tree (const char* tag, const time64 time)
 {
     xmlNodePtr ret;
     g_return_val_if_fail (time != INT64_MAX, NULL);
-    auto date_str = GncDateTime(time).format_iso8601();
-    if (date_str.empty())
-        return NULL;
-    date_str += " +0000"; //Tack on a UTC offset to mollify GnuCash for Android
+    char buff[32];
+    auto len = GncDateTime::format_iso8601 (time, buff);
+    if (!len)
+    {
+        auto date_str = GncDateTime(time).format_iso8601();
+        if (date_str.empty() || date_str.size() >= sizeof(buff) - 6)
+            return NULL;
+        len = date_str.copy (buff, date_str.size());
+    }
+    strcpy (buff + len, " +0000"); //Tack on a UTC offset to mollify GnuCash for Android
     ret = xmlNewNode (NULL, BAD_CAST tag);
-    xmlNewTextChild (ret, NULL, BAD_CAST "ts:date",
-                     checked_char_cast (const_cast<char*>(date_str.c_str())));
+    xmlNewTextChild (ret, NULL, BAD_CAST "ts:date", checked_char_cast (buff));
     return ret;
 }
 
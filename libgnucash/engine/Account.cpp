@@ -43,11 +43,14 @@
 #include "gnc-pricedb.h"
 #include "qofinstance-p.h"
 #include "gnc-features.h"
+#include "gnc-numeric-accumulator.hpp"
 #include "guid.hpp"
 
 #include <numeric>
 #include <map>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 static QofLogModule log_module = GNC_MOD_ACCOUNT;
 
@@ -77,6 +80,10 @@ static const std::string KEY_BALANCE_LOWER_LIMIT_VALUE("lower-value");
 static const std::string KEY_BALANCE_INCLUDE_SUB_ACCTS("inlude-sub-accts");
 
 static gnc_numeric GetBalanceAsOfDate (Account *acc, time64 date, gboolean ignclosing);
+static void imap_bayes_model_invalidate (Account *acc);
+static void open_lot_index_invalidate (Account *acc);
+static void open_lot_index_add_lot (Account *acc, GNCLot *lot);
+static void open_lot_index_remove_lot (Account *acc, GNCLot *lot);
 
 using FinalProbabilityVec=std::vector<std::pair<std::string, int32_t>>;
 using ProbabilityVec=std::vector<std::pair<std::string, struct AccountProbability>>;
@@ -337,6 +344,10 @@ gnc_account_init(Account* acc)
 
     priv->splits = NULL;
     priv->sort_dirty = FALSE;
+    priv->splits_generation = 0;
+
+    priv->imap_bayes_model = nullptr;
+    priv->open_lot_index = nullptr;
 }
 
 static void
@@ -1366,6 +1377,7 @@ xaccFreeAccount (Account *acc)
         }
         g_list_free (priv->lots);
         priv->lots = NULL;
+        open_lot_index_invalidate (acc);
     }
 
     /* Next, clean up the splits */
@@ -1424,6 +1436,9 @@ xaccFreeAccount (Account *acc)
     priv->balance_dirty = FALSE;
     priv->sort_dirty = FALSE;
 
+    imap_bayes_model_invalidate (acc);
+    open_lot_index_invalidate (acc);
+
     /* qof_instance_release (&acc->inst); */
     g_object_unref(acc);
 }
@@ -1462,6 +1477,21 @@ static void acc_free (QofInstance *inst)
     xaccFreeAccount(acc);
 }
 
+/* Empty the split and lot lists of an account whose book is shutting
+ * down, leaving the splits and lots to the code that frees them. */
+static void
+account_forget_splits_and_lots (Account *acc)
+{
+    AccountPrivate *priv = GET_PRIVATE(acc);
+
+    g_list_free(priv->splits);
+    priv->splits = NULL;
+    priv->splits_generation++;
+    g_list_free(priv->lots);
+    priv->lots = NULL;
+    open_lot_index_invalidate (acc);
+}
+
 static void
 destroy_pending_splits_for_account(QofInstance *ent, gpointer acc)
 {
@@ -1500,9 +1530,14 @@ xaccAccountCommitEdit (Account *acc)
 
         book = qof_instance_get_book(acc);
 
-        /* If book is shutting down, just clear the split list.  The splits
-           themselves will be destroyed by the transaction code */
-        if (!qof_book_shutting_down(book))
+        /* If book is shutting down, just clear the split and lot lists.
+           The splits and lots themselves will be destroyed by the
+           transaction and lot code */
+        if (qof_book_shutting_down(book))
+        {
+            account_forget_splits_and_lots (acc);
+        }
+        else
         {
             slist = g_list_copy(priv->splits);
             for (lp = slist; lp; lp = lp->next)
@@ -1512,11 +1547,6 @@ xaccAccountCommitEdit (Account *acc)
             }
             g_list_free(slist);
         }
-        else
-        {
-            g_list_free(priv->splits);
-            priv->splits = NULL;
-        }
 
         /* It turns out there's a case where this assertion does not hold:
            When the user tries to delete an Imbalance account, while also
@@ -1537,9 +1567,10 @@ xaccAccountCommitEdit (Account *acc)
                 GNCLot *lot = static_cast<GNCLot*>(lp->data);
                 gnc_lot_destroy (lot);
             }
+            g_list_free(priv->lots);
+            priv->lots = NULL;
+            open_lot_index_invalidate (acc);
         }
-        g_list_free(priv->lots);
-        priv->lots = NULL;
 
         qof_instance_set_dirty(&acc->inst);
         qof_instance_decrease_editlevel(acc);
@@ -1950,6 +1981,7 @@ gnc_account_insert_split (Account *acc, Split *s)
         priv->splits = g_list_prepend(priv->splits, s);
         priv->sort_dirty = TRUE;
     }
+    priv->splits_generation++;
 
     //FIXME: find better event
     qof_event_gen (&acc->inst, QOF_EVENT_MODIFY, NULL);
@@ -1962,6 +1994,14 @@ gnc_account_insert_split (Account *acc, Split *s)
     return TRUE;
 }
 
+void
+gnc_account_forget_splits (Account *acc)
+{
+    g_return_if_fail(GNC_IS_ACCOUNT(acc));
+
+    account_forget_splits_and_lots (acc);
+}
+
 gboolean
 gnc_account_remove_split (Account *acc, Split *s)
 {
@@ -1977,6 +2017,7 @@ gnc_account_remove_split (Account *acc, Split *s)
         return FALSE;
 
     priv->splits = g_list_delete_link(priv->splits, node);
+    priv->splits_generation++;
     //FIXME: find better event type
     qof_event_gen(&acc->inst, QOF_EVENT_MODIFY, NULL);
     // And send the account-based event, too
@@ -2000,6 +2041,14 @@ xaccAccountSortSplits (Account *acc, gboolean force)
     priv->splits = g_list_sort(priv->splits, (GCompareFunc)xaccSplitOrder);
     priv->sort_dirty = FALSE;
     priv->balance_dirty = TRUE;
+    priv->splits_generation++;
+}
+
+guint
+gnc_account_get_splits_generation (const Account *acc)
+{
+    g_return_val_if_fail(GNC_IS_ACCOUNT(acc), 0);
+    return GET_PRIVATE(acc)->splits_generation;
 }
 
 static void
@@ -2121,6 +2170,7 @@ xaccAccountRemoveLot (Account *acc, GNCLot *lot)
 
     ENTER ("(acc=%p, lot=%p)", acc, lot);
     priv->lots = g_list_remove(priv->lots, lot);
+    open_lot_index_remove_lot (acc, lot);
     qof_event_gen (QOF_INSTANCE(lot), QOF_EVENT_REMOVE, NULL);
     qof_event_gen (&acc->inst, QOF_EVENT_MODIFY, NULL);
     LEAVE ("(acc=%p, lot=%p)", acc, lot);
@@ -2150,11 +2200,13 @@ xaccAccountInsertLot (Account *acc, GNCLot *lot)
         old_acc = lot_account;
         opriv = GET_PRIVATE(old_acc);
         opriv->lots = g_list_remove(opriv->lots, lot);
+        open_lot_index_remove_lot (old_acc, lot);
     }
 
     priv = GET_PRIVATE(acc);
     priv->lots = g_list_prepend(priv->lots, lot);
     gnc_lot_set_account(lot, acc);
+    open_lot_index_add_lot (acc, lot);
 
     /* Don't move the splits to the new account.  The caller will do this
      * if appropriate, and doing it here will not work if we are being
@@ -2167,6 +2219,167 @@ xaccAccountInsertLot (Account *acc, GNCLot *lot)
     LEAVE ("(acc=%p, lot=%p)", acc, lot);
 }
 
+/** An account's open lots, filed by the sign of their opening split's
+ * amount and the currency of its transaction, for finding the earliest
+ * or latest one without looking at every lot. Changed lots are queued in
+ * dirty and refiled on the next lookup.
+ */
+struct GncOpenLotIndex
+{
+    /* The opening split's posted date and the negated position of the
+     * lot in the account's lot list, counted from its tail, so that ties
+     * go to the lot nearest the head of the list. */
+    using Key = std::pair<time64, int64_t>;
+    using Bucket = std::map<Key, GNCLot*>;
+    struct Entry
+    {
+        Bucket *bucket;
+        Key key;
+    };
+
+    std::map<std::pair<bool, const gnc_commodity*>, Bucket> buckets;
+    std::unordered_map<GNCLot*, Entry> entries;
+    std::unordered_map<GNCLot*, int64_t> positions;
+    std::unordered_set<GNCLot*> dirty;
+    int64_t next_position;
+};
+
+static void
+open_lot_index_invalidate (Account *acc)
+{
+    auto priv = GET_PRIVATE (acc);
+    delete priv->open_lot_index;
+    priv->open_lot_index = nullptr;
+}
+
+static void
+open_lot_index_unfile (GncOpenLotIndex& index, GNCLot *lot)
+{
+    auto iter = index.entries.find (lot);
+    if (iter == index.entries.end ())
+        return;
+    iter->second.bucket->erase (iter->second.key);
+    index.entries.erase (iter);
+}
+
+/* The lot was inserted at the head of the account's lot list. */
+static void
+open_lot_index_add_lot (Account *acc, GNCLot *lot)
+{
+    auto index = GET_PRIVATE (acc)->open_lot_index;
+    if (!index)
+        return;
+    index->positions[lot] = index->next_position++;
+    index->dirty.insert (lot);
+}
+
+static void
+open_lot_index_remove_lot (Account *acc, GNCLot *lot)
+{
+    auto index = GET_PRIVATE (acc)->open_lot_index;
+    if (!index)
+        return;
+    open_lot_index_unfile (*index, lot);
+    index->positions.erase (lot);
+    index->dirty.erase (lot);
+}
+
+static void
+open_lot_index_file (GncOpenLotIndex& index, GNCLot *lot)
+{
+    open_lot_index_unfile (index, lot);
+    if (gnc_lot_is_closed (lot))
+        return;
+
+    auto split = gnc_lot_get_earliest_split (lot);
+    auto trans = xaccSplitGetParent (split);
+    if (!trans)
+        return;
+    auto amount = xaccSplitGetAmount (split);
+    if (gnc_numeric_zero_p (amount))
+        return;
+    /* Skip overfull lots, whose balance has the other sign. */
+    bool opening_positive = gnc_numeric_positive_p (amount);
+    if (opening_positive != static_cast<bool>(gnc_numeric_positive_p (gnc_lot_get_balance (lot))))
+        return;
+
+    auto& bucket = index.buckets[{opening_positive, xaccTransGetCurrency (trans)}];
+    GncOpenLotIndex::Key key {xaccTransRetDatePosted (trans), -index.positions[lot]};
+    bucket.emplace (key, lot);
+    index.entries[lot] = {&bucket, key};
+}
+
+static GncOpenLotIndex&
+get_open_lot_index (Account *acc)
+{
+    auto priv = GET_PRIVATE (acc);
+    if (!priv->open_lot_index)
+    {
+        auto index = new GncOpenLotIndex {};
+        int64_t position = g_list_length (priv->lots);
+        index->next_position = position + 1;
+        for (auto node = priv->lots; node; node = node->next, --position)
+        {
+            auto lot = static_cast<GNCLot*>(node->data);
+            index->positions[lot] = position;
+            index->dirty.insert (lot);
+        }
+        priv->open_lot_index = index;
+    }
+
+    auto& index = *priv->open_lot_index;
+    for (auto lot : index.dirty)
+        open_lot_index_file (index, lot);
+    index.dirty.clear ();
+    return index;
+}
+
+void
+gnc_account_lot_changed (Account *acc, GNCLot *lot)
+{
+    g_return_if_fail (GNC_IS_ACCOUNT (acc));
+    auto index = GET_PRIVATE (acc)->open_lot_index;
+    if (index && index->positions.count (lot))
+        index->dirty.insert (lot);
+}
+
+GNCLot *
+gnc_account_find_open_lot (Account *acc, gboolean opening_positive,
+                           const gnc_commodity *currency, gboolean latest)
+{
+    g_return_val_if_fail (GNC_IS_ACCOUNT (acc), nullptr);
+
+    auto& index = get_open_lot_index (acc);
+    const GncOpenLotIndex::Bucket::value_type *best = nullptr;
+    for (auto& [id, bucket] : index.buckets)
+    {
+        if (bucket.empty () || id.first != static_cast<bool>(opening_positive) ||
+            (currency && !gnc_commodity_equiv (currency, id.second)))
+            continue;
+
+        if (latest)
+        {
+            /* The first of the lots opened at the bucket's latest date. */
+            auto candidate = bucket.lower_bound ({bucket.rbegin ()->first.first, INT64_MIN});
+            if (candidate->first.first == INT64_MIN)
+                continue;
+            if (!best || candidate->first.first > best->first.first ||
+                (candidate->first.first == best->first.first &&
+                 candidate->first.second < best->first.second))
+                best = &*candidate;
+        }
+        else
+        {
+            auto candidate = bucket.begin ();
+            if (candidate->first.first == INT64_MAX)
+                continue;
+            if (!best || candidate->first < best->first)
+                best = &*candidate;
+        }
+    }
+    return best ? best->second : nullptr;
+}
+
 /********************************************************************\
 \********************************************************************/
 static void
@@ -2268,10 +2481,6 @@ void
 xaccAccountRecomputeBalance (Account * acc)
 {
     AccountPrivate *priv;
-    gnc_numeric  balance;
-    gnc_numeric  noclosing_balance;
-    gnc_numeric  cleared_balance;
-    gnc_numeric  reconciled_balance;
     GList *lp;
 
     if (NULL == acc) return;
@@ -2282,46 +2491,49 @@ xaccAccountRecomputeBalance (Account * acc)
     if (qof_instance_get_destroying(acc)) return;
     if (qof_book_shutting_down(qof_instance_get_book(acc))) return;
 
-    balance            = priv->starting_balance;
-    noclosing_balance  = priv->starting_noclosing_balance;
-    cleared_balance    = priv->starting_cleared_balance;
-    reconciled_balance = priv->starting_reconciled_balance;
+    /* The accumulators give the same results as gnc_numeric_add_fixed but
+     * skip the rational arithmetic when the amount is in the same units
+     * as the running balance, which is nearly always the case. */
+    GncNumericAccumulator balance{priv->starting_balance};
+    GncNumericAccumulator noclosing_balance{priv->starting_noclosing_balance};
+    GncNumericAccumulator cleared_balance{priv->starting_cleared_balance};
+    GncNumericAccumulator reconciled_balance{priv->starting_reconciled_balance};
 
     PINFO ("acct=%s starting baln=%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT,
-           priv->accountName, balance.num, balance.denom);
+           priv->accountName, priv->starting_balance.num,
+           priv->starting_balance.denom);
     for (lp = priv->splits; lp; lp = lp->next)
     {
         Split *split = (Split *) lp->data;
         gnc_numeric amt = xaccSplitGetAmount (split);
 
-        balance = gnc_numeric_add_fixed(balance, amt);
+        balance += amt;
 
         if (NREC != split->reconciled)
         {
-            cleared_balance = gnc_numeric_add_fixed(cleared_balance, amt);
+            cleared_balance += amt;
         }
 
         if (YREC == split->reconciled ||
                 FREC == split->reconciled)
         {
-            reconciled_balance =
-                gnc_numeric_add_fixed(reconciled_balance, amt);
+            reconciled_balance += amt;
         }
 
         if (!(xaccTransGetIsClosingTxn (split->parent)))
-            noclosing_balance = gnc_numeric_add_fixed(noclosing_balance, amt);
+            noclosing_balance += amt;
 
-        split->balance = balance;
-        split->noclosing_balance = noclosing_balance;
-        split->cleared_balance = cleared_balance;
-        split->reconciled_balance = reconciled_balance;
+        split->balance = balance.value();
+        split->noclosing_balance = noclosing_balance.value();
+        split->cleared_balance = cleared_balance.value();
+        split->reconciled_balance = reconciled_balance.value();
 
     }
 
-    priv->balance = balance;
-    priv->noclosing_balance = noclosing_balance;
-    priv->cleared_balance = cleared_balance;
-    priv->reconciled_balance = reconciled_balance;
+    priv->balance = balance.value();
+    priv->noclosing_balance = noclosing_balance.value();
+    priv->cleared_balance = cleared_balance.value();
+    priv->reconciled_balance = reconciled_balance.value();
     priv->balance_dirty = FALSE;
 }
 
@@ -3573,10 +3785,48 @@ xaccAccountGetNoclosingBalanceAsOfDate (Account *acc, time64 date)
     return GetBalanceAsOfDate (acc, date, TRUE);
 }
 
+void
+xaccAccountGetSplitsAtDates (Account *acc, size_t n_dates, const time64 *dates,
+                             Split **splits)
+{
+    g_return_if_fail (GNC_IS_ACCOUNT(acc));
+    g_return_if_fail (n_dates == 0 || (dates && splits));
+
+    xaccAccountSortSplits (acc, TRUE); /* just in case, normally a noop */
+    xaccAccountRecomputeBalance (acc); /* just in case, normally a noop */
+
+    Split *latest = nullptr;
+    GList *node = GET_PRIVATE(acc)->splits;
+    for (size_t i = 0; i < n_dates; i++)
+    {
+        for (; node; node = node->next)
+        {
+            auto split = static_cast<Split*>(node->data);
+            if (xaccTransGetDate (xaccSplitGetParent (split)) > dates[i])
+                break;
+            latest = split;
+        }
+        splits[i] = latest;
+    }
+}
+
+void
+xaccAccountGetBalancesAtDates (Account *acc, size_t n_dates, const time64 *dates,
+                               gnc_numeric *balances)
+{
+    g_return_if_fail (GNC_IS_ACCOUNT(acc));
+    g_return_if_fail (n_dates == 0 || (dates && balances));
+
+    std::vector<Split*> splits (n_dates);
+    xaccAccountGetSplitsAtDates (acc, n_dates, dates, splits.data());
+    for (size_t i = 0; i < n_dates; i++)
+        balances[i] = splits[i] ? xaccSplitGetBalance (splits[i]) : gnc_numeric_zero();
+}
+
 gnc_numeric
 xaccAccountGetReconciledBalanceAsOfDate (Account *acc, time64 date)
 {
-    gnc_numeric balance = gnc_numeric_zero();
+    GncNumericAccumulator balance;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
@@ -3585,10 +3835,10 @@ xaccAccountGetReconciledBalanceAsOfDate (Account *acc, time64 date)
         Split *split = (Split*) node->data;
         if ((xaccSplitGetReconcile (split) == YREC) &&
             (xaccSplitGetDateReconciled (split) <= date))
-            balance = gnc_numeric_add_fixed (balance, xaccSplitGetAmount (split));
+            balance += xaccSplitGetAmount (split);
     };
 
-    return balance;
+    return balance.value();
 }
 
 /*
@@ -5787,21 +6037,6 @@ struct AccountProbability
     double product_difference; /* product of (1-probabilities) */
 };
 
-struct AccountTokenCount
-{
-    std::string account_guid;
-    int64_t token_count; /** occurrences of a given token for this account_guid */
-};
-
-/** total_count and the token_count for a given account let us calculate the
- * probability of a given account with any single token
- */
-struct TokenAccountsInfo
-{
-    std::vector<AccountTokenCount> accounts;
-    int64_t total_count;
-};
-
 /** holds an account guid and its corresponding integer probability
   the integer probability is some factor of 10
  */
@@ -5811,17 +6046,6 @@ struct AccountInfo
     int32_t probability;
 };
 
-static void
-build_token_info(char const * suffix, KvpValue * value, TokenAccountsInfo & tokenInfo)
-{
-    if (strlen(suffix) == GUID_ENCODING_LENGTH)
-    {
-        tokenInfo.total_count += value->get<int64_t>();
-        /*By convention, the key ends with the account GUID.*/
-        tokenInfo.accounts.emplace_back(AccountTokenCount{std::string{suffix}, value->get<int64_t>()});
-    }
-}
-
 /** We scale the probability values by probability_factor.
   ie. with probability_factor of 100000, 10% would be
   0.10 * 100000 = 10000 */
@@ -5855,38 +6079,131 @@ highest_probability(FinalProbabilityVec const & probabilities)
     return ret;
 }
 
+/** The bayes entries of one token: the accounts it was seen with, in the
+ * same order as their KVP slots, and the total number of times it was seen.
+ */
+struct ImapTokenInfo
+{
+    std::vector<std::pair<size_t, int64_t>> accounts; /* account index, count */
+    int64_t total_count;
+};
+
+/** An account's import-map-bayes slots compiled for lookups. Looking up a
+ * token in the slots means walking all of them, and the matcher looks up
+ * every token of every imported transaction, so the slots are read once
+ * into a token table with the accounts numbered densely.
+ */
+struct GncImapBayesModel
+{
+    const KvpFrame *slots; /* the frame the model was built from */
+    std::vector<std::string> account_guids;
+    std::unordered_map<std::string, size_t> account_index;
+    std::unordered_map<std::string, ImapTokenInfo> tokens;
+
+    size_t get_account_index (const std::string& guid)
+    {
+        auto [iter, inserted] = account_index.emplace (guid, account_guids.size ());
+        if (inserted)
+            account_guids.push_back (guid);
+        return iter->second;
+    }
+
+    void set_count (const std::string& token, const std::string& guid, int64_t count)
+    {
+        auto& info = tokens[token];
+        auto index = get_account_index (guid);
+        auto& guids = account_guids;
+        auto iter = std::lower_bound (info.accounts.begin (), info.accounts.end (), guid,
+                                      [&guids](auto const& entry, std::string const& guid)
+                                      { return guids[entry.first] < guid; });
+        if (iter != info.accounts.end () && iter->first == index)
+        {
+            info.total_count += count - iter->second;
+            iter->second = count;
+        }
+        else
+        {
+            info.total_count += count;
+            info.accounts.insert (iter, {index, count});
+        }
+    }
+};
+
+static void
+build_imap_bayes_model (char const * suffix, KvpValue * value, GncImapBayesModel & model)
+{
+    /* By convention, the key is the token followed by the account GUID. */
+    auto len = strlen (suffix);
+    if (len <= GUID_ENCODING_LENGTH || suffix[len - GUID_ENCODING_LENGTH - 1] != '/')
+        return;
+    auto& info = model.tokens[std::string{suffix, len - GUID_ENCODING_LENGTH - 1}];
+    /* The slots are sorted, so each token's accounts are too. */
+    auto index = model.get_account_index (std::string{suffix + len - GUID_ENCODING_LENGTH});
+    info.total_count += value->get<int64_t>();
+    info.accounts.emplace_back (index, value->get<int64_t>());
+}
+
+static void
+imap_bayes_model_invalidate (Account *acc)
+{
+    auto priv = GET_PRIVATE (acc);
+    delete priv->imap_bayes_model;
+    priv->imap_bayes_model = nullptr;
+}
+
+static GncImapBayesModel&
+get_imap_bayes_model (Account *acc)
+{
+    auto priv = GET_PRIVATE (acc);
+    auto slots = qof_instance_get_slots (QOF_INSTANCE (acc));
+    if (priv->imap_bayes_model && priv->imap_bayes_model->slots != slots)
+        imap_bayes_model_invalidate (acc);
+    if (!priv->imap_bayes_model)
+    {
+        priv->imap_bayes_model = new GncImapBayesModel {slots, {}, {}, {}};
+        qof_instance_foreach_slot_prefix (QOF_INSTANCE (acc), IMAP_FRAME_BAYES "/",
+                                          &build_imap_bayes_model, *priv->imap_bayes_model);
+    }
+    return *priv->imap_bayes_model;
+}
+
 static ProbabilityVec
 get_first_pass_probabilities(Account* acc, GList * tokens)
 {
     ProbabilityVec ret;
+    auto& model = get_imap_bayes_model (acc);
+    /* Where each account is in ret, which lists them in the order they're
+     * first found in. */
+    std::vector<size_t> positions (model.account_guids.size (), SIZE_MAX);
     /* find the probability for each account that contains any of the tokens
      * in the input tokens list. */
     for (auto current_token = tokens; current_token; current_token = current_token->next)
     {
-        TokenAccountsInfo tokenInfo{};
-        auto path = std::string{IMAP_FRAME_BAYES "/"} + static_cast <char const *> (current_token->data) + "/";
-        qof_instance_foreach_slot_prefix (QOF_INSTANCE (acc), path, &build_token_info, tokenInfo);
-        for (auto const & current_account_token : tokenInfo.accounts)
+        if (!current_token->data)
+            continue;
+        auto token = model.tokens.find (static_cast <char const *> (current_token->data));
+        if (token == model.tokens.end ())
+            continue;
+        auto const & tokenInfo = token->second;
+        for (auto const & [account, token_count] : tokenInfo.accounts)
         {
-            auto item = std::find_if(ret.begin(), ret.end(), [&current_account_token]
-                (std::pair<std::string, AccountProbability> const & a) {
-                    return current_account_token.account_guid == a.first;
-                });
-            if (item != ret.end())
+            if (positions[account] != SIZE_MAX)
             {/* This account is already in the map */
-                item->second.product = ((double)current_account_token.token_count /
+                auto item = &ret[positions[account]];
+                item->second.product = ((double)token_count /
                                       (double)tokenInfo.total_count) * item->second.product;
-                item->second.product_difference = ((double)1 - ((double)current_account_token.token_count /
+                item->second.product_difference = ((double)1 - ((double)token_count /
                                               (double)tokenInfo.total_count)) * item->second.product_difference;
             }
             else
             {
                 /* add a new entry */
                 AccountProbability new_probability;
-                new_probability.product = ((double)current_account_token.token_count /
+                new_probability.product = ((double)token_count /
                                       (double)tokenInfo.total_count);
                 new_probability.product_difference = 1 - (new_probability.product);
-                ret.push_back({current_account_token.account_guid, std::move(new_probability)});
+                positions[account] = ret.size ();
+                ret.push_back({model.account_guids[account], std::move(new_probability)});
             }
         } /* for all accounts in tokenInfo */
     }
@@ -5993,6 +6310,7 @@ convert_imap_account_bayes_to_flat (Account *acc)
     if (!flat_imap.size ())
         return false;
     xaccAccountBeginEdit(acc);
+    imap_bayes_model_invalidate (acc);
     frame->set({IMAP_FRAME_BAYES}, nullptr);
     std::for_each(flat_imap.begin(), flat_imap.end(),
                   [&frame] (FlatKvpEntry const & entry) {
@@ -6085,7 +6403,7 @@ gnc_account_imap_find_account_bayes (Account *acc, GList *tokens)
     return account;
 }
 
-static void
+static int64_t
 change_imap_entry (Account *acc, std::string const & path, int64_t token_count)
 {
     GValue value = G_VALUE_INIT;
@@ -6118,6 +6436,7 @@ change_imap_entry (Account *acc, std::string const & path, int64_t token_count)
     qof_instance_set_path_kvp (QOF_INSTANCE (acc), &value, {path});
     gnc_features_set_used (gnc_account_get_book(acc), GNC_FEATURE_GUID_FLAT_BAYESIAN);
     g_value_unset (&value);
+    return token_count;
 }
 
 /** Updates the imap for a given account using a list of tokens */
@@ -6146,6 +6465,7 @@ gnc_account_imap_add_account_bayes (Account *acc,
     PINFO("account name: '%s'", account_fullname);
 
     guid_string = guid_to_string (xaccAccountGetGUID (added_acc));
+    auto& model = get_imap_bayes_model (acc);
 
     /* process each token in the list */
     for (current_token = g_list_first(tokens); current_token;
@@ -6162,7 +6482,8 @@ gnc_account_imap_add_account_bayes (Account *acc,
         PINFO("adding token '%s'", (char*)current_token->data);
         auto path = std::string {IMAP_FRAME_BAYES} + '/' + static_cast<char*>(current_token->data) + '/' + guid_string;
         /* change the imap entry for the account */
-        change_imap_entry (acc, path, token_count);
+        token_count = change_imap_entry (acc, path, token_count);
+        model.set_count (static_cast<char*>(current_token->data), guid_string, token_count);
     }
     /* free up the account fullname and guid string */
     qof_instance_set_dirty (QOF_INSTANCE (acc));
@@ -6308,6 +6629,7 @@ gnc_account_delete_map_entry (Account *acc, char *head, char *category,
         if (qof_instance_has_path_slot (QOF_INSTANCE (acc), path))
         {
             xaccAccountBeginEdit (acc);
+            imap_bayes_model_invalidate (acc);
             if (empty)
                 qof_instance_slot_path_delete_if_empty (QOF_INSTANCE(acc), path);
             else
@@ -6328,6 +6650,7 @@ gnc_account_delete_all_bayes_maps (Account *acc)
         auto slots = qof_instance_get_slots_prefix (QOF_INSTANCE (acc), IMAP_FRAME_BAYES);
         if (!slots.size()) return;
         xaccAccountBeginEdit (acc);
+        imap_bayes_model_invalidate (acc);
         for (auto const & entry : slots)
         {
              qof_instance_slot_path_delete (QOF_INSTANCE (acc), {entry.first});
@@ -568,6 +568,31 @@ typedef enum
     /** Get the reconciled balance of the account at the end of the day of the date specified. */
     gnc_numeric xaccAccountGetReconciledBalanceAsOfDate (Account *account, time64 date);
 
+    /** Find the last split posted at or before each of the dates in a
+     *  single pass over the account's splits. The running balances cached
+     *  in that split (xaccSplitGetBalance, xaccSplitGetNoclosingBalance...)
+     *  are the account's balances at that date.
+     *
+     *  @param account The account
+     *  @param n_dates The number of dates
+     *  @param dates The dates, sorted in ascending order
+     *  @param splits Array of n_dates receiving the splits, NULL for dates
+     *         before the account's first split.
+     */
+    void xaccAccountGetSplitsAtDates (Account *account, size_t n_dates,
+                                      const time64 *dates, Split **splits);
+
+    /** Get the balance of the account at each of the dates, including the
+     *  splits posted at the date itself, in a single pass over its splits.
+     *
+     *  @param account The account
+     *  @param n_dates The number of dates
+     *  @param dates The dates, sorted in ascending order
+     *  @param balances Array of n_dates receiving the balances
+     */
+    void xaccAccountGetBalancesAtDates (Account *account, size_t n_dates,
+                                        const time64 *dates, gnc_numeric *balances);
+
     /* These two functions convert a given balance from one commodity to
        another.  The account argument is only used to get the Book, and
        may have nothing to do with the supplied balance.  Likewise, the
@@ -62,6 +62,11 @@ typedef enum
     True
 } TriState;
 
+/* The bayesian import map compiled for lookups, see Account.cpp. */
+typedef struct GncImapBayesModel GncImapBayesModel;
+/* The account's open lots ordered for the lot finders, see Account.cpp. */
+typedef struct GncOpenLotIndex GncOpenLotIndex;
+
 /** \struct Account */
 typedef struct AccountPrivate
 {
@@ -131,6 +136,7 @@ typedef struct AccountPrivate
 
     GList *splits;              /* list of split pointers */
     gboolean sort_dirty;        /* sort order of splits is bad */
+    guint splits_generation;    /* changed whenever splits is modified */
 
     LotList   *lots;		/* list of lot pointers */
     GNCPolicy *policy;		/* Cached pointer to policy method */
@@ -150,6 +156,14 @@ typedef struct AccountPrivate
      * account tree. */
     short mark;
     gboolean defer_bal_computation;
+
+    /* Built from the import-map-bayes slots on the first bayesian
+     * lookup and kept up to date by gnc_account_imap_add_account_bayes. */
+    GncImapBayesModel *imap_bayes_model;
+
+    /* Built by the first gnc_account_find_open_lot and kept up to date
+     * as lots are inserted, removed and changed. */
+    GncOpenLotIndex *open_lot_index;
 } AccountPrivate;
 
 struct account_s
@@ -165,6 +179,30 @@ void xaccAccountSetGUID (Account *account, const GncGUID *guid);
 /* Register Accounts with the engine */
 gboolean xaccAccountRegister (void);
 
+/* Return a counter that changes whenever a split is added to or removed
+ * from the account or its splits are sorted, so holders of a position in
+ * the list returned by xaccAccountGetSplitList know it's still valid. */
+guint gnc_account_get_splits_generation (const Account *acc);
+
+/* Empty the account's split and lot lists without touching the splits
+ * or lots. Only for the transaction code, which frees all the splits of a
+ * book that is shutting down without unlinking them one by one. */
+void gnc_account_forget_splits (Account *acc);
+
+/* Tell the account that the balance, splits or closed state of one of its
+ * lots has changed, so it has to be refiled in the open lot index. */
+void gnc_account_lot_changed (Account *acc, GNCLot *lot);
+
+/* Find the open lot of acc whose opening split's amount has the sign
+ * given by opening_positive and, if currency isn't NULL, whose opening
+ * transaction is in currency. Lots whose balance has the other sign than
+ * their opening split are skipped. Of the matching lots the one with the
+ * earliest opening date is returned, or the latest if latest is TRUE;
+ * ties go to the lot inserted into the account last. */
+GNCLot *gnc_account_find_open_lot (Account *acc, gboolean opening_positive,
+                                   const gnc_commodity *currency,
+                                   gboolean latest);
+
 /* Structure for accessing static functions for testing */
 typedef struct
 {
@@ -61,6 +61,8 @@ enum
     PROP_TEMPLATE_ACCOUNT		/* Table */
 };
 
+static void sx_calendar_clear (SchedXaction *sx);
+
 /* GObject initialization */
 G_DEFINE_TYPE(SchedXaction, gnc_schedxaction, QOF_TYPE_INSTANCE)
 
@@ -81,6 +83,8 @@ gnc_schedxaction_init(SchedXaction* sx)
     sx->advanceRemindDays = 0;
     sx->instance_num = 0;
     sx->deferredList = NULL;
+    sx->calendar = NULL;
+    sx->calendar_complete = FALSE;
 }
 
 static void
@@ -493,10 +497,12 @@ xaccSchedXactionFree( SchedXaction *sx )
 
     /*
      * we have to delete the transactions in the
-     * template account ourselves
+     * template account ourselves, unless the whole book is going
+     * away and the transaction code frees them
      */
 
-    delete_template_trans( sx );
+    if (!qof_book_shutting_down (qof_instance_get_book (sx)))
+        delete_template_trans( sx );
 
     xaccAccountBeginEdit( sx->template_acct );
     xaccAccountDestroy( sx->template_acct );
@@ -515,6 +521,8 @@ xaccSchedXactionFree( SchedXaction *sx )
     /* a GList of Recurrences */
     g_list_free_full (sx->schedule, g_free);
 
+    sx_calendar_clear (sx);
+
     /* qof_instance_release (&sx->inst); */
     g_object_unref( sx );
 }
@@ -524,6 +532,7 @@ xaccSchedXactionFree( SchedXaction *sx )
 void
 gnc_sx_begin_edit (SchedXaction *sx)
 {
+    sx_calendar_clear (sx);
     qof_begin_edit (&sx->inst);
 }
 
@@ -546,6 +555,7 @@ static void commit_done(QofInstance *inst)
 void
 gnc_sx_commit_edit (SchedXaction *sx)
 {
+    sx_calendar_clear (sx);
     if (!qof_commit_edit (QOF_INSTANCE(sx))) return;
     qof_commit_edit_part2 (&sx->inst, commit_err, commit_done, sx_free);
 }
@@ -768,11 +778,76 @@ xaccSchedXactionSetRemOccur(SchedXaction *sx, gint num_remain)
     }
 }
 
+/* ============================================================ */
+/* The occurrence calendar */
+
+static void
+sx_calendar_clear (SchedXaction *sx)
+{
+    if (sx->calendar)
+        g_array_free (sx->calendar, TRUE);
+    sx->calendar = NULL;
+    sx->calendar_complete = FALSE;
+}
+
+/* Extend the calendar of the SX until it holds its first occurrence
+ * after end_date, or its last one. */
+static GArray *
+sx_calendar_extend (const SchedXaction *sx, const GDate *end_date)
+{
+    /* The calendar is only a cache of what the SX computes. */
+    SchedXaction *cached = (SchedXaction*)sx;
+    SXTmpStateData state;
+
+    if (!cached->calendar)
+    {
+        SXTmpStateData *tsd = gnc_sx_create_temporal_state (sx);
+        cached->calendar = g_array_new (FALSE, FALSE, sizeof (SXTmpStateData));
+        g_array_append_val (cached->calendar, *tsd);
+        gnc_sx_destroy_temporal_state (tsd);
+    }
+
+    state = g_array_index (cached->calendar, SXTmpStateData,
+                           cached->calendar->len - 1);
+    while (!cached->calendar_complete &&
+           g_date_compare (&state.last_date, end_date) <= 0)
+    {
+        gnc_sx_incr_temporal_state (sx, &state);
+        if (g_date_valid (&state.last_date))
+            g_array_append_val (cached->calendar, state);
+        else
+            cached->calendar_complete = TRUE;
+    }
+    return cached->calendar;
+}
+
+/* Returns the index of the first occurrence in the calendar that falls
+ * on or after date, or strictly after it if after is TRUE.  The SX's own
+ * state at index 0 isn't an occurrence. */
+static guint
+sx_calendar_search (GArray *calendar, const GDate *date, gboolean after)
+{
+    guint lo = 1, hi = calendar->len;
+
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+        gint cmp = g_date_compare (&g_array_index (calendar, SXTmpStateData,
+                                                   mid).last_date, date);
+        if (cmp < 0 || (after && cmp == 0))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
 gint gnc_sx_get_num_occur_daterange(const SchedXaction *sx, const GDate* start_date, const GDate* end_date)
 {
-    gint result = 0;
-    SXTmpStateData *tmpState;
-    gboolean countFirstDate;
+    GArray *calendar;
+    guint first, last;
+
+    g_return_val_if_fail (g_date_valid (start_date) && g_date_valid (end_date), 0);
 
     /* SX still active? If not, return now. */
     if ((xaccSchedXactionHasOccurDef(sx)
@@ -780,67 +855,76 @@ gint gnc_sx_get_num_occur_daterange(const SchedXaction *sx, const GDate* start_d
             || (xaccSchedXactionHasEndDate(sx)
                 && g_date_compare(xaccSchedXactionGetEndDate(sx), start_date) < 0))
     {
-        return result;
+        return 0;
+    }
+
+    calendar = sx_calendar_extend (sx, end_date);
+    first = sx_calendar_search (calendar, start_date, FALSE);
+    last = sx_calendar_search (calendar, end_date, TRUE);
+
+    /* The schedule ignores the number of occurrences when the SX also
+     * has an end date, so stop counting at the last one here. */
+    if (xaccSchedXactionHasOccurDef(sx))
+    {
+        gint num_occur_rem = g_array_index (calendar, SXTmpStateData, 0).num_occur_rem;
+        last = MIN (last, (guint)num_occur_rem + 1);
     }
 
-    tmpState = gnc_sx_create_temporal_state (sx);
+    return last > first ? last - first : 0;
+}
+
+GList *
+gnc_sx_get_instance_states(const SchedXaction *sx,
+                           const SXTmpStateData *stateData,
+                           const GDate *end_date)
+{
+    GArray *calendar;
+    GList *states = NULL;
+    SXTmpStateData state;
+    guint i = 0;
+
+    g_return_val_if_fail (sx && end_date && g_date_valid (end_date), NULL);
 
-    /* Should we count the first valid date we encounter? Only if the
-     * SX has not yet occurred so far, or if its last valid date was
-     * before the start date. */
-    countFirstDate = !g_date_valid(&tmpState->last_date)
-                     || (g_date_compare(&tmpState->last_date, start_date) < 0);
+    calendar = sx_calendar_extend (sx, end_date);
 
-    /* No valid date? SX has never occurred so far. */
-    if (!g_date_valid(&tmpState->last_date))
+    if (stateData)
     {
-        /* SX has never occurred so far */
-        gnc_sx_incr_temporal_state (sx, tmpState);
-        if (xaccSchedXactionHasOccurDef(sx) && tmpState->num_occur_rem < 0)
+        const SXTmpStateData *first = &g_array_index (calendar, SXTmpStateData, 0);
+        const SXTmpStateData *found = NULL;
+
+        i = (guint)(stateData->num_inst - first->num_inst);
+        if (stateData->num_inst >= first->num_inst && i < calendar->len)
         {
-            gnc_sx_destroy_temporal_state (tmpState);
-            return result;
+            found = &g_array_index (calendar, SXTmpStateData, i);
+            if (g_date_compare (&found->last_date, &stateData->last_date) != 0 ||
+                found->num_occur_rem != stateData->num_occur_rem)
+                found = NULL;
         }
-    }
 
-    /* Increase the tmpState until we are in our interval of
-     * interest. Only calculate anything if the sx hasn't already
-     * ended. */
-    while (g_date_compare(&tmpState->last_date, start_date) < 0)
-    {
-        gnc_sx_incr_temporal_state (sx, tmpState);
-        if (xaccSchedXactionHasOccurDef(sx) && tmpState->num_occur_rem < 0)
+        /* Not one of the coming occurrences, step through the schedule. */
+        if (!found)
         {
-            gnc_sx_destroy_temporal_state (tmpState);
-            return result;
+            state = *stateData;
+            while (TRUE)
+            {
+                gnc_sx_incr_temporal_state (sx, &state);
+                if (!g_date_valid (&state.last_date) ||
+                    g_date_compare (&state.last_date, end_date) > 0)
+                    break;
+                states = g_list_prepend (states, gnc_sx_clone_temporal_state (&state));
+            }
+            return g_list_reverse (states);
         }
     }
 
-    /* Now we are in our interval of interest. Increment the
-     * occurrence date until we are beyond the end of our
-     * interval. Make sure to check for invalid dates here: It means
-     * the SX has ended. */
-    while (g_date_valid(&tmpState->last_date)
-            && (g_date_compare(&tmpState->last_date, end_date) <= 0)
-            && (!xaccSchedXactionHasEndDate(sx)
-                || g_date_compare(&tmpState->last_date, xaccSchedXactionGetEndDate(sx)) <= 0)
-            && (!xaccSchedXactionHasOccurDef(sx)
-                /* The >=0 (i.e. the ==) is important here, otherwise
-                 * we miss the last valid occurrence of a SX which is
-                 * limited by num_occur */
-                || tmpState->num_occur_rem >= 0))
+    for (i++; i < calendar->len; i++)
     {
-        ++result;
-        gnc_sx_incr_temporal_state (sx, tmpState);
+        SXTmpStateData *next = &g_array_index (calendar, SXTmpStateData, i);
+        if (g_date_compare (&next->last_date, end_date) > 0)
+            break;
+        states = g_list_prepend (states, gnc_sx_clone_temporal_state (next));
     }
-
-    /* If the first valid date shouldn't be counted, decrease the
-     * result number by one. */
-    if (!countFirstDate && result > 0)
-        --result;
-
-    gnc_sx_destroy_temporal_state (tmpState);
-    return result;
+    return g_list_reverse (states);
 }
 
 gboolean
@@ -120,6 +120,13 @@ struct _SchedXaction
     /** The list of deferred SX instances.  This list is of SXTmpStateData
      * instances.  */
     GList /* <SXTmpStateData*> */ *deferredList;
+
+    /** The temporal state of the SX followed by the state after each of
+     * its coming occurrences.  Filled in on demand and cleared whenever
+     * the SX is edited. */
+    GArray /* <SXTmpStateData> */ *calendar;
+    /** TRUE if the calendar holds the last occurrence of the SX. */
+    gboolean        calendar_complete;
 };
 
 struct _SchedXactionClass
@@ -201,6 +208,20 @@ void xaccSchedXactionSetRemOccur( SchedXaction *sx, gint numRemain );
  * in the given date range (inclusive). */
 gint gnc_sx_get_num_occur_daterange(const SchedXaction *sx, const GDate* start_date, const GDate* end_date);
 
+/** Returns the temporal states of the occurrences of the SX that follow
+ * stateData, or the SX's current state if stateData is NULL, and fall on
+ * or before end_date.  The last_date of each state is the date of its
+ * occurrence.  The states are looked up in a calendar the SX keeps of
+ * its coming occurrences, so repeated calls don't step through the
+ * schedule again.
+ *
+ * @return A GList<SXTmpStateData*>; the caller must destroy each state
+ * with gnc_sx_destroy_temporal_state() and free the list.
+ */
+GList *gnc_sx_get_instance_states(const SchedXaction *sx,
+                                  const SXTmpStateData *stateData,
+                                  const GDate *end_date);
+
 /** \brief Get the instance count.
  *
  *   This is incremented by one for every created
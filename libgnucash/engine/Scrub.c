@@ -60,8 +60,11 @@
 static QofLogModule log_module = G_LOG_DOMAIN;
 static gboolean abort_now = FALSE;
 static gint scrub_depth = 0;
+static const char *scrub_orphans = "orphans";
+static const char *scrub_imbalance = "imbalance";
 
 
+static bool split_scrub_or_dry_run (Split *split, bool dry_run);
 static Account* xaccScrubUtilityGetOrMakeAccount (Account *root,
                                                   gnc_commodity* currency,
                                                   const char* accname,
@@ -109,6 +112,185 @@ get_all_transactions (Account *account, bool descendants)
 
 /* ================================================================ */
 
+/* The transactions that an aborted scrub still has to repair, so that
+ * running the same scrub on the same accounts again continues where it
+ * was stopped instead of checking every transaction again. A book keeps
+ * the checkpoint of its last aborted scrub only, and only for as long
+ * as nothing else changes the book.
+ */
+typedef struct
+{
+    const char *kind;
+    GncGUID account;
+    bool descendants;
+    GArray *pending;  /* GUIDs of the transactions to repair, in order */
+    guint next;       /* index of the first one not repaired yet */
+    guint64 generation; /* of the book when the scrub stopped */
+} ScrubCheckpoint;
+
+#define SCRUB_CHECKPOINT "gnc-scrub-checkpoint"
+/* Account balances are recomputed once per batch of repairs. */
+#define SCRUB_BATCH_SIZE 100
+
+static void
+scrub_checkpoint_free (QofBook *book, gpointer key, gpointer data)
+{
+    ScrubCheckpoint *checkpoint = data;
+    if (!checkpoint) return;
+    g_array_free (checkpoint->pending, TRUE);
+    g_free (checkpoint);
+}
+
+static void
+scrub_checkpoint_drop (QofBook *book)
+{
+    scrub_checkpoint_free (book, SCRUB_CHECKPOINT,
+                           qof_book_get_data (book, SCRUB_CHECKPOINT));
+    qof_book_set_data (book, SCRUB_CHECKPOINT, NULL);
+}
+
+/* Returns the checkpoint left by an aborted run of this scrub, if any.
+ * A checkpoint is dropped once the book has been edited since the scrub
+ * stopped: the edits may have broken transactions it already repaired or
+ * checked. */
+static ScrubCheckpoint*
+scrub_checkpoint_get (Account *acc, const char *kind, bool descendants)
+{
+    QofBook *book = gnc_account_get_book (acc);
+    ScrubCheckpoint *checkpoint = qof_book_get_data (book, SCRUB_CHECKPOINT);
+    if (!checkpoint)
+        return NULL;
+
+    if (checkpoint->generation != qof_book_get_generation (book))
+    {
+        scrub_checkpoint_drop (book);
+        return NULL;
+    }
+
+    for (guint i = checkpoint->next; i < checkpoint->pending->len; i++)
+        if (!xaccTransLookup (&g_array_index (checkpoint->pending, GncGUID, i),
+                              book))
+        {
+            scrub_checkpoint_drop (book);
+            return NULL;
+        }
+
+    if (checkpoint->kind == kind && checkpoint->descendants == descendants &&
+        guid_equal (&checkpoint->account, xaccAccountGetGUID (acc)))
+        return checkpoint;
+    return NULL;
+}
+
+/* Runs needs_repair over the transactions of acc, read only, and
+ * returns the checkpoint listing the ones that need repairing, or NULL
+ * if the check was aborted. */
+static ScrubCheckpoint*
+scrub_checkpoint_new (Account *acc, const char *kind, bool descendants,
+                      bool (*needs_repair)(Transaction *trans),
+                      const char *message, QofPercentageFunc percentagefunc)
+{
+    GList *transactions = get_all_transactions (acc, descendants);
+    guint count = g_list_length (transactions), curr_trans = 0;
+    GArray *pending = g_array_new (FALSE, FALSE, sizeof (GncGUID));
+
+    for (GList *node = transactions; node; node = node->next, curr_trans++)
+    {
+        Transaction *trans = node->data;
+        if (curr_trans % 100 == 0)
+        {
+            char *progress_msg = g_strdup_printf (message, curr_trans, count);
+            (percentagefunc)(progress_msg, (100 * curr_trans) / count);
+            g_free (progress_msg);
+            if (abort_now) break;
+        }
+        if (needs_repair (trans))
+            g_array_append_val (pending, *xaccTransGetGUID (trans));
+    }
+    g_list_free (transactions);
+
+    if (abort_now)
+    {
+        g_array_free (pending, TRUE);
+        return NULL;
+    }
+
+    QofBook *book = gnc_account_get_book (acc);
+    scrub_checkpoint_drop (book);
+    ScrubCheckpoint *checkpoint = g_new0 (ScrubCheckpoint, 1);
+    checkpoint->kind = kind;
+    checkpoint->account = *xaccAccountGetGUID (acc);
+    checkpoint->descendants = descendants;
+    checkpoint->pending = pending;
+    checkpoint->generation = qof_book_get_generation (book);
+    qof_book_set_data_fin (book, SCRUB_CHECKPOINT, checkpoint,
+                           scrub_checkpoint_free);
+    return checkpoint;
+}
+
+static void
+defer_split_account (Split *split, GHashTable *deferred)
+{
+    Account *acc = xaccSplitGetAccount (split);
+    if (!acc || gnc_account_get_defer_bal_computation (acc)) return;
+    gnc_account_set_defer_bal_computation (acc, TRUE);
+    g_hash_table_add (deferred, acc);
+}
+
+/* Calls repair on the pending transactions of the checkpoint in batches,
+ * dropping the checkpoint once all of them are done. */
+static void
+scrub_checkpoint_repair (Account *acc, ScrubCheckpoint *checkpoint,
+                         void (*repair)(Transaction *trans, Account *root),
+                         Account *root, QofPercentageFunc percentagefunc)
+{
+    const char *message = _( "Repairing transaction: %u of %u");
+    QofBook *book = gnc_account_get_book (acc);
+    guint count = checkpoint->pending->len;
+
+    while (checkpoint->next < count)
+    {
+        char *progress_msg = g_strdup_printf (message, checkpoint->next, count);
+        (percentagefunc)(progress_msg, (100 * checkpoint->next) / count);
+        g_free (progress_msg);
+        if (abort_now) break;
+
+        guint end = MIN (checkpoint->next + SCRUB_BATCH_SIZE, count);
+        GHashTable *deferred = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+        for (; checkpoint->next < end; checkpoint->next++)
+        {
+            GncGUID *guid = &g_array_index (checkpoint->pending, GncGUID,
+                                            checkpoint->next);
+            Transaction *trans = xaccTransLookup (guid, book);
+            if (!trans) continue;
+
+            g_list_foreach (trans->splits, (GFunc)defer_split_account, deferred);
+            repair (trans, root);
+            /* Repair it again on resuming, it may have been stopped halfway. */
+            if (abort_now) break;
+        }
+
+        GHashTableIter iter;
+        gpointer deferred_acc;
+        g_hash_table_iter_init (&iter, deferred);
+        while (g_hash_table_iter_next (&iter, &deferred_acc, NULL))
+        {
+            gnc_account_set_defer_bal_computation (deferred_acc, FALSE);
+            xaccAccountRecomputeBalance (deferred_acc);
+        }
+        g_hash_table_destroy (deferred);
+    }
+    (percentagefunc)(NULL, -1.0);
+
+    if (checkpoint->next == count)
+        scrub_checkpoint_drop (book);
+    else
+        /* The repairs changed the book, but only where the scrub knows. */
+        checkpoint->generation = qof_book_get_generation (book);
+}
+
+/* ================================================================ */
+
 static void
 TransScrubOrphansFast (Transaction *trans, Account *root)
 {
@@ -137,34 +319,32 @@ TransScrubOrphansFast (Transaction *trans, Account *root)
     }
 }
 
+static bool
+trans_has_orphans (Transaction *trans)
+{
+    for (GList *node = trans->splits; node; node = node->next)
+        if (!((Split*)node->data)->acc)
+            return true;
+    return false;
+}
+
 static void
 AccountScrubOrphans (Account *acc, bool descendants, QofPercentageFunc percentagefunc)
 {
     if (!acc) return;
     scrub_depth++;
 
-    GList *transactions = get_all_transactions (acc, descendants);
-    gint total_trans = g_list_length (transactions);
-    const char *message = _( "Looking for orphans in transaction: %u of %u");
-    guint current_trans = 0;
-
-    for (GList *node = transactions; node; current_trans++, node = node->next)
-    {
-        Transaction *trans = node->data;
-        if (current_trans % 10 == 0)
-        {
-            char *progress_msg = g_strdup_printf (message, current_trans, total_trans);
-            (percentagefunc)(progress_msg, (100 * current_trans) / total_trans);
-            g_free (progress_msg);
-            if (abort_now) break;
-        }
-
-        TransScrubOrphansFast (trans, gnc_account_get_root (acc));
-    }
-    (percentagefunc)(NULL, -1.0);
+    ScrubCheckpoint *checkpoint = scrub_checkpoint_get (acc, scrub_orphans, descendants);
+    if (!checkpoint)
+        checkpoint = scrub_checkpoint_new
+            (acc, scrub_orphans, descendants, trans_has_orphans,
+             _( "Looking for orphans in transaction: %u of %u"), percentagefunc);
+    if (checkpoint)
+        scrub_checkpoint_repair (acc, checkpoint, TransScrubOrphansFast,
+                                 gnc_account_get_root (acc), percentagefunc);
+    else
+        (percentagefunc)(NULL, -1.0);
     scrub_depth--;
-
-    g_list_free (transactions);
 }
 
 void
@@ -355,46 +535,54 @@ split_scrub_or_dry_run (Split *split, bool dry_run)
 /* ================================================================ */
 
 
+/* Mirrors the checks of the scrubs run by TransScrubImbalanceFast, so
+ * that transactions it wouldn't change are skipped. */
+static bool
+trans_needs_imbalance_scrub (Transaction *trans)
+{
+    if (trans_has_orphans (trans))
+        return true;
+
+    gnc_commodity *currency = xaccTransGetCurrency (trans);
+    if (!currency || !gnc_commodity_is_currency (currency))
+        return true;
+
+    for (GList *node = trans->splits; node; node = node->next)
+        if (split_scrub_or_dry_run (node->data, true))
+            return true;
+
+    return !xaccTransIsBalanced (trans);
+}
+
+static void
+TransScrubImbalanceFast (Transaction *trans, Account *root)
+{
+    TransScrubOrphansFast (trans, root);
+    xaccTransScrubCurrency (trans);
+    xaccTransScrubImbalance (trans, root, NULL);
+}
+
 static void
 AccountScrubImbalance (Account *acc, bool descendants,
                        QofPercentageFunc percentagefunc)
 {
-    const char *message = _( "Looking for imbalances in transaction date %s: %u of %u");
-
     if (!acc) return;
 
     QofBook *book = qof_session_get_book (gnc_get_current_session ());
     Account *root = gnc_book_get_root_account (book);
-    GList *transactions = get_all_transactions (acc, descendants);
-    guint count = g_list_length (transactions), curr_trans = 0;
 
     scrub_depth++;
-    for (GList *node = transactions; node; node = node->next, curr_trans++)
-    {
-        Transaction *trans = node->data;
-        if (abort_now) break;
-
-        PINFO("Start processing transaction %d of %d", curr_trans + 1, count);
-
-        if (curr_trans % 10 == 0)
-        {
-            char *date = qof_print_date (xaccTransGetDate (trans));
-            char *progress_msg = g_strdup_printf (message, date, curr_trans, count);
-            (percentagefunc)(progress_msg, (100 * curr_trans) / count);
-            g_free (progress_msg);
-            g_free (date);
-        }
-
-        TransScrubOrphansFast (trans, root);
-        xaccTransScrubCurrency(trans);
-        xaccTransScrubImbalance (trans, root, NULL);
-
-        PINFO("Finished processing transaction %d of %d", curr_trans + 1, count);
-    }
-    (percentagefunc)(NULL, -1.0);
+    ScrubCheckpoint *checkpoint = scrub_checkpoint_get (acc, scrub_imbalance, descendants);
+    if (!checkpoint)
+        checkpoint = scrub_checkpoint_new
+            (acc, scrub_imbalance, descendants, trans_needs_imbalance_scrub,
+             _( "Looking for imbalances in transaction: %u of %u"), percentagefunc);
+    if (checkpoint)
+        scrub_checkpoint_repair (acc, checkpoint, TransScrubImbalanceFast,
+                                 root, percentagefunc);
+    else
+        (percentagefunc)(NULL, -1.0);
     scrub_depth--;
-
-    g_list_free (transactions);
 }
 
 void
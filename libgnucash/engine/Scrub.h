@@ -76,6 +76,13 @@ extern "C" {
 /** The gnc_set_abort_scrub () method causes a currently running scrub operation
  *    to stop, if abort is TRUE; gnc_set_abort_scrub(FALSE) must be called before
  *    any scrubbing operation.
+ *
+ *    The orphan and imbalance scrubs of accounts first check all
+ *    transactions without changing them and then repair the ones that
+ *    need it. If such a scrub is stopped while repairing, running it
+ *    again on the same account continues with the transactions that
+ *    were found but not repaired yet, without checking the others
+ *    again.
  */
 void gnc_set_abort_scrub (gboolean abort);
 gboolean gnc_get_abort_scrub (void);
@@ -1222,6 +1222,7 @@ qofSplitSetAmount (Split *split, gnc_numeric amt)
     {
         split->amount = amt;
     }
+    mark_split (split);
 }
 
 /* The amount of the split in the _account's_ commodity. */
@@ -1763,6 +1763,9 @@ xaccTransRollbackEdit (Transaction *trans)
         {
             Split *so = onode->data;
 
+            /* The amount and lot are restored behind the setters' backs,
+               so drop the cached balances of both lots. */
+            mark_split(s);
             xaccSplitRollbackEdit(s);
             SWAP_STR(s->action, so->action);
             SWAP_STR(s->memo, so->memo);
@@ -1774,6 +1777,7 @@ xaccTransRollbackEdit (Transaction *trans)
             s->gains_split = so->gains_split;
             //SET_GAINS_A_VDIRTY(s);
             s->date_reconciled = so->date_reconciled;
+            mark_split(s);
             qof_instance_mark_clean(QOF_INSTANCE(s));
         }
         else
@@ -3075,9 +3079,27 @@ destroy_tx_on_book_close(QofInstance *ent, gpointer data)
 {
     Transaction* tx = GNC_TRANSACTION(ent);
 
+    /* The whole book is going away, so don't bother with the edit
+     * cycle, the gains and transaction log handling, or unlinking
+     * each split from its account and lot: gnc_transaction_book_end
+     * has emptied the accounts' split lists and the lots are already
+     * gone. Just free the memory.
+     */
+    if (qof_book_shutting_down (qof_instance_get_book (tx)))
+    {
+        xaccFreeTransaction (tx);
+        return;
+    }
+
     xaccTransDestroy(tx);
 }
 
+static void
+forget_splits_on_book_close(QofInstance *ent, gpointer data)
+{
+    gnc_account_forget_splits (GNC_ACCOUNT(ent));
+}
+
 /** Handles book end - frees all transactions from the book
  *
  * @param book Book being closed
@@ -3087,6 +3109,15 @@ gnc_transaction_book_end(QofBook* book)
 {
     QofCollection *col;
 
+    /* The splits are freed without being removed from their accounts,
+     * so make sure that nothing torn down later, like the scheduled
+     * transactions' template accounts, finds them there. */
+    if (qof_book_shutting_down (book))
+    {
+        col = qof_book_get_collection(book, GNC_ID_ACCOUNT);
+        qof_collection_foreach(col, forget_splits_on_book_close, NULL);
+    }
+
     col = qof_book_get_collection(book, GNC_ID_TRANS);
     qof_collection_foreach(col, destroy_tx_on_book_close, NULL);
 }
@@ -0,0 +1,377 @@
+/********************************************************************\
+ * bench-engine.cpp -- Microbenchmarks for engine hot paths         *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+/* The books are built with the test-engine-stuff generators from a
+ * fixed seed, so a given size always produces the same book and runs
+ * can be compared with each other. The engine-benchmark target runs
+ * everything and writes the results as JSON; to run a subset use e.g.
+ *
+ *   bench-engine --benchmark_filter=Account \
+ *                --benchmark_out=engine.json --benchmark_out_format=json
+ */
+
+#include <benchmark/benchmark.h>
+#include <glib.h>
+
+#include <config.h>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "qof.h"
+#include "qofinstance-p.h"
+#include "cashobjects.h"
+#include "Account.h"
+#include "Query.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "TransLog.h"
+#include "gnc-commodity.h"
+#include "gnc-numeric-accumulator.hpp"
+#include "gnc-pricedb.h"
+#include "test-engine-stuff.h"
+
+static constexpr unsigned int bench_seed = 20230815;
+static constexpr time64 price_start = 946684800; // 2000-01-01
+static constexpr time64 seconds_per_day = 86400;
+
+struct BenchBook
+{
+    QofBook* book = nullptr;
+    Account* busiest = nullptr; // The account with the most splits.
+    size_t busiest_splits = 0;
+    std::vector<GncGUID> trans_guids;
+};
+
+/* Books are expensive to build so they're made once per size and kept
+ * until the program exits. */
+static std::map<int, BenchBook> bench_books;
+
+static const BenchBook&
+get_bench_book (int n_transactions)
+{
+    auto iter = bench_books.find (n_transactions);
+    if (iter != bench_books.end ())
+        return iter->second;
+
+    srand (bench_seed + n_transactions);
+    set_max_account_tree_depth (3);
+    set_max_accounts_per_level (6);
+
+    BenchBook bb;
+    bb.book = get_random_book ();
+    add_random_transactions_to_book (bb.book, n_transactions);
+
+    auto root = gnc_book_get_root_account (bb.book);
+    auto accounts = gnc_account_get_descendants (root);
+    for (auto node = accounts; node; node = g_list_next (node))
+    {
+        auto acc = static_cast<Account*>(node->data);
+        auto n_splits = g_list_length (xaccAccountGetSplitList (acc));
+        if (n_splits > bb.busiest_splits)
+        {
+            bb.busiest = acc;
+            bb.busiest_splits = n_splits;
+        }
+        for (auto snode = xaccAccountGetSplitList (acc); snode;
+             snode = g_list_next (snode))
+        {
+            auto split = static_cast<Split*>(snode->data);
+            auto trans = xaccSplitGetParent (split);
+            if (xaccTransGetSplit (trans, 0) == split)
+                bb.trans_guids.push_back (*qof_instance_get_guid (trans));
+        }
+    }
+    g_list_free (accounts);
+
+    return bench_books.emplace (n_transactions, std::move (bb)).first->second;
+}
+
+static void
+add_price_series (QofBook* book, gnc_commodity* commodity,
+                  gnc_commodity* currency, int n_prices)
+{
+    auto db = gnc_pricedb_get_db (book);
+    for (int i = 0; i < n_prices; ++i)
+    {
+        auto price = gnc_price_create (book);
+        gnc_price_begin_edit (price);
+        gnc_price_set_commodity (price, commodity);
+        gnc_price_set_currency (price, currency);
+        gnc_price_set_time64 (price, price_start + i * seconds_per_day);
+        gnc_price_set_source (price, PRICE_SOURCE_FQ);
+        gnc_price_set_typestr (price, PRICE_TYPE_LAST);
+        gnc_price_set_value (price, gnc_numeric_create (10000 + i % 977, 100));
+        gnc_price_commit_edit (price);
+        gnc_pricedb_add_price (db, price);
+        gnc_price_unref (price);
+    }
+}
+
+static void
+BM_AccountRecomputeBalance (benchmark::State& state)
+{
+    auto& bb = get_bench_book (state.range (0));
+    for (auto _ : state)
+    {
+        gnc_account_set_balance_dirty (bb.busiest);
+        xaccAccountRecomputeBalance (bb.busiest);
+    }
+    state.counters["splits"] = bb.busiest_splits;
+    state.SetItemsProcessed (state.iterations () * bb.busiest_splits);
+}
+BENCHMARK(BM_AccountRecomputeBalance)->Arg (1000)->Arg (10000)
+    ->Unit (benchmark::kMicrosecond);
+
+static void
+BM_AccountSortSplits (benchmark::State& state)
+{
+    auto& bb = get_bench_book (state.range (0));
+    for (auto _ : state)
+    {
+        gnc_account_set_sort_dirty (bb.busiest);
+        xaccAccountSortSplits (bb.busiest, TRUE);
+    }
+    state.counters["splits"] = bb.busiest_splits;
+    state.SetItemsProcessed (state.iterations () * bb.busiest_splits);
+}
+BENCHMARK(BM_AccountSortSplits)->Arg (1000)->Arg (10000)
+    ->Unit (benchmark::kMicrosecond);
+
+static void
+BM_PriceDBLookupNearest (benchmark::State& state)
+{
+    auto n_prices = state.range (0);
+    auto book = qof_book_new ();
+    auto table = gnc_commodity_table_get_table (book);
+    auto currency = gnc_commodity_table_lookup (table, GNC_COMMODITY_NS_CURRENCY,
+                                                "USD");
+    auto commodity = gnc_commodity_new (book, "Benchmark Stock", "BENCH",
+                                        "BNCH", "", 10000);
+    commodity = gnc_commodity_table_insert (table, commodity);
+    add_price_series (book, commodity, currency, n_prices);
+
+    auto db = gnc_pricedb_get_db (book);
+    int64_t i = 0;
+    for (auto _ : state)
+    {
+        /* Walk through the series at a stride coprime to its length so
+         * that every lookup is at a different date. */
+        auto t = price_start + (i++ * 7919 % n_prices) * seconds_per_day +
+            seconds_per_day / 3;
+        auto price = gnc_pricedb_lookup_nearest_in_time64 (db, commodity,
+                                                           currency, t);
+        benchmark::DoNotOptimize (price);
+        gnc_price_unref (price);
+    }
+    state.SetItemsProcessed (state.iterations ());
+    qof_book_destroy (book);
+}
+BENCHMARK(BM_PriceDBLookupNearest)->Arg (100)->Arg (10000)
+    ->Unit (benchmark::kMicrosecond);
+
+static void
+BM_QueryRunDateRange (benchmark::State& state)
+{
+    auto& bb = get_bench_book (state.range (0));
+    auto q = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (q, bb.book);
+    /* The generated dates are spread evenly over 1970-2038. */
+    xaccQueryAddDateMatchTT (q, TRUE, price_start,
+                             TRUE, price_start + 3652 * seconds_per_day,
+                             QOF_QUERY_AND);
+    size_t n_results = 0;
+    for (auto _ : state)
+        n_results = g_list_length (qof_query_run (q));
+    state.counters["results"] = n_results;
+    qof_query_destroy (q);
+}
+BENCHMARK(BM_QueryRunDateRange)->Arg (1000)->Arg (10000)
+    ->Unit (benchmark::kMillisecond);
+
+static void
+BM_QueryRunDescription (benchmark::State& state)
+{
+    auto& bb = get_bench_book (state.range (0));
+    auto q = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (q, bb.book);
+    xaccQueryAddDescriptionMatch (q, "a", FALSE, FALSE, QOF_COMPARE_CONTAINS,
+                                  QOF_QUERY_AND);
+    size_t n_results = 0;
+    for (auto _ : state)
+        n_results = g_list_length (qof_query_run (q));
+    state.counters["results"] = n_results;
+    qof_query_destroy (q);
+}
+BENCHMARK(BM_QueryRunDescription)->Arg (1000)->Arg (10000)
+    ->Unit (benchmark::kMillisecond);
+
+static void
+BM_KvpSet (benchmark::State& state)
+{
+    auto& bb = get_bench_book (1000);
+    GValue value = G_VALUE_INIT;
+    g_value_init (&value, G_TYPE_INT64);
+    int64_t i = 0;
+    for (auto _ : state)
+    {
+        g_value_set_int64 (&value, i);
+        qof_instance_set_path_kvp (QOF_INSTANCE (bb.busiest), &value,
+                                   {"benchmark", std::to_string (i++ % 64)});
+    }
+    g_value_unset (&value);
+    state.SetItemsProcessed (state.iterations ());
+}
+BENCHMARK(BM_KvpSet);
+
+static void
+BM_KvpGet (benchmark::State& state)
+{
+    auto& bb = get_bench_book (1000);
+    std::vector<std::string> keys;
+    GValue value = G_VALUE_INIT;
+    g_value_init (&value, G_TYPE_INT64);
+    for (int i = 0; i < 64; ++i)
+    {
+        keys.push_back (std::to_string (i));
+        g_value_set_int64 (&value, i);
+        qof_instance_set_path_kvp (QOF_INSTANCE (bb.busiest), &value,
+                                   {"benchmark", keys.back ()});
+    }
+    g_value_unset (&value);
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        GValue result = G_VALUE_INIT;
+        qof_instance_get_path_kvp (QOF_INSTANCE (bb.busiest), &result,
+                                   {"benchmark", keys[i++ % keys.size ()]});
+        benchmark::DoNotOptimize (g_value_get_int64 (&result));
+        g_value_unset (&result);
+    }
+    state.SetItemsProcessed (state.iterations ());
+}
+BENCHMARK(BM_KvpGet);
+
+static void
+BM_GuidLookup (benchmark::State& state)
+{
+    auto& bb = get_bench_book (state.range (0));
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto trans = xaccTransLookup (&bb.trans_guids[i++ % bb.trans_guids.size ()],
+                                      bb.book);
+        benchmark::DoNotOptimize (trans);
+    }
+    state.SetItemsProcessed (state.iterations ());
+}
+BENCHMARK(BM_GuidLookup)->Arg (1000)->Arg (10000);
+
+/* The gnc_numeric benchmarks use amounts in a common denominator, as
+ * almost all account amounts are. */
+static std::vector<gnc_numeric>
+make_amounts (size_t count)
+{
+    std::vector<gnc_numeric> amounts;
+    amounts.reserve (count);
+    srand (bench_seed);
+    for (size_t i = 0; i < count; ++i)
+        amounts.push_back (gnc_numeric_create (rand () % 2000001 - 1000000, 100));
+    return amounts;
+}
+
+static void
+BM_NumericAddFixed (benchmark::State& state)
+{
+    auto amounts = make_amounts (state.range (0));
+    for (auto _ : state)
+    {
+        auto sum = gnc_numeric_zero ();
+        for (auto amount : amounts)
+            sum = gnc_numeric_add_fixed (sum, amount);
+        benchmark::DoNotOptimize (sum);
+    }
+    state.SetItemsProcessed (state.iterations () * amounts.size ());
+}
+BENCHMARK(BM_NumericAddFixed)->Arg (10000);
+
+static void
+BM_NumericAccumulator (benchmark::State& state)
+{
+    auto amounts = make_amounts (state.range (0));
+    for (auto _ : state)
+    {
+        GncNumericAccumulator sum;
+        sum.add (amounts.data (), amounts.size ());
+        benchmark::DoNotOptimize (sum.value ());
+    }
+    state.SetItemsProcessed (state.iterations () * amounts.size ());
+}
+BENCHMARK(BM_NumericAccumulator)->Arg (10000);
+
+static void
+BM_NumericMulRound (benchmark::State& state)
+{
+    auto amounts = make_amounts (state.range (0));
+    auto rate = gnc_numeric_create (123456789, 100000000);
+    for (auto _ : state)
+        for (auto amount : amounts)
+            benchmark::DoNotOptimize (gnc_numeric_mul (amount, rate, 100,
+                                                       GNC_HOW_RND_ROUND_HALF_UP));
+    state.SetItemsProcessed (state.iterations () * amounts.size ());
+}
+BENCHMARK(BM_NumericMulRound)->Arg (10000);
+
+static void
+BM_NumericDivRound (benchmark::State& state)
+{
+    auto amounts = make_amounts (state.range (0));
+    auto rate = gnc_numeric_create (123456789, 100000000);
+    for (auto _ : state)
+        for (auto amount : amounts)
+            benchmark::DoNotOptimize (gnc_numeric_div (amount, rate, 100,
+                                                       GNC_HOW_RND_ROUND_HALF_UP));
+    state.SetItemsProcessed (state.iterations () * amounts.size ());
+}
+BENCHMARK(BM_NumericDivRound)->Arg (10000);
+
+int
+main (int argc, char** argv)
+{
+    benchmark::Initialize (&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments (argc, argv))
+        return 1;
+
+    qof_init ();
+    if (!cashobjects_register ())
+        return 1;
+    xaccLogDisable ();
+
+    benchmark::RunSpecifiedBenchmarks ();
+
+    for (auto& book : bench_books)
+        qof_book_destroy (book.second.book);
+    bench_books.clear ();
+    qof_close ();
+    return 0;
+}
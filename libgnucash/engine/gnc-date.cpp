@@ -114,6 +114,8 @@ gnc_localtime (const time64 *secs)
 struct tm*
 gnc_localtime_r (const time64 *secs, struct tm* time)
 {
+    if (GncDateTime::to_local_tm (*secs, *time))
+        return time;
     try
     {
         *time = static_cast<struct tm>(GncDateTime(*secs));
@@ -218,9 +220,12 @@ gnc_start_of_week (void)
 time64
 gnc_mktime (struct tm* time)
 {
+    normalize_struct_tm (time);
+    time64 secs;
+    if (GncDateTime::from_local_tm (*time, secs))
+        return secs;
     try
     {
-        normalize_struct_tm (time);
         GncDateTime gncdt(*time);
         *time = static_cast<struct tm>(gncdt);
         return static_cast<time64>(gncdt);
@@ -1116,6 +1121,9 @@ time64
 gnc_iso8601_to_time64_gmt(const char *cstr)
 {
     if (!cstr) return INT64_MAX;
+    time64 time;
+    if (GncDateTime::parse_iso8601 (cstr, time))
+        return time;
     try
     {
         GncDateTime gncdt(cstr);
@@ -1140,6 +1148,8 @@ char *
 gnc_time64_to_iso8601_buff (time64 time, char * buff)
 {
     if (! buff) return NULL;
+    if (auto len = GncDateTime::format_iso8601 (time, buff))
+        return buff + len;
     try
     {
         GncDateTime gncdt(time);
@@ -698,6 +698,307 @@ GncDateTime::timestamp()
     return GncDateTimeImpl::timestamp();
 }
 
+/* The iso8601 fast paths below handle years well inside the range boost
+ * accepts, so that an offset can't move them out of it. Anything else
+ * is left to the general code.
+ */
+static constexpr int iso8601_min_year = 1401;
+static constexpr int iso8601_max_year = 9998;
+static constexpr time64 secs_per_day = 86400;
+
+/* Days since 1970-01-01 of a proleptic Gregorian date. */
+static time64
+days_from_civil (int year, unsigned month, unsigned day) noexcept
+{
+    year -= month <= 2;
+    const time64 era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<time64>(doe) - 719468;
+}
+
+static void
+civil_from_days (time64 days, int& year, unsigned& month, unsigned& day) noexcept
+{
+    days += 719468;
+    const time64 era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(yoe + era * 400) + (month <= 2);
+}
+
+/* Reads count digits, returns false if there aren't as many. */
+static bool
+read_digits (const char*& str, int count, int& value) noexcept
+{
+    value = 0;
+    for (; count; --count, ++str)
+    {
+        if (*str < '0' || *str > '9')
+            return false;
+        value = value * 10 + (*str - '0');
+    }
+    return true;
+}
+
+static bool
+read_char (const char*& str, char c) noexcept
+{
+    if (*str != c)
+        return false;
+    ++str;
+    return true;
+}
+
+bool
+GncDateTime::parse_iso8601 (const char* str, time64& time) noexcept
+{
+    static const int month_days[] {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int year, month, day, hour, min, sec;
+    if (!str ||
+        !read_digits (str, 4, year) || !read_char (str, '-') ||
+        !read_digits (str, 2, month) || !read_char (str, '-') ||
+        !read_digits (str, 2, day) || !read_char (str, ' ') ||
+        !read_digits (str, 2, hour) || !read_char (str, ':') ||
+        !read_digits (str, 2, min) || !read_char (str, ':') ||
+        !read_digits (str, 2, sec))
+        return false;
+
+    if (year < iso8601_min_year || year > iso8601_max_year ||
+        month < 1 || month > 12 || day < 1 || day > month_days[month - 1] ||
+        hour > 23 || min > 59 || sec > 59)
+        return false;
+    if (month == 2 && day == 29 &&
+        (year % 4 || (year % 100 == 0 && year % 400)))
+        return false;
+
+    time64 offset = 0;
+    if (*str)
+    {
+        int off_hour, off_min;
+        if (!read_char (str, ' ') || (*str != '+' && *str != '-'))
+            return false;
+        auto sign = *str++ == '-' ? -1 : 1;
+        if (!read_digits (str, 2, off_hour) || !read_digits (str, 2, off_min) ||
+            *str || off_hour > 23 || off_min > 59)
+            return false;
+        offset = sign * (off_hour * 3600 + off_min * 60);
+    }
+
+    time = days_from_civil (year, month, day) * secs_per_day +
+        hour * 3600 + min * 60 + sec - offset;
+    return true;
+}
+
+size_t
+GncDateTime::format_iso8601 (time64 time, char* buff) noexcept
+{
+    auto days = time / secs_per_day;
+    auto secs = time % secs_per_day;
+    if (secs < 0)
+    {
+        secs += secs_per_day;
+        --days;
+    }
+
+    int year;
+    unsigned month, day;
+    civil_from_days (days, year, month, day);
+    if (year < iso8601_min_year || year > iso8601_max_year)
+        return 0;
+
+    auto put = [&buff](unsigned value, int width, char sep)
+    {
+        for (auto pos = width - 1; pos >= 0; --pos, value /= 10)
+            buff[pos] = '0' + value % 10;
+        buff += width;
+        *buff++ = sep;
+    };
+    put (year, 4, '-');
+    put (month, 2, '-');
+    put (day, 2, ' ');
+    put (secs / 3600, 2, ':');
+    put (secs / 60 % 60, 2, ':');
+    put (secs % 60, 2, '\0');
+    return 19;
+}
+
+/* Split a time into whole days and seconds into the day. */
+static void
+split_days (time64 time, time64& days, time64& secs) noexcept
+{
+    days = time / secs_per_day;
+    secs = time % secs_per_day;
+    if (secs < 0)
+    {
+        secs += secs_per_day;
+        --days;
+    }
+}
+
+enum class DstState { not_in_dst, in_dst, invalid, ambiguous };
+
+/* The same classification of a local time label as
+ * boost::date_time::dst_calculator::local_is_dst, including its
+ * truncation of the transition times to whole minutes.
+ */
+static DstState
+local_dst_state (time64 day, time64 secs, const TZ_YearOffsets& zone) noexcept
+{
+    time64 start_day, start_secs, end_day, end_secs;
+    split_days (zone.dst_start, start_day, start_secs);
+    split_days (zone.dst_end, end_day, end_secs);
+    auto length = zone.dst_offset / 60 * 60;
+
+    if (start_day < end_day)
+    {
+        if (day > start_day && day < end_day)
+            return DstState::in_dst;
+        if (day < start_day || day > end_day)
+            return DstState::not_in_dst;
+    }
+    else
+    {
+        if (day < start_day && day > end_day)
+            return DstState::not_in_dst;
+        if (day > start_day || day < end_day)
+            return DstState::in_dst;
+    }
+
+    if (day == start_day)
+    {
+        auto start = start_secs / 60 * 60;
+        if (secs < start)
+            return DstState::not_in_dst;
+        if (secs >= start + length)
+            return DstState::in_dst;
+        return DstState::invalid;
+    }
+    if (day == end_day)
+    {
+        auto end = end_secs / 60 * 60;
+        if (secs < end - length)
+            return DstState::in_dst;
+        if (secs >= end)
+            return DstState::not_in_dst;
+        return DstState::ambiguous;
+    }
+    return DstState::invalid;
+}
+
+/* Fill tm with the local time of utc in zone, the offsets for year. Fails
+ * if the zone observes DST and the standard local time falls in another
+ * year, because boost would then use that year's transitions.
+ */
+static bool
+local_tm_from_utc (time64 utc, int year, const TZ_YearOffsets& zone,
+                   struct tm& tm) noexcept
+{
+    time64 offset = zone.std_offset;
+    bool is_dst = false;
+    time64 days, secs;
+    int local_year;
+    unsigned month, day;
+
+    if (zone.has_dst)
+    {
+        auto local = utc + zone.std_offset;
+        split_days (local, days, secs);
+        civil_from_days (days, local_year, month, day);
+        if (local_year != year)
+            return false;
+        switch (local_dst_state (days, secs, zone))
+        {
+        case DstState::in_dst:
+            is_dst = true;
+            break;
+        case DstState::not_in_dst:
+            break;
+        case DstState::ambiguous:
+            is_dst = local + zone.dst_offset < zone.dst_end;
+            break;
+        case DstState::invalid:
+            is_dst = local >= zone.dst_start;
+            break;
+        }
+        if (is_dst)
+            offset += zone.dst_offset;
+    }
+
+    split_days (utc + offset, days, secs);
+    civil_from_days (days, local_year, month, day);
+    memset (&tm, 0, sizeof(tm));
+    tm.tm_sec = secs % 60;
+    tm.tm_min = secs / 60 % 60;
+    tm.tm_hour = secs / 3600;
+    tm.tm_mday = day;
+    tm.tm_mon = month - 1;
+    tm.tm_year = local_year - 1900;
+    tm.tm_wday = ((days + 4) % 7 + 7) % 7;
+    tm.tm_yday = days - days_from_civil (local_year, 1, 1);
+    tm.tm_isdst = is_dst;
+#if HAVE_STRUCT_TM_GMTOFF
+    tm.tm_gmtoff = offset;
+#endif
+    return true;
+}
+
+bool
+GncDateTime::to_local_tm (time64 time, struct tm& tm) noexcept
+{
+    time64 days, secs;
+    int year;
+    unsigned month, day;
+    split_days (time, days, secs);
+    civil_from_days (days, year, month, day);
+    auto zone = tzp->offsets (year);
+    return zone && local_tm_from_utc (time, year, *zone, tm);
+}
+
+bool
+GncDateTime::from_local_tm (struct tm& tm, time64& time) noexcept
+{
+    auto year = tm.tm_year + 1900;
+    auto zone = tzp->offsets (year);
+    if (!zone || tm.tm_mon < 0 || tm.tm_mon > 11 || tm.tm_mday < 1 ||
+        tm.tm_mday > 31 || tm.tm_hour < 0 || tm.tm_hour > 23 ||
+        tm.tm_min < 0 || tm.tm_min > 59 || tm.tm_sec < 0 || tm.tm_sec > 59)
+        return false;
+
+    auto days = days_from_civil (year, tm.tm_mon + 1, tm.tm_mday);
+    time64 secs = tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+    auto utc = days * secs_per_day + secs - zone->std_offset;
+    if (zone->has_dst)
+    {
+        /* Like LDT_from_date_time, move labels skipped or repeated by a
+         * transition an hour later and those repeated back again.
+         */
+        auto state = local_dst_state (days, secs, *zone);
+        if (state == DstState::invalid || state == DstState::ambiguous)
+        {
+            auto pushed = local_dst_state (days, secs + 3600, *zone);
+            if (pushed == DstState::invalid || pushed == DstState::ambiguous)
+                return false;
+            if (pushed == DstState::in_dst)
+                utc -= zone->dst_offset;
+            if (state == DstState::invalid)
+                utc += 3600;
+        }
+        else if (state == DstState::in_dst)
+            utc -= zone->dst_offset;
+    }
+
+    if (!local_tm_from_utc (utc, year, *zone, tm))
+        return false;
+    time = utc;
+    return true;
+}
+
 /* GncDate */
 GncDate::GncDate() : m_impl{new GncDateImpl} {}
 GncDate::GncDate(int year, int month, int day) :
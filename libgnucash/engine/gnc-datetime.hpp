@@ -156,7 +156,43 @@ public:
  *  @return a std::string in the format YYYYMMDDHHMMSS.
  */
     static std::string timestamp();
-    
+/** Parse a string in the exact form YYYY-MM-DD HH:MM:SS, optionally
+ *  followed by a space and a +HHMM or -HHMM UTC offset, as written by
+ *  the backends. Doesn't allocate or throw.
+ *  @param str The string to parse.
+ *  @param time Set to the time the string represents.
+ *  @return false if the string isn't in that form or its year is at
+ *  the limits of the supported range; use GncDateTime(std::string) for
+ *  it instead.
+ */
+    static bool parse_iso8601(const char* str, time64& time) noexcept;
+/** Format a time like format_iso8601() without allocating or throwing.
+ *  @param time The time to format.
+ *  @param buff A buffer of at least 20 chars for the NUL-terminated
+ *  string in the format YYYY-MM-DD HH:MM:SS.
+ *  @return The length of the string, 0 if the year is at the limits of
+ *  the supported range and format_iso8601() must be used instead.
+ */
+    static size_t format_iso8601(time64 time, char* buff) noexcept;
+/** Convert a time to a struct tm in the current timezone, as
+ *  static_cast<struct tm>(GncDateTime(time)) does but without allocating
+ *  or throwing.
+ *  @param time Seconds from the POSIX epoch.
+ *  @param tm Filled with the local time.
+ *  @return false if the time isn't covered by the timezone's table of
+ *  offsets; use GncDateTime(time) for it instead.
+ */
+    static bool to_local_tm(time64 time, struct tm& tm) noexcept;
+/** Convert a normalized struct tm in the current timezone to a time
+ *  like GncDateTime(tm) does, including its handling of times skipped
+ *  or repeated by DST transitions, without allocating or throwing.
+ *  @param tm The local time, refilled like to_local_tm() on success.
+ *  @param time Set to the seconds from the POSIX epoch.
+ *  @return false if the time isn't covered by the timezone's table of
+ *  offsets; use GncDateTime(tm) for it instead.
+ */
+    static bool from_local_tm(struct tm& tm, time64& time) noexcept;
+
 private:
     std::unique_ptr<GncDateTimeImpl> m_impl;
 };
@@ -95,6 +95,11 @@ typedef struct GNCLotPrivate
     signed char is_closed;
 #define LOT_CLOSED_UNKNOWN (-1)
 
+    /* The sum of the split amounts, valid if balance_valid is set. It's
+     * invalidated together with is_closed. */
+    gnc_numeric balance;
+    gboolean balance_valid;
+
     /* traversal marker, handy for preventing recursion */
     unsigned char marker;
 } GNCLotPrivate;
@@ -119,6 +124,7 @@ gnc_lot_init(GNCLot* lot)
     priv->splits = NULL;
     priv->cached_invoice = NULL;
     priv->is_closed = LOT_CLOSED_UNKNOWN;
+    priv->balance_valid = FALSE;
     priv->marker = 0;
 }
 
@@ -187,6 +193,8 @@ gnc_lot_set_property (GObject* object,
     {
     case PROP_IS_CLOSED:
         priv->is_closed = g_value_get_int(value);
+        if (priv->account)
+            gnc_account_lot_changed (priv->account, lot);
         break;
     case PROP_MARKER:
         priv->marker = g_value_get_int(value);
@@ -293,7 +301,10 @@ gnc_lot_free(GNCLot* lot)
     }
     g_list_free (priv->splits);
 
-    if (priv->account && !qof_instance_get_destroying(priv->account))
+    /* When the book is shutting down the account frees its whole lot
+     * list, so don't walk it once per lot. */
+    if (priv->account && !qof_instance_get_destroying(priv->account) &&
+        !qof_book_shutting_down (qof_instance_get_book (lot)))
         xaccAccountRemoveLot (priv->account, lot);
 
     priv->account = NULL;
@@ -418,6 +429,9 @@ gnc_lot_set_closed_unknown(GNCLot* lot)
     {
         priv = GET_PRIVATE(lot);
         priv->is_closed = LOT_CLOSED_UNKNOWN;
+        priv->balance_valid = FALSE;
+        if (priv->account)
+            gnc_account_lot_changed (priv->account, lot);
     }
 }
 
@@ -513,6 +527,8 @@ gnc_lot_get_balance (GNCLot *lot)
         priv->is_closed = FALSE;
         return zero;
     }
+    if (priv->balance_valid)
+        return priv->balance;
 
     /* Sum over splits; because they all belong to same account
      * they will have same denominator.
@@ -534,6 +550,8 @@ gnc_lot_get_balance (GNCLot *lot)
     {
         priv->is_closed = FALSE;
     }
+    priv->balance = baln;
+    priv->balance_valid = TRUE;
 
     return baln;
 }
@@ -635,7 +653,7 @@ gnc_lot_add_split (GNCLot *lot, Split *split)
     priv->splits = g_list_append (priv->splits, split);
 
     /* for recomputation of is-closed */
-    priv->is_closed = LOT_CLOSED_UNKNOWN;
+    gnc_lot_set_closed_unknown (lot);
     gnc_lot_commit_edit(lot);
 
     qof_event_gen (QOF_INSTANCE(lot), QOF_EVENT_MODIFY, NULL);
@@ -654,7 +672,7 @@ gnc_lot_remove_split (GNCLot *lot, Split *split)
     qof_instance_set_dirty(QOF_INSTANCE(lot));
     priv->splits = g_list_remove (priv->splits, split);
     xaccSplitSetLot(split, NULL);
-    priv->is_closed = LOT_CLOSED_UNKNOWN;   /* force an is-closed computation */
+    gnc_lot_set_closed_unknown (lot);   /* force an is-closed computation */
 
     if (NULL == priv->splits)
     {
@@ -0,0 +1,77 @@
+/********************************************************************
+ * gnc-numeric-accumulator.hpp - Fast summing of gnc_numerics       *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ *******************************************************************/
+
+#ifndef __GNC_NUMERIC_ACCUMULATOR_HPP__
+#define __GNC_NUMERIC_ACCUMULATOR_HPP__
+
+#include <cstdint>
+#include "gnc-numeric.h"
+
+/**@ingroup QOF
+ * @brief Running sum of gnc_numerics with a fast path for a common
+ * denominator.
+ *
+ * Adding with gnc_numeric_add_fixed() goes through GncNumeric and
+ * GncRational with GncInt128 overflow checks for every addition, but
+ * almost every amount added to an account balance is in the commodity's
+ * SCU, so it has the same denominator as the running sum. In that case
+ * the sum is just an int64_t addition; the accumulator does that and
+ * falls back to gnc_numeric_add_fixed() for everything else, including
+ * an int64_t overflow. The result is always identical to summing with
+ * gnc_numeric_add_fixed().
+ */
+class GncNumericAccumulator
+{
+public:
+    /** Start from zero. */
+    GncNumericAccumulator() noexcept : m_sum{0, 1} {}
+    /** Start from an existing value, e.g. an account's starting balance. */
+    explicit GncNumericAccumulator(gnc_numeric start) noexcept :
+        m_sum{start} {}
+
+    GncNumericAccumulator& operator+=(gnc_numeric amount) noexcept
+    {
+        int64_t num;
+        if (amount.denom > 0 && amount.denom == m_sum.denom &&
+            checked_add(m_sum.num, amount.num, num))
+            m_sum.num = num;
+        else
+            m_sum = gnc_numeric_add_fixed(m_sum, amount);
+        return *this;
+    }
+
+    /** @return The sum. It's a gnc_numeric error if an addition failed. */
+    gnc_numeric value() const noexcept { return m_sum; }
+
+private:
+    static bool checked_add(int64_t a, int64_t b, int64_t& result) noexcept
+    {
+        if ((b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b))
+            return false;
+        result = a + b;
+        return true;
+    }
+
+    gnc_numeric m_sum;
+};
+
+#endif //__GNC_NUMERIC_ACCUMULATOR_HPP__
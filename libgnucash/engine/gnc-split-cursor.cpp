@@ -0,0 +1,93 @@
+/********************************************************************\
+ * gnc-split-cursor.cpp -- Walk the splits of an account or query   *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+#include <config.h>
+
+#include "Account.h"
+#include "AccountP.h"
+#include "Split.h"
+#include "gnc-split-cursor.h"
+
+struct GncSplitCursor
+{
+    Account *account;           /* NULL when walking query results */
+    GList *node;
+    size_t position;
+    guint generation;
+};
+
+GncSplitCursor *
+gnc_split_cursor_new_for_account (Account *acc)
+{
+    g_return_val_if_fail (GNC_IS_ACCOUNT (acc), nullptr);
+
+    auto cursor = g_new0 (GncSplitCursor, 1);
+    cursor->account = GNC_ACCOUNT (g_object_ref (acc));
+    cursor->node = xaccAccountGetSplitList (acc);
+    cursor->generation = gnc_account_get_splits_generation (acc);
+    return cursor;
+}
+
+GncSplitCursor *
+gnc_split_cursor_new_for_query (QofQuery *query)
+{
+    g_return_val_if_fail (query, nullptr);
+    g_return_val_if_fail (!g_strcmp0 (qof_query_get_search_for (query),
+                                      GNC_ID_SPLIT), nullptr);
+
+    auto cursor = g_new0 (GncSplitCursor, 1);
+    cursor->node = qof_query_run (query);
+    return cursor;
+}
+
+size_t
+gnc_split_cursor_next (GncSplitCursor *cursor, size_t n, Split **splits)
+{
+    g_return_val_if_fail (cursor, 0);
+    g_return_val_if_fail (splits || !n, 0);
+
+    if (cursor->account &&
+        cursor->generation != gnc_account_get_splits_generation (cursor->account))
+    {
+        /* Our node may be gone, find the position again. Getting the
+         * list can sort it, so read the generation afterwards. */
+        auto splitlist = xaccAccountGetSplitList (cursor->account);
+        cursor->generation = gnc_account_get_splits_generation (cursor->account);
+        cursor->node = g_list_nth (splitlist, cursor->position);
+    }
+
+    size_t count = 0;
+    for (; cursor->node && count < n; cursor->node = cursor->node->next)
+        splits[count++] = GNC_SPLIT (cursor->node->data);
+    cursor->position += count;
+    return count;
+}
+
+void
+gnc_split_cursor_free (GncSplitCursor *cursor)
+{
+    if (!cursor)
+        return;
+    if (cursor->account)
+        g_object_unref (cursor->account);
+    g_free (cursor);
+}
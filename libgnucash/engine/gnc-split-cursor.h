@@ -0,0 +1,78 @@
+/********************************************************************\
+ * gnc-split-cursor.h -- Walk the splits of an account or query     *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+/** @addtogroup Engine
+ @{
+*/
+/** @file gnc-split-cursor.h
+ * @brief Walk the splits of an account or query in batches
+ *
+ * A GncSplitCursor is a position in the split list owned by an account
+ * or a query. Each call to gnc_split_cursor_next() fills a caller
+ * supplied array with the following splits, so the language bindings
+ * can hand out a few splits at a time instead of converting the whole
+ * list at once.
+ */
+
+#ifndef GNC_SPLIT_CURSOR_H
+#define GNC_SPLIT_CURSOR_H
+
+#include <stddef.h>
+
+#include "qof.h"
+#include "gnc-engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct GncSplitCursor GncSplitCursor;
+
+/** Create a cursor at the first split of an account, in the order of
+ *  xaccAccountGetSplitList(). The cursor holds a reference on the
+ *  account. If splits are added, removed or reordered in the meantime
+ *  the walk continues at the same position of the changed list.
+ */
+GncSplitCursor *gnc_split_cursor_new_for_account (Account *acc);
+
+/** Run a query for splits and create a cursor at its first result. The
+ *  results belong to the query, so it must not be run again or destroyed
+ *  while the cursor is in use.
+ */
+GncSplitCursor *gnc_split_cursor_new_for_query (QofQuery *query);
+
+/** Copy up to n following splits into the splits array and advance the
+ *  cursor past them.
+ *
+ *  @return The number of splits copied, 0 once the end is reached.
+ */
+size_t gnc_split_cursor_next (GncSplitCursor *cursor, size_t n, Split **splits);
+
+/** Free the cursor. */
+void gnc_split_cursor_free (GncSplitCursor *cursor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNC_SPLIT_CURSOR_H */
+/** @} */
@@ -0,0 +1,389 @@
+/********************************************************************\
+ * gnc-split-table.cpp -- Filter, sort and group splits for reports *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+#include <config.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "Account.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "gnc-date.h"
+#include "gnc-split-table.h"
+
+/* An empty value stands for a missing string, like a transaction
+ * without notes. */
+using SplitTableValue = std::variant<std::monostate, time64, gnc_numeric, std::string>;
+
+struct SplitTableRow
+{
+    Split *split;
+    std::vector<SplitTableValue> sort_values;
+    SplitTableValue group_values[2];
+};
+
+struct SplitTableSortKey
+{
+    GncSplitTableKey key;
+    GncSplitTablePeriod period;
+    bool ascending;
+};
+
+struct GncSplitTable
+{
+    std::vector<SplitTableRow> rows;
+    std::vector<SplitTableSortKey> sort_keys;
+    GncSplitTableKey group_keys[2] = {GNC_SPLIT_TABLE_KEY_NONE,
+                                      GNC_SPLIT_TABLE_KEY_NONE};
+};
+
+static constexpr time64 SECS_PER_DAY = 86400;
+
+static time64
+period_value (time64 t, GncSplitTablePeriod period)
+{
+    if (period == GNC_SPLIT_TABLE_PERIOD_NONE)
+        return t;
+
+    if (period == GNC_SPLIT_TABLE_PERIOD_WEEK)
+    {
+        /* Weeks since the first start of week of the epoch. */
+        auto week_start = gnc_start_of_week ();
+        if (!week_start)
+            week_start = 1;
+        auto days = gnc_time64_get_day_start (t) - (1 + week_start) * SECS_PER_DAY;
+        auto week = days / (7 * SECS_PER_DAY);
+        return days % (7 * SECS_PER_DAY) < 0 ? week - 1 : week;
+    }
+
+    struct tm tm;
+    if (!gnc_localtime_r (&t, &tm))
+        return 0;
+    time64 year = tm.tm_year + 1900;
+    switch (period)
+    {
+    case GNC_SPLIT_TABLE_PERIOD_DAY:
+        return 500 * year + tm.tm_yday + 1;
+    case GNC_SPLIT_TABLE_PERIOD_MONTH:
+        return 100 * year + tm.tm_mon + 1;
+    case GNC_SPLIT_TABLE_PERIOD_QUARTER:
+        return 10 * year + tm.tm_mon / 3 + 1;
+    default:
+        return year;
+    }
+}
+
+static SplitTableValue
+string_value (const char *str, bool collate)
+{
+    if (!str)
+        return {};
+    if (!collate)
+        return std::string{str};
+    auto key = g_utf8_collate_key (str, -1);
+    std::string rv{key};
+    g_free (key);
+    return rv;
+}
+
+static SplitTableValue
+owned_string_value (char *str, bool collate)
+{
+    auto rv = string_value (str, collate);
+    g_free (str);
+    return rv;
+}
+
+/* Strings are turned into collation keys when the value is used for
+ * sorting. */
+static SplitTableValue
+key_value (const Split *split, GncSplitTableKey key, GncSplitTablePeriod period,
+           bool collate)
+{
+    auto trans = xaccSplitGetParent (split);
+    switch (key)
+    {
+    case GNC_SPLIT_TABLE_KEY_ACCOUNT_NAME:
+        return owned_string_value (gnc_account_get_full_name (xaccSplitGetAccount (split)),
+                                   collate);
+    case GNC_SPLIT_TABLE_KEY_ACCOUNT_CODE:
+        return string_value (xaccAccountGetCode (xaccSplitGetAccount (split)), collate);
+    case GNC_SPLIT_TABLE_KEY_DATE_POSTED:
+        return period_value (xaccTransGetDate (trans), period);
+    case GNC_SPLIT_TABLE_KEY_DATE_RECONCILED:
+        return period_value (xaccSplitGetDateReconciled (split), period);
+    case GNC_SPLIT_TABLE_KEY_RECONCILE:
+    {
+        static const char order[] = "vfycn";
+        auto rec = xaccSplitGetReconcile (split);
+        auto pos = rec ? strchr (order, rec) : nullptr;
+        return static_cast<time64>(pos ? pos - order + 1 : 0);
+    }
+    case GNC_SPLIT_TABLE_KEY_CORR_ACCOUNT_NAME:
+        return owned_string_value (xaccSplitGetCorrAccountFullName (split), collate);
+    case GNC_SPLIT_TABLE_KEY_CORR_ACCOUNT_CODE:
+        return string_value (xaccSplitGetCorrAccountCode (split), collate);
+    case GNC_SPLIT_TABLE_KEY_VALUE:
+        return xaccSplitGetValue (split);
+    case GNC_SPLIT_TABLE_KEY_DESCRIPTION:
+        return string_value (xaccTransGetDescription (trans), collate);
+    case GNC_SPLIT_TABLE_KEY_TRANS_NUM:
+        return string_value (xaccTransGetNum (trans), collate);
+    case GNC_SPLIT_TABLE_KEY_ACTION:
+        return string_value (xaccSplitGetAction (split), collate);
+    case GNC_SPLIT_TABLE_KEY_MEMO:
+        return string_value (xaccSplitGetMemo (split), collate);
+    case GNC_SPLIT_TABLE_KEY_NOTES:
+        return string_value (xaccTransGetNotes (trans), collate);
+    default:
+        return {};
+    }
+}
+
+static int
+compare_values (const SplitTableValue& a, const SplitTableValue& b)
+{
+    if (a.index () != b.index ())
+        return a.index () < b.index () ? -1 : 1;
+    if (auto ta = std::get_if<time64>(&a))
+    {
+        auto tb = std::get<time64>(b);
+        return *ta < tb ? -1 : *ta > tb ? 1 : 0;
+    }
+    if (auto na = std::get_if<gnc_numeric>(&a))
+        return gnc_numeric_compare (*na, std::get<gnc_numeric>(b));
+    if (auto sa = std::get_if<std::string>(&a))
+        return sa->compare (std::get<std::string>(b));
+    return 0;
+}
+
+static bool
+equal_values (const SplitTableValue& a, const SplitTableValue& b)
+{
+    if (a.index () != b.index ())
+        return false;
+    if (auto na = std::get_if<gnc_numeric>(&a))
+        return gnc_numeric_equal (*na, std::get<gnc_numeric>(b));
+    return compare_values (a, b) == 0;
+}
+
+template <typename Pred> static void
+filter_rows (GncSplitTable *table, Pred keep)
+{
+    auto& rows = table->rows;
+    rows.erase (std::remove_if (rows.begin (), rows.end (),
+                                [&keep](const SplitTableRow& row)
+                                { return !keep (row.split); }),
+                rows.end ());
+}
+
+GncSplitTable *
+gnc_split_table_new (SplitList *splits)
+{
+    auto table = new GncSplitTable;
+    table->rows.reserve (g_list_length (splits));
+    for (auto node = splits; node; node = node->next)
+        table->rows.push_back ({GNC_SPLIT (node->data), {}, {}});
+    return table;
+}
+
+void
+gnc_split_table_filter_date_reconciled (GncSplitTable *table,
+                                        time64 begin, time64 end)
+{
+    g_return_if_fail (table);
+    filter_rows (table, [begin, end](const Split *split)
+    {
+        if (xaccSplitGetReconcile (split) != YREC)
+            return true;
+        auto date = xaccSplitGetDateReconciled (split);
+        return begin <= date && date <= end;
+    });
+}
+
+void
+gnc_split_table_filter_date_entered (GncSplitTable *table,
+                                     time64 begin, time64 end)
+{
+    g_return_if_fail (table);
+    filter_rows (table, [begin, end](const Split *split)
+    {
+        auto date = xaccTransRetDateEntered (xaccSplitGetParent (split));
+        return begin <= date && date <= end;
+    });
+}
+
+void
+gnc_split_table_filter_other_accounts (GncSplitTable *table,
+                                       AccountList *accounts, gboolean exclude)
+{
+    g_return_if_fail (table);
+    std::unordered_set<const Account*> account_set;
+    for (auto node = accounts; node; node = node->next)
+        account_set.insert (GNC_ACCOUNT (node->data));
+
+    filter_rows (table, [&account_set, exclude](const Split *split)
+    {
+        bool member = false;
+        for (auto node = xaccTransGetSplitList (xaccSplitGetParent (split));
+             node && !member; node = node->next)
+        {
+            auto other = GNC_SPLIT (node->data);
+            member = other != split &&
+                account_set.count (xaccSplitGetAccount (other));
+        }
+        return member != static_cast<bool>(exclude);
+    });
+}
+
+static std::vector<gunichar>
+lowered_chars (const char *str)
+{
+    std::vector<gunichar> chars;
+    for (auto p = str; *p; p = g_utf8_next_char (p))
+        chars.push_back (g_unichar_tolower (g_utf8_get_char (p)));
+    return chars;
+}
+
+void
+gnc_split_table_filter_text (GncSplitTable *table, const char *text,
+                             gboolean case_insensitive, gboolean exclude)
+{
+    g_return_if_fail (table);
+    if (!text || !*text)
+        return;
+
+    auto lowered_text = case_insensitive ? lowered_chars (text) : std::vector<gunichar>{};
+    auto contains = [text, case_insensitive, &lowered_text](const char *str)
+    {
+        if (!str)
+            return false;
+        if (!case_insensitive)
+            return strstr (str, text) != nullptr;
+        auto chars = lowered_chars (str);
+        return std::search (chars.begin (), chars.end (), lowered_text.begin (),
+                            lowered_text.end ()) != chars.end ();
+    };
+
+    filter_rows (table, [&contains, exclude](const Split *split)
+    {
+        auto trans = xaccSplitGetParent (split);
+        bool match = contains (xaccTransGetDescription (trans)) ||
+            contains (xaccTransGetNotes (trans)) ||
+            contains (xaccSplitGetMemo (split));
+        return match != static_cast<bool>(exclude);
+    });
+}
+
+void
+gnc_split_table_add_sort_key (GncSplitTable *table, GncSplitTableKey key,
+                              GncSplitTablePeriod period, gboolean ascending)
+{
+    g_return_if_fail (table);
+    if (key != GNC_SPLIT_TABLE_KEY_NONE)
+        table->sort_keys.push_back ({key, period, static_cast<bool>(ascending)});
+}
+
+void
+gnc_split_table_sort (GncSplitTable *table)
+{
+    g_return_if_fail (table);
+    const auto& keys = table->sort_keys;
+    if (keys.empty ())
+        return;
+
+    /* Read every key once, rather than twice per comparison. */
+    for (auto& row : table->rows)
+    {
+        row.sort_values.reserve (keys.size ());
+        for (const auto& key : keys)
+            row.sort_values.push_back (key_value (row.split, key.key, key.period, true));
+    }
+
+    std::stable_sort (table->rows.begin (), table->rows.end (),
+                      [&keys](const SplitTableRow& a, const SplitTableRow& b)
+    {
+        for (size_t i = 0; i < keys.size (); ++i)
+        {
+            auto cmp = compare_values (a.sort_values[i], b.sort_values[i]);
+            if (cmp)
+                return keys[i].ascending ? cmp < 0 : cmp > 0;
+        }
+        return false;
+    });
+
+    for (auto& row : table->rows)
+        std::vector<SplitTableValue>{}.swap (row.sort_values);
+}
+
+void
+gnc_split_table_set_group_key (GncSplitTable *table, guint level,
+                               GncSplitTableKey key, GncSplitTablePeriod period)
+{
+    g_return_if_fail (table);
+    g_return_if_fail (level < 2);
+
+    table->group_keys[level] = key;
+    for (auto& row : table->rows)
+        row.group_values[level] = key_value (row.split, key, period, false);
+}
+
+gboolean
+gnc_split_table_group_ends (const GncSplitTable *table, guint row, guint level)
+{
+    g_return_val_if_fail (table, FALSE);
+    g_return_val_if_fail (level < 2, FALSE);
+
+    const auto& rows = table->rows;
+    if (table->group_keys[level] == GNC_SPLIT_TABLE_KEY_NONE || row >= rows.size ())
+        return FALSE;
+    return row + 1 == rows.size () ||
+        !equal_values (rows[row].group_values[level], rows[row + 1].group_values[level]);
+}
+
+guint
+gnc_split_table_get_size (const GncSplitTable *table)
+{
+    g_return_val_if_fail (table, 0);
+    return table->rows.size ();
+}
+
+SplitList *
+gnc_split_table_get_splits (const GncSplitTable *table)
+{
+    g_return_val_if_fail (table, nullptr);
+    GList *splits = nullptr;
+    for (auto it = table->rows.rbegin (); it != table->rows.rend (); ++it)
+        splits = g_list_prepend (splits, it->split);
+    return splits;
+}
+
+void
+gnc_split_table_free (GncSplitTable *table)
+{
+    delete table;
+}
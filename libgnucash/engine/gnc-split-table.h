@@ -0,0 +1,152 @@
+/********************************************************************\
+ * gnc-split-table.h -- Filter, sort and group splits for reports   *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+/** @addtogroup Engine
+ @{
+*/
+/** @file gnc-split-table.h
+ * @brief Filter, sort and group splits for the transaction report
+ *
+ * A GncSplitTable holds one row per split of a query result. The rows
+ * can be filtered, sorted on several keys and split into two levels of
+ * groups without calling back into the report for every split: the
+ * values of each key are read once per row and compared natively.
+ *
+ * String keys sort like gnc:string-locale<?, the period of a date key
+ * is computed like the time64-day, -week, -month, -quarter and -year
+ * helpers of the transaction report.
+ */
+
+#ifndef GNC_SPLIT_TABLE_H
+#define GNC_SPLIT_TABLE_H
+
+#include "qof.h"
+#include "gnc-engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct GncSplitTable GncSplitTable;
+
+/** The split properties a table can be sorted and grouped on. */
+typedef enum
+{
+    GNC_SPLIT_TABLE_KEY_NONE,
+    GNC_SPLIT_TABLE_KEY_ACCOUNT_NAME,     /**< full name of the account */
+    GNC_SPLIT_TABLE_KEY_ACCOUNT_CODE,
+    GNC_SPLIT_TABLE_KEY_DATE_POSTED,
+    GNC_SPLIT_TABLE_KEY_DATE_RECONCILED,
+    GNC_SPLIT_TABLE_KEY_RECONCILE,        /**< n, c, y, f, v in this order */
+    GNC_SPLIT_TABLE_KEY_CORR_ACCOUNT_NAME,
+    GNC_SPLIT_TABLE_KEY_CORR_ACCOUNT_CODE,
+    GNC_SPLIT_TABLE_KEY_VALUE,
+    GNC_SPLIT_TABLE_KEY_DESCRIPTION,
+    GNC_SPLIT_TABLE_KEY_TRANS_NUM,
+    GNC_SPLIT_TABLE_KEY_ACTION,
+    GNC_SPLIT_TABLE_KEY_MEMO,
+    GNC_SPLIT_TABLE_KEY_NOTES,
+} GncSplitTableKey;
+
+/** The period a date key is reduced to before comparing. */
+typedef enum
+{
+    GNC_SPLIT_TABLE_PERIOD_NONE,
+    GNC_SPLIT_TABLE_PERIOD_DAY,
+    GNC_SPLIT_TABLE_PERIOD_WEEK,
+    GNC_SPLIT_TABLE_PERIOD_MONTH,
+    GNC_SPLIT_TABLE_PERIOD_QUARTER,
+    GNC_SPLIT_TABLE_PERIOD_YEAR,
+} GncSplitTablePeriod;
+
+/** Create a table with a row for each split, in the order of the list. */
+GncSplitTable *gnc_split_table_new (SplitList *splits);
+
+/** Drop the reconciled rows whose reconcile date is outside
+ *  [begin, end]. Rows which aren't reconciled are kept. */
+void gnc_split_table_filter_date_reconciled (GncSplitTable *table,
+                                             time64 begin, time64 end);
+
+/** Drop the rows whose transaction was entered outside [begin, end]. */
+void gnc_split_table_filter_date_entered (GncSplitTable *table,
+                                          time64 begin, time64 end);
+
+/** Keep the rows whose transaction has another split in one of the
+ *  accounts, or with exclude the rows whose transaction has none. */
+void gnc_split_table_filter_other_accounts (GncSplitTable *table,
+                                            AccountList *accounts,
+                                            gboolean exclude);
+
+/** Keep the rows whose transaction description, transaction notes or
+ *  memo contain the text, or with exclude the rows where none of them
+ *  do. An empty text keeps every row.
+ *
+ *  @param case_insensitive Compare each character after lowering it,
+ *         like string-contains-ci.
+ */
+void gnc_split_table_filter_text (GncSplitTable *table, const char *text,
+                                  gboolean case_insensitive, gboolean exclude);
+
+/** Add a key to sort on, after the keys added before. A key of
+ *  GNC_SPLIT_TABLE_KEY_NONE is ignored.
+ *
+ *  @param period For the date keys, the period to compare. Ignored for
+ *         the other keys.
+ */
+void gnc_split_table_add_sort_key (GncSplitTable *table, GncSplitTableKey key,
+                                   GncSplitTablePeriod period,
+                                   gboolean ascending);
+
+/** Stable sort the rows on the sort keys. Rows without a value for a
+ *  key, like a transaction without notes, sort before the others on an
+ *  ascending key and after them on a descending one. */
+void gnc_split_table_sort (GncSplitTable *table);
+
+/** Set the key grouping the rows at level 0 (primary) or 1 (secondary).
+ *  A key of GNC_SPLIT_TABLE_KEY_NONE removes the grouping.
+ */
+void gnc_split_table_set_group_key (GncSplitTable *table, guint level,
+                                    GncSplitTableKey key,
+                                    GncSplitTablePeriod period);
+
+/** @return TRUE if the row is the last one of its group at the level,
+ *  that is if it's the last row or the next one has another value of
+ *  the group key. Always FALSE for a level without a group key. */
+gboolean gnc_split_table_group_ends (const GncSplitTable *table, guint row,
+                                     guint level);
+
+/** @return The number of rows. */
+guint gnc_split_table_get_size (const GncSplitTable *table);
+
+/** @return A new list of the splits of the rows. Free it with
+ *  g_list_free(). */
+SplitList *gnc_split_table_get_splits (const GncSplitTable *table);
+
+/** Free the table. */
+void gnc_split_table_free (GncSplitTable *table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNC_SPLIT_TABLE_H */
+/** @} */
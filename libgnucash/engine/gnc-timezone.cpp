@@ -44,6 +44,8 @@ using PTZ = boost::local_time::posix_time_zone;
 
 const unsigned int TimeZoneProvider::min_year = 1400;
 const unsigned int TimeZoneProvider::max_year = 9999;
+const int TimeZoneProvider::offsets_min_year = 1900;
+const int TimeZoneProvider::offsets_max_year = 2199;
 
 template<typename T>
 T*
@@ -286,6 +288,7 @@ TimeZoneProvider::TimeZoneProvider (const std::string& identifier) :
     if (key_name.empty())
     {
         load_windows_default_tz();
+        cache_offsets();
         return;
     }
     std::string subkey = reg_key + key_name;
@@ -305,6 +308,7 @@ TimeZoneProvider::TimeZoneProvider (const std::string& identifier) :
 	this->load_windows_classic_tz (key, names);
     else
 	throw std::invalid_argument ("No data for TZ " + key_name);
+    cache_offsets();
 }
 #elif PLATFORM(POSIX)
 using std::to_string;
@@ -739,23 +743,26 @@ TimeZoneProvider::construct(const std::string& tzname)
 
 TimeZoneProvider::TimeZoneProvider(const std::string& tzname) :  m_zone_vector {}
 {
-    if(construct(tzname))
-        return;
-    DEBUG("%s invalid, trying TZ environment variable.\n", tzname.c_str());
-    const char* tz_env = getenv("TZ");
-    if(tz_env && construct(tz_env))
-        return;
-    DEBUG("No valid $TZ, resorting to /etc/localtime.\n");
-    try
+    if(!construct(tzname))
     {
-        parse_file("/etc/localtime");
-    }
-    catch(const std::invalid_argument& env)
-    {
-        DEBUG("/etc/localtime invalid, resorting to GMT.");
-        TZ_Ptr zone(new PTZ("UTC0"));
-        m_zone_vector.push_back(std::make_pair(max_year, zone));
+        DEBUG("%s invalid, trying TZ environment variable.\n", tzname.c_str());
+        const char* tz_env = getenv("TZ");
+        if(!(tz_env && construct(tz_env)))
+        {
+            DEBUG("No valid $TZ, resorting to /etc/localtime.\n");
+            try
+            {
+                parse_file("/etc/localtime");
+            }
+            catch(const std::invalid_argument& env)
+            {
+                DEBUG("/etc/localtime invalid, resorting to GMT.");
+                TZ_Ptr zone(new PTZ("UTC0"));
+                m_zone_vector.push_back(std::make_pair(max_year, zone));
+            }
+        }
     }
+    cache_offsets();
 }
 #endif
 
@@ -772,6 +779,45 @@ TimeZoneProvider::get(int year) const noexcept
     return iter->second;
 }
 
+void
+TimeZoneProvider::cache_offsets() noexcept
+{
+    static const boost::posix_time::ptime epoch{boost::gregorian::date(1970, 1, 1)};
+    try
+    {
+        m_offsets.reserve(offsets_max_year - offsets_min_year + 1);
+        for (auto year = offsets_min_year; year <= offsets_max_year; ++year)
+        {
+            auto zone = get(year);
+            TZ_YearOffsets offsets{zone->base_utc_offset().total_seconds(),
+                    0, zone->has_dst(), 0, 0};
+            if (offsets.has_dst)
+            {
+                offsets.dst_offset = zone->dst_offset().total_seconds();
+                offsets.dst_start =
+                    (zone->dst_local_start_time(year) - epoch).total_seconds();
+                offsets.dst_end =
+                    (zone->dst_local_end_time(year) - epoch).total_seconds();
+            }
+            m_offsets.push_back(offsets);
+        }
+    }
+    catch(const std::exception& err)
+    {
+        PWARN("Unable to tabulate the offsets of the time zone: %s", err.what());
+        m_offsets.clear();
+    }
+}
+
+const TZ_YearOffsets*
+TimeZoneProvider::offsets(int year) const noexcept
+{
+    auto index = year - offsets_min_year;
+    if (index < 0 || static_cast<size_t>(index) >= m_offsets.size())
+        return nullptr;
+    return &m_offsets[index];
+}
+
 void
 TimeZoneProvider::dump() const noexcept
 {
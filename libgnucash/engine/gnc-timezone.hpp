@@ -42,6 +42,19 @@ using TZ_Entry = std::pair<int, TZ_Ptr>;
 using TZ_Vector = std::vector<TZ_Entry>;
 using time_zone_names = boost::local_time::time_zone_names;
 
+/** The UTC offsets of a time zone for one year, in seconds. dst_start and
+ * dst_end are the local time labels, as seconds from the POSIX epoch, at
+ * which DST begins (in standard time) and ends (in daylight time).
+ */
+struct TZ_YearOffsets
+{
+    int64_t std_offset;
+    int64_t dst_offset;
+    bool has_dst;
+    int64_t dst_start;
+    int64_t dst_end;
+};
+
 class TimeZoneProvider
 {
 public:
@@ -53,13 +66,22 @@ public:
     TimeZoneProvider operator=(const TimeZoneProvider&) = delete;
     TimeZoneProvider operator=(const TimeZoneProvider&&) = delete;
     TZ_Ptr get (int year) const noexcept;
+    /* The offsets for year, or nullptr if year is outside of
+     * offsets_min_year - offsets_max_year. The table is filled by the
+     * constructor so lookups need no locking.
+     */
+    const TZ_YearOffsets* offsets (int year) const noexcept;
     void dump() const noexcept;
     static const unsigned int min_year; //1400
     static const unsigned int max_year; //9999
+    static const int offsets_min_year; //1900
+    static const int offsets_max_year; //2199
 private:
     void parse_file(const std::string& tzname);
     bool construct(const std::string& tzname);
+    void cache_offsets() noexcept;
     TZ_Vector m_zone_vector;
+    std::vector<TZ_YearOffsets> m_offsets;
 #if PLATFORM(WINDOWS)
     void load_windows_dynamic_tz(HKEY, time_zone_names);
     void load_windows_classic_tz(HKEY, time_zone_names);
@@ -1268,6 +1268,7 @@ gncInvoiceDetachFromLot (GNCLot *lot)
     qof_instance_set (QOF_INSTANCE (lot), "invoice", NULL, NULL);
     gnc_lot_commit_edit (lot);
     gnc_lot_set_cached_invoice (lot, NULL);
+    qof_event_gen (QOF_INSTANCE (lot), QOF_EVENT_MODIFY, NULL);
 }
 
 void
@@ -1284,6 +1285,7 @@ gncInvoiceAttachToLot (GncInvoice *invoice, GNCLot *lot)
     gnc_lot_commit_edit (lot);
     gnc_lot_set_cached_invoice (lot, invoice);
     gncInvoiceSetPostedLot (invoice, lot);
+    qof_event_gen (QOF_INSTANCE (lot), QOF_EVENT_MODIFY, NULL);
 }
 
 GncInvoice * gncInvoiceGetInvoiceFromLot (GNCLot *lot)
@@ -631,6 +631,7 @@ void gncOwnerAttachToLot (const GncOwner *owner, GNCLot *lot)
 		      GNC_OWNER_GUID, gncOwnerGetGUID (owner),
 		      NULL);
     gnc_lot_commit_edit (lot);
+    qof_event_gen (QOF_INSTANCE (lot), QOF_EVENT_MODIFY, NULL);
 }
 
 gboolean gncOwnerGetOwnerFromLot (GNCLot *lot, GncOwner *owner)
@@ -1470,6 +1471,239 @@ gncOwnerGetCommoditiesList (const GncOwner *owner)
 /*********************************************************************/
 /* Owner balance calculation routines                                */
 
+/* The balances of the owners of a book are kept in an index of the open
+ * invoice lots in its A/R and A/P accounts so that finding one doesn't
+ * require walking all the accounts and lots. The index is built when an
+ * owner balance is first requested; after that lot events only mark the
+ * lot as dirty and its contribution is recomputed on the next request.
+ * That way the index doesn't depend on the order in which the event
+ * handlers are run.
+ */
+#define OWNER_BALANCE_INDEX "gncOwnerBalanceIndex"
+
+typedef struct
+{
+    const gnc_commodity *commodity;
+    GNCAccountType type;
+    gnc_numeric balance;
+} OwnerBalance;
+
+typedef struct
+{
+    GncGUID owner;
+    OwnerBalance balance;
+} LotBalance;
+
+typedef struct
+{
+    GHashTable *lots;   /* GNCLot* -> LotBalance*, the counted lots */
+    GHashTable *owners; /* End owner GncGUID* -> GList* of OwnerBalance* */
+    GHashTable *dirty;  /* Set of GNCLot* to recompute */
+    gboolean stale;     /* Rebuild from the accounts before use */
+} OwnerBalanceIndex;
+
+static gint owner_balance_handler_id = 0;
+
+static void
+owner_balances_free (gpointer data)
+{
+    g_list_free_full (data, g_free);
+}
+
+static void
+owner_balance_index_free (QofBook *book, gpointer key, gpointer data)
+{
+    OwnerBalanceIndex *index = data;
+
+    g_hash_table_destroy (index->lots);
+    g_hash_table_destroy (index->owners);
+    g_hash_table_destroy (index->dirty);
+    g_free (index);
+}
+
+static void
+owner_balance_index_add (OwnerBalanceIndex *index, const GncGUID *owner,
+                         const OwnerBalance *balance, gboolean subtract)
+{
+    GList *balances = g_hash_table_lookup (index->owners, owner), *node;
+    int fraction = gnc_commodity_get_fraction (balance->commodity);
+    OwnerBalance *sum = NULL;
+
+    for (node = balances; node; node = node->next)
+    {
+        OwnerBalance *candidate = node->data;
+        if (candidate->commodity == balance->commodity &&
+            candidate->type == balance->type)
+        {
+            sum = candidate;
+            break;
+        }
+    }
+    if (!sum)
+    {
+        sum = g_new0 (OwnerBalance, 1);
+        sum->commodity = balance->commodity;
+        sum->type = balance->type;
+        sum->balance = gnc_numeric_zero ();
+        if (balances)
+            balances = g_list_append (balances, sum);
+        else
+            g_hash_table_insert (index->owners, guid_copy (owner),
+                                 g_list_prepend (NULL, sum));
+    }
+    if (subtract)
+        sum->balance = gnc_numeric_sub (sum->balance, balance->balance,
+                                        fraction, GNC_HOW_RND_ROUND_HALF_UP);
+    else
+        sum->balance = gnc_numeric_add (sum->balance, balance->balance,
+                                        fraction, GNC_HOW_RND_ROUND_HALF_UP);
+}
+
+static void
+owner_balance_index_remove_lot (OwnerBalanceIndex *index, GNCLot *lot)
+{
+    LotBalance *old = g_hash_table_lookup (index->lots, lot);
+
+    if (!old) return;
+    owner_balance_index_add (index, &old->owner, &old->balance, TRUE);
+    g_hash_table_remove (index->lots, lot);
+}
+
+/* Counts the lot the way gncOwnerGetBalanceInCurrency used to find it:
+ * an open invoice lot in an A/R or A/P account of the book's tree.
+ */
+static void
+owner_balance_index_update_lot (OwnerBalanceIndex *index, GNCLot *lot)
+{
+    QofBook *book = qof_instance_get_book (lot);
+    Account *account = gnc_lot_get_account (lot);
+    GncInvoice *invoice;
+    const GncOwner *owner;
+    GNCAccountType type;
+    LotBalance *entry;
+
+    owner_balance_index_remove_lot (index, lot);
+
+    if (!account || gnc_lot_is_closed (lot))
+        return;
+    type = xaccAccountGetType (account);
+    if (type != ACCT_TYPE_RECEIVABLE && type != ACCT_TYPE_PAYABLE)
+        return;
+    if (gnc_account_get_root (account) != gnc_book_get_root_account (book))
+        return;
+    invoice = gncInvoiceGetInvoiceFromLot (lot);
+    if (!invoice)
+        return;
+    owner = gncOwnerGetEndOwner (gncInvoiceGetOwner (invoice));
+    if (!owner || !gncOwnerGetGUID (owner))
+        return;
+
+    entry = g_new0 (LotBalance, 1);
+    entry->owner = *gncOwnerGetGUID (owner);
+    entry->balance.commodity = xaccAccountGetCommodity (account);
+    entry->balance.type = type;
+    entry->balance.balance = gnc_lot_get_balance (lot);
+    g_hash_table_insert (index->lots, lot, entry);
+    owner_balance_index_add (index, &entry->owner, &entry->balance, FALSE);
+}
+
+static void
+owner_balance_index_rebuild (OwnerBalanceIndex *index, QofBook *book)
+{
+    GList *accounts, *node;
+
+    g_hash_table_remove_all (index->lots);
+    g_hash_table_remove_all (index->owners);
+    g_hash_table_remove_all (index->dirty);
+
+    accounts = gnc_account_get_descendants (gnc_book_get_root_account (book));
+    for (node = accounts; node; node = node->next)
+    {
+        Account *account = node->data;
+        GNCAccountType type = xaccAccountGetType (account);
+        LotList *lots, *lot_node;
+
+        if (type != ACCT_TYPE_RECEIVABLE && type != ACCT_TYPE_PAYABLE)
+            continue;
+        lots = xaccAccountGetLotList (account);
+        for (lot_node = lots; lot_node; lot_node = lot_node->next)
+            owner_balance_index_update_lot (index, lot_node->data);
+        g_list_free (lots);
+    }
+    g_list_free (accounts);
+    index->stale = FALSE;
+}
+
+static void
+owner_balance_index_handler (QofInstance *entity, QofEventId event_type,
+                             gpointer user_data, gpointer event_data)
+{
+    QofBook *book;
+    OwnerBalanceIndex *index;
+
+    if (!GNC_IS_LOT (entity) && !GNC_IS_JOB (entity))
+        return;
+    book = qof_instance_get_book (entity);
+    if (!book || qof_book_shutting_down (book))
+        return;
+    index = qof_book_get_data (book, OWNER_BALANCE_INDEX);
+    if (!index)
+        return;
+
+    if (GNC_IS_JOB (entity))
+    {
+        /* A job may have been moved to another owner, taking its
+         * invoices' lots along. That's rare, so start over. */
+        if (event_type & QOF_EVENT_MODIFY)
+            index->stale = TRUE;
+    }
+    else if (event_type & QOF_EVENT_DESTROY)
+    {
+        owner_balance_index_remove_lot (index, GNC_LOT (entity));
+        g_hash_table_remove (index->dirty, entity);
+    }
+    else
+        g_hash_table_add (index->dirty, entity);
+}
+
+static void
+owner_balance_index_update_dirty (gpointer key, gpointer value,
+                                  gpointer user_data)
+{
+    owner_balance_index_update_lot (user_data, key);
+}
+
+static OwnerBalanceIndex *
+owner_balance_index_get (QofBook *book)
+{
+    OwnerBalanceIndex *index = qof_book_get_data (book, OWNER_BALANCE_INDEX);
+
+    if (!index)
+    {
+        index = g_new0 (OwnerBalanceIndex, 1);
+        index->lots = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                             NULL, g_free);
+        index->owners = g_hash_table_new_full (guid_hash_to_guint,
+                                               guid_g_hash_table_equal,
+                                               (GDestroyNotify)guid_free,
+                                               owner_balances_free);
+        index->dirty = g_hash_table_new (g_direct_hash, g_direct_equal);
+        index->stale = TRUE;
+        qof_book_set_data_fin (book, OWNER_BALANCE_INDEX, index,
+                               owner_balance_index_free);
+    }
+
+    if (index->stale)
+        owner_balance_index_rebuild (index, book);
+    else if (g_hash_table_size (index->dirty))
+    {
+        g_hash_table_foreach (index->dirty, owner_balance_index_update_dirty,
+                              index);
+        g_hash_table_remove_all (index->dirty);
+    }
+    return index;
+}
+
 /*
  * Given an owner, extract the open balance from the owner and then
  * convert it to the desired currency.
@@ -1494,42 +1728,24 @@ gncOwnerGetBalanceInCurrency (const GncOwner *owner,
         balance = *cached_balance;
     else
     {
-        /* No valid cache value found for balance. Let's recalculate */
-        GList *acct_list  = gnc_account_get_descendants (gnc_book_get_root_account (book));
+        /* No valid cache value found for balance. Sum the owner's
+         * balances in its currency from the index. */
+        OwnerBalanceIndex *index = owner_balance_index_get (book);
+        const GncGUID *guid = gncOwnerGetGUID (owner);
         GList *acct_types = gncOwnerGetAccountTypesList (owner);
-        GList *acct_node;
+        GList *node = guid ? g_hash_table_lookup (index->owners, guid) : NULL;
 
-        /* For each account */
-        for (acct_node = acct_list; acct_node; acct_node = acct_node->next)
+        for (; node; node = node->next)
         {
-            Account *account = acct_node->data;
-            GList *lot_list = NULL, *lot_node;
+            OwnerBalance *sum = node->data;
 
-            /* Check if this account can have lots for the owner, otherwise skip to next */
-            if (g_list_index (acct_types, (gpointer)xaccAccountGetType (account))
-                    == -1)
+            if (g_list_index (acct_types, (gpointer)sum->type) == -1)
                 continue;
-
-
-            if (!gnc_commodity_equal (owner_currency, xaccAccountGetCommodity (account)))
+            if (!gnc_commodity_equal (owner_currency, sum->commodity))
                 continue;
-
-            /* Get a list of open lots for this owner and account */
-            lot_list = xaccAccountFindOpenLots (account, gncOwnerLotMatchOwnerFunc,
-                                                (gpointer)owner, NULL);
-            /* For each lot */
-            for (lot_node = lot_list; lot_node; lot_node = lot_node->next)
-            {
-                GNCLot *lot = lot_node->data;
-                gnc_numeric lot_balance = gnc_lot_get_balance (lot);
-                GncInvoice *invoice = gncInvoiceGetInvoiceFromLot(lot);
-                if (invoice)
-                balance = gnc_numeric_add (balance, lot_balance,
-                                            gnc_commodity_get_fraction (owner_currency), GNC_HOW_RND_ROUND_HALF_UP);
-            }
-            g_list_free (lot_list);
+            balance = gnc_numeric_add (balance, sum->balance,
+                                       gnc_commodity_get_fraction (owner_currency), GNC_HOW_RND_ROUND_HALF_UP);
         }
-        g_list_free (acct_list);
         g_list_free (acct_types);
 
         gncOwnerSetCachedBalance (owner, &balance);
@@ -1622,6 +1838,10 @@ gboolean gncOwnerRegister (void)
     qof_class_register (GNC_ID_OWNER, (QofSortFunc)gncOwnerCompare, params);
     reg_lot ();
 
+    if (owner_balance_handler_id == 0)
+        owner_balance_handler_id =
+            qof_event_register_handler (owner_balance_index_handler, NULL);
+
     return TRUE;
 }
 
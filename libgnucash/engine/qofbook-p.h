@@ -59,6 +59,9 @@ void qof_book_set_backend (QofBook *book, QofBackend *be);
 /* Register books with the engine */
 gboolean qof_book_register (void);
 
+/* Called by qof_commit_edit_part2() for each committed change. */
+void qof_book_bump_generation (QofBook *book);
+
 /** @deprecated use qof_instance_set_guid instead but only in
 backends (when reading the GncGUID from the data source). */
 #define qof_book_set_guid(book,guid)    \
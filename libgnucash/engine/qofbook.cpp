@@ -338,6 +338,15 @@ qof_book_destroy (QofBook *book)
     book->shutting_down = TRUE;
     qof_event_force (&book->inst, QOF_EVENT_DESTROY, NULL);
 
+    /* Everyone watching the book has now been told that it's going
+     * away, so there's no point in generating a destroy event for
+     * every one of its instances: With a large book that's millions
+     * of handler calls for nothing. The instances' own destroy code
+     * checks qof_book_shutting_down() to skip the list and balance
+     * maintenance they'd otherwise do.
+     */
+    qof_event_suspend ();
+
     /* Call the list of finalizers, let them do their thing.
      * Do this before tearing into the rest of the book.
      */
@@ -355,6 +364,8 @@ qof_book_destroy (QofBook *book)
     g_hash_table_destroy (book->data_tables);
     book->data_tables = NULL;
 
+    qof_event_resume ();
+
     /* qof_instance_release (&book->inst); */
 
     /* Note: we need to save this hashtable until after we remove ourself
@@ -422,6 +433,20 @@ qof_book_get_session_dirty_time (const QofBook *book)
     return book->dirty_time;
 }
 
+guint64
+qof_book_get_generation (const QofBook *book)
+{
+    g_return_val_if_fail (book, 0);
+    return book->generation;
+}
+
+void
+qof_book_bump_generation (QofBook *book)
+{
+    if (book)
+        book->generation++;
+}
+
 void
 qof_book_set_dirty_cb(QofBook *book, QofBookDirtyCB cb, gpointer user_data)
 {
@@ -146,6 +146,10 @@ struct _QofBook
     /* version number, used for tracking multiuser updates */
     gint32  version;
 
+    /* Incremented whenever an object of the book is committed with
+     * changes, see qof_book_get_generation(). */
+    guint64 generation;
+
     /* To be technically correct, backends belong to sessions and
      * not books.  So the pointer below "really shouldn't be here",
      * except that it provides a nice convenience, avoiding a lookup
@@ -345,6 +349,11 @@ void qof_book_mark_session_dirty(QofBook *book);
 /** Retrieve the earliest modification time on the book. */
 time64 qof_book_get_session_dirty_time(const QofBook *book);
 
+/** Return a counter that grows every time an object of the book is
+ *  committed with changes. Values computed from the book's contents can
+ *  be cached together with it and reused as long as it doesn't change. */
+guint64 qof_book_get_generation (const QofBook *book);
+
 /** Set the function to call when a book transitions from clean to
  *    dirty, or vice versa.
  */
@@ -31,6 +31,8 @@
 typedef struct
 {
     QofEventHandler handler;
+    QofEventBatchHandler batch_handler;
+    QofEventId immediate_events;
     gpointer user_data;
 
     gint handler_id;
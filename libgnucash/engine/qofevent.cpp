@@ -28,12 +28,39 @@
 #include "qof.h"
 #include "qofevent-p.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+struct GuidHash
+{
+    std::size_t operator()(const GncGUID& guid) const
+    {
+        return guid_hash_to_guint (&guid);
+    }
+};
+
+struct GuidEqual
+{
+    bool operator()(const GncGUID& a, const GncGUID& b) const
+    {
+        return guid_equal (&a, &b);
+    }
+};
+
+using BatchEntries = std::vector<QofEventBatchEntry>;
+using BatchIndex = std::unordered_map<GncGUID, BatchEntries::size_type,
+                                      GuidHash, GuidEqual>;
+
 /* Static Variables ************************************************/
 static guint   suspend_counter   = 0;
 static gint    next_handler_id   = 1;
 static guint   handler_run_level = 0;
 static guint   pending_deletes   = 0;
 static GList   *handlers  =   NULL;
+static guint   batch_counter     = 0;
+static BatchEntries batch_entries;
+static BatchIndex   batch_index;
 
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = QOF_MOD_ENGINE;
@@ -71,11 +98,22 @@ find_next_handler_id(void)
 
 gint
 qof_event_register_handler (QofEventHandler handler, gpointer user_data)
+{
+    return qof_event_register_batch_handler (handler, NULL, QOF_EVENT_NONE,
+                                             user_data);
+}
+
+gint
+qof_event_register_batch_handler (QofEventHandler handler,
+                                  QofEventBatchHandler batch_handler,
+                                  QofEventId immediate_events,
+                                  gpointer user_data)
 {
     HandlerInfo *hi;
     gint handler_id;
 
-    ENTER ("(handler=%p, data=%p)", handler, user_data);
+    ENTER ("(handler=%p, batch_handler=%p, data=%p)", handler, batch_handler,
+           user_data);
 
     /* sanity check */
     if (!handler)
@@ -91,6 +129,8 @@ qof_event_register_handler (QofEventHandler handler, gpointer user_data)
     hi = g_new0 (HandlerInfo, 1);
 
     hi->handler = handler;
+    hi->batch_handler = batch_handler;
+    hi->immediate_events = immediate_events;
     hi->user_data = user_data;
     hi->handler_id = handler_id;
 
@@ -123,6 +163,7 @@ qof_event_unregister_handler (gint handler_id)
 
         /* safety -- clear the handler in case we're running events now */
         hi->handler = NULL;
+        hi->batch_handler = NULL;
 
         if (handler_run_level == 0)
         {
@@ -164,12 +205,54 @@ qof_event_resume (void)
     suspend_counter--;
 }
 
+/* If we're the outermost event runner and we have pending deletes
+ * then go delete the handlers now.
+ */
+static void
+purge_pending_deletes (void)
+{
+    GList *node;
+    GList *next_node = NULL;
+
+    if (handler_run_level != 0 || !pending_deletes)
+        return;
+
+    for (node = handlers; node; node = next_node)
+    {
+        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
+        next_node = node->next;
+        if (hi->handler == NULL)
+        {
+            /* remove this node from the list, then free this node */
+            handlers = g_list_remove_link (handlers, node);
+            g_list_free_1 (node);
+            g_free (hi);
+        }
+    }
+    pending_deletes = 0;
+}
+
+static void
+batch_add (QofInstance *entity, QofEventId event_id)
+{
+    auto guid = qof_instance_get_guid (entity);
+    if (!guid)
+        return;
+
+    auto [iter, added] = batch_index.emplace (*guid, batch_entries.size ());
+    if (added)
+        batch_entries.push_back ({*guid, entity->e_type, event_id});
+    else
+        batch_entries[iter->second].event_mask |= event_id;
+}
+
 static void
 qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
-                             gpointer event_data)
+                             gpointer event_data, gboolean batchable)
 {
     GList *node;
     GList *next_node = NULL;
+    gboolean batching = batchable && batch_counter > 0;
 
     g_return_if_fail(entity);
 
@@ -182,12 +265,19 @@ qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
     }
     }
 
+    if (batching)
+        batch_add (entity, event_id);
+
     handler_run_level++;
     for (node = handlers; node; node = next_node)
     {
         HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
 
         next_node = node->next;
+        /* Batch handlers get this one when the batch ends. */
+        if (batching && hi->batch_handler &&
+            !(event_id & hi->immediate_events))
+            continue;
         if (hi->handler)
         {
             PINFO("id=%d hi=%p han=%p data=%p", hi->handler_id, hi,
@@ -197,25 +287,7 @@ qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
     }
     handler_run_level--;
 
-    /* If we're the outermost event runner and we have pending deletes
-     * then go delete the handlers now.
-     */
-    if (handler_run_level == 0 && pending_deletes)
-    {
-        for (node = handlers; node; node = next_node)
-        {
-            HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
-            next_node = node->next;
-            if (hi->handler == NULL)
-            {
-                /* remove this node from the list, then free this node */
-                handlers = g_list_remove_link (handlers, node);
-                g_list_free_1 (node);
-                g_free (hi);
-            }
-        }
-        pending_deletes = 0;
-    }
+    purge_pending_deletes ();
 }
 
 void
@@ -224,7 +296,7 @@ qof_event_force (QofInstance *entity, QofEventId event_id, gpointer event_data)
     if (!entity)
         return;
 
-    qof_event_generate_internal (entity, event_id, event_data);
+    qof_event_generate_internal (entity, event_id, event_data, FALSE);
 }
 
 void
@@ -236,7 +308,80 @@ qof_event_gen (QofInstance *entity, QofEventId event_id, gpointer event_data)
     if (suspend_counter)
         return;
 
-    qof_event_generate_internal (entity, event_id, event_data);
+    qof_event_generate_internal (entity, event_id, event_data, TRUE);
+}
+
+void
+qof_event_begin_batch (void)
+{
+    batch_counter++;
+
+    if (batch_counter == 0)
+    {
+        PERR ("batch counter overflow");
+    }
+}
+
+void
+qof_event_end_batch (void)
+{
+    GList *node;
+    GList *next_node = NULL;
+
+    if (batch_counter == 0)
+    {
+        PERR ("batch counter underflow");
+        return;
+    }
+
+    if (--batch_counter > 0 || batch_entries.empty ())
+        return;
+
+    /* Take the batch so that events generated by the batch handlers
+     * start a clean one. */
+    BatchEntries entries;
+    entries.swap (batch_entries);
+    batch_index.clear ();
+
+    std::stable_sort (entries.begin (), entries.end (),
+                      [](const QofEventBatchEntry& a,
+                         const QofEventBatchEntry& b)
+                      {
+                          return g_strcmp0 (a.type, b.type) < 0;
+                      });
+
+    ENTER ("(%zu entities)", entries.size ());
+    handler_run_level++;
+    for (node = handlers; node; node = next_node)
+    {
+        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
+
+        next_node = node->next;
+        if (!hi->batch_handler)
+            continue;
+        if (!hi->immediate_events)
+        {
+            hi->batch_handler (entries.data (), entries.size (),
+                               hi->user_data);
+            continue;
+        }
+
+        /* Leave out the events the handler already got. */
+        BatchEntries deferred;
+        for (auto entry : entries)
+        {
+            entry.event_mask &= ~hi->immediate_events;
+            if (entry.event_mask)
+                deferred.push_back (entry);
+        }
+        if (!deferred.empty ())
+            hi->batch_handler (deferred.data (), deferred.size (),
+                               hi->user_data);
+    }
+    handler_run_level--;
+
+    purge_pending_deletes ();
+    LEAVE (" ");
 }
 
 /* =========================== END OF FILE ======================= */
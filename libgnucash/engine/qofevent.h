@@ -139,6 +139,66 @@ void qof_event_suspend (void);
 /** Resume engine event generation. */
 void qof_event_resume (void);
 
+/** One coalesced entry of an event batch.
+ *
+ * The entity itself isn't part of the entry because it may have been
+ * destroyed by the time the batch is delivered; look it up by guid and
+ * type if it's needed.
+ */
+typedef struct
+{
+    GncGUID guid;
+    QofIdTypeConst type;
+    QofEventId event_mask; /**< The entity's events OR'ed together */
+} QofEventBatchEntry;
+
+/** Handler invoked once with a whole batch of events.
+ *
+ * @param entries: one entry per entity, grouped by entity type and
+ * otherwise in the order in which the entities first generated an event.
+ * @param n_entries: the number of entries.
+ * @param handler_data: the data supplied when the handler was registered.
+ */
+typedef void (*QofEventBatchHandler) (const QofEventBatchEntry *entries,
+                                      guint n_entries,
+                                      gpointer handler_data);
+
+/** \brief Register a handler that accepts event batches.
+ *
+ * Outside of a batch, handler is called for each event just as if it had
+ * been registered with qof_event_register_handler(). Between
+ * qof_event_begin_batch() and qof_event_end_batch() it isn't called;
+ * instead batch_handler is called once at the end of the batch. The
+ * per-event event_data is not available to batch handlers, so events
+ * that can't be handled without it can be listed in immediate_events:
+ * those still go to handler as they happen, and are left out of the
+ * batch entries.
+ *
+ * @param handler: the per-event handler
+ * @param batch_handler: the batch handler
+ * @param immediate_events: the events that aren't deferred to the batch
+ * @param handler_data: data provided when either handler is invoked
+ *
+ * @return id identifying handler, for qof_event_unregister_handler()
+ */
+gint qof_event_register_batch_handler (QofEventHandler handler,
+                                       QofEventBatchHandler batch_handler,
+                                       QofEventId immediate_events,
+                                       gpointer handler_data);
+
+/** \brief Begin collecting events into a batch.
+ *
+ * Events generated until the matching qof_event_end_batch() are
+ * coalesced per entity and passed to the batch handlers when the batch
+ * ends. Handlers registered with qof_event_register_handler() still get
+ * every event as it happens. Batches nest; only the outermost
+ * qof_event_end_batch() delivers the batch.
+ */
+void qof_event_begin_batch (void);
+
+/** End an event batch, delivering it if it's the outermost one. */
+void qof_event_end_batch (void);
+
 #ifdef __cplusplus
 }
 #endif
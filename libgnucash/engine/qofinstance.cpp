@@ -996,6 +996,7 @@ qof_commit_edit_part2(QofInstance *inst,
         !(priv->infant && priv->do_free)) {
       qof_collection_mark_dirty(priv->collection);
       qof_book_mark_session_dirty(priv->book);
+      qof_book_bump_generation(priv->book);
     }
 
     /* See if there's a backend.  If there is, invoke it. */
@@ -874,6 +874,75 @@ qof_query_run_subquery (QofQuery *subq, const QofQuery* primaryq)
                                   (gpointer)primaryq);
 }
 
+GList *
+qof_query_update_results (QofQuery *q, GList *removed, GList *candidates)
+{
+    if (!q) return NULL;
+    if (q->changed || q->max_results > -1)
+        return qof_query_run (q);
+
+    ENTER (" q=%p", q);
+    auto dropped = g_hash_table_new (g_direct_hash, g_direct_equal);
+    for (auto node = removed; node; node = node->next)
+        g_hash_table_add (dropped, node->data);
+    for (auto node = candidates; node; node = node->next)
+        g_hash_table_add (dropped, node->data);
+
+    GList *kept = NULL;
+    for (auto node = q->results; node; node = node->next)
+        if (!g_hash_table_contains (dropped, node->data))
+            kept = g_list_prepend (kept, node->data);
+    kept = g_list_reverse (kept);
+
+    /* Candidates may be listed more than once; they're matched once. */
+    GList *matches = NULL;
+    for (auto node = candidates; node; node = node->next)
+    {
+        auto inst = QOF_INSTANCE (node->data);
+        if (!g_hash_table_remove (dropped, inst) ||
+            g_strcmp0 (inst->e_type, q->search_for) ||
+            !g_list_find (q->books, qof_instance_get_book (inst)))
+            continue;
+        if (check_object (q, inst))
+            matches = g_list_prepend (matches, inst);
+    }
+    g_hash_table_destroy (dropped);
+
+    if (q->primary_sort.comp_fcn || q->primary_sort.obj_cmp ||
+            (q->primary_sort.use_default && q->defaultSort))
+    {
+        /* Merge the sorted matches into the still sorted results. */
+        matches = g_list_sort_with_data (matches, sort_func, q);
+        GList *merged = NULL;
+        auto old_node = kept, new_node = matches;
+        while (old_node || new_node)
+        {
+            if (!new_node ||
+                (old_node && sort_func (old_node->data, new_node->data, q) <= 0))
+            {
+                merged = g_list_prepend (merged, old_node->data);
+                old_node = old_node->next;
+            }
+            else
+            {
+                merged = g_list_prepend (merged, new_node->data);
+                new_node = new_node->next;
+            }
+        }
+        g_list_free (kept);
+        g_list_free (matches);
+        kept = g_list_reverse (merged);
+    }
+    else
+        kept = g_list_concat (kept, g_list_reverse (matches));
+
+    g_list_free (q->results);
+    q->results = kept;
+
+    LEAVE (" q=%p", q);
+    return kept;
+}
+
 GList *
 qof_query_last_run (QofQuery *query)
 {
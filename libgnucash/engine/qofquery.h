@@ -237,6 +237,22 @@ GList * qof_query_last_run (QofQuery *query);
 GList * qof_query_run_subquery (QofQuery *subquery,
                                 const QofQuery* primary_query);
 
+/** Bring the results of the last run of the query up to date without
+ *  running it over the whole book again. The objects in removed are
+ *  dropped from the results; they are only compared by address, so they
+ *  may have been freed. The objects in candidates, which were created or
+ *  changed since the last run, are checked against the query terms and
+ *  the matching ones are sorted into the results.
+ *
+ *  A query that was changed since its last run or that limits the number
+ *  of results is run again instead.
+ *
+ *  Do NOT free the resulting list.  This list is managed internally
+ *  by QofQuery.
+ */
+GList * qof_query_update_results (QofQuery *query, GList *removed,
+                                  GList *candidates);
+
 /** Remove all query terms from query.  query matches nothing
  *  after qof_query_clear().
  */
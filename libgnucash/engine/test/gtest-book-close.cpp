@@ -0,0 +1,126 @@
+/********************************************************************
+ * gtest-book-close.cpp: Test tearing down a whole book.            *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+#include <config.h>
+#include "../Account.h"
+#include "../SX-book.h"
+#include "../SchedXaction.h"
+#include "../Split.h"
+#include "../Transaction.h"
+#include "../cashobjects.h"
+#include "../gnc-commodity.h"
+#include "../gnc-event.h"
+#include <qof.h>
+
+#include <gtest/gtest.h>
+
+static void
+count_events (QofInstance *ent, QofEventId event_type,
+              gpointer handler_data, gpointer event_data)
+{
+    ++(*static_cast<int*>(handler_data));
+}
+
+/* The teardown code only runs for the objects registered with qof. Run
+ * these tests under valgrind or ASan to see that it doesn't touch freed
+ * splits or transactions. */
+class BookCloseTest : public testing::Test
+{
+protected:
+    static void SetUpTestSuite() {
+        qof_init();
+        cashobjects_register();
+    }
+    void SetUp() {
+        m_book = qof_book_new();
+        m_currency = gnc_commodity_new(m_book, "Gnu Rand", "CURRENCY",
+                                       "GNR", "", 240);
+        m_root = gnc_book_get_root_account(m_book);
+    }
+
+    Account* add_account()
+    {
+        auto acc = xaccMallocAccount(m_book);
+        xaccAccountBeginEdit(acc);
+        xaccAccountSetCommodity(acc, m_currency);
+        gnc_account_append_child(m_root, acc);
+        xaccAccountCommitEdit(acc);
+        return acc;
+    }
+
+    Split* add_transaction(Account* acc1, Account* acc2, gint64 amount)
+    {
+        auto txn = xaccMallocTransaction(m_book);
+        auto split1 = xaccMallocSplit(m_book);
+        auto split2 = xaccMallocSplit(m_book);
+        xaccTransBeginEdit(txn);
+        xaccTransSetCurrency(txn, m_currency);
+        xaccSplitSetParent(split1, txn);
+        xaccSplitSetParent(split2, txn);
+        xaccSplitSetAccount(split1, acc1);
+        xaccSplitSetAccount(split2, acc2);
+        xaccSplitSetValue(split1, gnc_numeric_create(amount, 240));
+        xaccSplitSetValue(split2, gnc_numeric_create(-amount, 240));
+        xaccTransCommitEdit(txn);
+        return split1;
+    }
+
+    QofBook* m_book {};
+    gnc_commodity* m_currency {};
+    Account* m_root {};
+};
+
+TEST_F(BookCloseTest, transactions)
+{
+    auto acc1 = add_account();
+    auto acc2 = add_account();
+    Split* split {};
+    int events = 0;
+
+    for (int i = 0; i < 10; ++i)
+        split = add_transaction(acc1, acc2, i);
+    g_object_add_weak_pointer(G_OBJECT(split),
+                              reinterpret_cast<void**>(&split));
+
+    auto hdlr = qof_event_register_handler(count_events, &events);
+    qof_book_destroy(m_book);
+    qof_event_unregister_handler(hdlr);
+
+    /* Only the book's own destroy event gets through. */
+    EXPECT_EQ(1, events);
+    EXPECT_EQ(nullptr, split);
+}
+
+TEST_F(BookCloseTest, scheduled_transactions)
+{
+    /* The template transactions are freed before their SX, which then
+     * mustn't find their splits in its template account. */
+    auto sx = xaccSchedXactionMalloc(m_book);
+    gnc_sxes_add_sx(gnc_book_get_schedxactions(m_book), sx);
+    auto split = add_transaction(sx->template_acct, sx->template_acct, 100);
+    add_transaction(add_account(), add_account(), 100);
+    ASSERT_EQ(2u, g_list_length(xaccAccountGetSplitList(sx->template_acct)));
+
+    g_object_add_weak_pointer(G_OBJECT(split),
+                              reinterpret_cast<void**>(&split));
+    qof_book_destroy(m_book);
+    EXPECT_EQ(nullptr, split);
+}
@@ -560,6 +560,103 @@ TEST(gnc_datetime_functions, test_format_zulu)
     EXPECT_EQ(atime.format_zulu("%d-%m-%Y %H:%M:%S"), "13-11-2045 12:00:00");
 }
 
+TEST(gnc_datetime_functions, test_parse_iso8601)
+{
+    const char* strings[] = {"2015-12-05 11:57:03", "1993-07-22 15:21:19 +0300",
+                             "1993-07-22 15:21:19 +0013", "1969-12-31 23:59:59 -1100",
+                             "2000-02-29 00:00:00 +0000", "1401-01-01 00:00:00",
+                             "9998-12-31 23:59:59"};
+    for (auto str : strings)
+    {
+        time64 time;
+        EXPECT_TRUE(GncDateTime::parse_iso8601(str, time)) << str;
+        EXPECT_EQ(static_cast<time64>(GncDateTime(str)), time) << str;
+    }
+
+    /* Left to the general parser. */
+    const char* others[] = {"20151205115703", "2015-12-05 11:57:03.25",
+                            "2015-12-05 11:57:03+0300", "2015-12-05 11:57:03 +03:00",
+                            "2015-02-29 11:57:03", "2015-12-05 24:00:00",
+                            "1400-01-01 00:00:00", "2015-12-05", ""};
+    for (auto str : others)
+    {
+        time64 time;
+        EXPECT_FALSE(GncDateTime::parse_iso8601(str, time)) << str;
+    }
+}
+
+TEST(gnc_datetime_functions, test_format_iso8601)
+{
+    time64 times[] = {0, -1, 2394187200, 1449316623, -12219292800, 253370764799};
+    for (auto time : times)
+    {
+        char buff[20];
+        EXPECT_EQ(19u, GncDateTime::format_iso8601(time, buff)) << time;
+        EXPECT_EQ(GncDateTime(time).format_iso8601(), buff) << time;
+    }
+    char buff[20];
+    EXPECT_EQ(0u, GncDateTime::format_iso8601(MINTIME, buff));
+}
+
+static bool
+same_tm (const struct tm& a, const struct tm& b)
+{
+    return a.tm_sec == b.tm_sec && a.tm_min == b.tm_min &&
+        a.tm_hour == b.tm_hour && a.tm_mday == b.tm_mday &&
+        a.tm_mon == b.tm_mon && a.tm_year == b.tm_year &&
+        a.tm_wday == b.tm_wday && a.tm_yday == b.tm_yday &&
+        a.tm_isdst == b.tm_isdst;
+}
+
+/* Steps through the days around each transition in quarter hours,
+ * checking the conversions both ways against the boost implementation.
+ */
+static void
+test_local_tm_around (time64 transition, const char* zone)
+{
+    for (auto time = transition - 86400; time < transition + 86400; time += 900)
+    {
+        struct tm tm;
+        ASSERT_TRUE(GncDateTime::to_local_tm(time, tm)) << zone << " " << time;
+        EXPECT_TRUE(same_tm(static_cast<struct tm>(GncDateTime(time)), tm))
+            << zone << " " << time;
+
+        /* Labels on the half hour land in the hours skipped or repeated. */
+        tm.tm_min = (tm.tm_min + 30) % 60;
+        tm.tm_isdst = -1;
+        auto label = tm;
+        time64 local;
+        if (!GncDateTime::from_local_tm(label, local))
+            continue;
+        GncDateTime gncdt(tm);
+        EXPECT_EQ(static_cast<time64>(gncdt), local) << zone << " " << time;
+        EXPECT_TRUE(same_tm(static_cast<struct tm>(gncdt), label))
+            << zone << " " << time;
+    }
+}
+
+TEST(gnc_datetime_functions, test_local_tm)
+{
+#ifdef __MINGW32__
+    TimeZoneProvider tzp_can{"A.U.S Eastern Standard Time"};
+    TimeZoneProvider tzp_la{"Pacific Standard Time"};
+#else
+    TimeZoneProvider tzp_can("Australia/Canberra");
+    TimeZoneProvider tzp_la("America/Los_Angeles");
+#endif
+    _set_tzp(tzp_la);
+    test_local_tm_around(1583657940, "Los Angeles");
+    test_local_tm_around(1604217540, "Los Angeles");
+    _reset_tzp();
+    _set_tzp(tzp_can);
+    test_local_tm_around(1601737140, "Canberra");
+    test_local_tm_around(1586008740, "Canberra");
+    _reset_tzp();
+
+    struct tm tm;
+    EXPECT_FALSE(GncDateTime::to_local_tm(MINTIME, tm));
+}
+
 //This is a bit convoluted because it uses GncDate's GncDateImpl constructor and year_month_day() function. There's no good way to test the former without violating the privacy of the implementation.
 TEST(gnc_datetime_functions, test_date)
 {
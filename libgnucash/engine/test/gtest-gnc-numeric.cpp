@@ -23,6 +23,7 @@
 #include <gtest/gtest.h>
 #include "../gnc-numeric.hpp"
 #include "../gnc-rational.hpp"
+#include "../gnc-numeric-accumulator.hpp"
 
 TEST(gncnumeric_constructors, test_default_constructor)
 {
@@ -601,3 +602,50 @@ TEST(gnc_numeric_functions, test_conversion_to_decimal)
     EXPECT_EQ(100, r.num());
     EXPECT_EQ(1, r.denom());
 }
+
+static void
+expect_same_numeric(gnc_numeric expected, gnc_numeric actual)
+{
+    EXPECT_EQ(expected.num, actual.num);
+    EXPECT_EQ(expected.denom, actual.denom);
+}
+
+TEST(gnc_numeric_accumulator, test_same_denominator)
+{
+    GncNumericAccumulator acc;
+    gnc_numeric sum = gnc_numeric_zero();
+    for (auto num : {12345, -678, 0, 99999, -100000})
+    {
+        auto amount = gnc_numeric_create(num, 100);
+        acc += amount;
+        sum = gnc_numeric_add_fixed(sum, amount);
+        expect_same_numeric(sum, acc.value());
+    }
+    expect_same_numeric(gnc_numeric_create(11666, 100), sum);
+}
+
+TEST(gnc_numeric_accumulator, test_mixed_denominators)
+{
+    GncNumericAccumulator acc{gnc_numeric_create(5, 1)};
+    gnc_numeric sum = gnc_numeric_create(5, 1);
+    for (auto amount : {gnc_numeric_create(125, 100),
+                        gnc_numeric_create(3, 1000),
+                        gnc_numeric_create(0, 7),
+                        gnc_numeric_create(1, 3),
+                        gnc_numeric_create(-7, 100)})
+    {
+        acc += amount;
+        sum = gnc_numeric_add_fixed(sum, amount);
+        expect_same_numeric(sum, acc.value());
+    }
+}
+
+TEST(gnc_numeric_accumulator, test_overflow)
+{
+    GncNumericAccumulator acc{gnc_numeric_create(INT64_MAX - 10, 100)};
+    auto amount = gnc_numeric_create(100, 100);
+    acc += amount;
+    expect_same_numeric(gnc_numeric_add_fixed(gnc_numeric_create(INT64_MAX - 10,
+                                                                 100), amount),
+                        acc.value());
+}
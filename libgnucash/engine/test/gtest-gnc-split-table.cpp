@@ -0,0 +1,224 @@
+/********************************************************************
+ * gtest-gnc-split-table.cpp: Test filtering, sorting and grouping  *
+ *                            splits with a GncSplitTable.          *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+#include <config.h>
+#include "../Account.h"
+#include "../Split.h"
+#include "../Transaction.h"
+#include "../gnc-commodity.h"
+#include "../gnc-split-table.h"
+#include <qof.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using SplitVec = std::vector<Split*>;
+
+class SplitTableTest : public testing::Test
+{
+protected:
+    void SetUp() {
+        m_book = qof_book_new();
+        m_currency = gnc_commodity_new(m_book, "US Dollar", "CURRENCY",
+                                       "USD", "840", 100);
+        m_root = gnc_account_create_root(m_book);
+        m_bank = create_account("Bank", ACCT_TYPE_BANK);
+        m_cash = create_account("Cash", ACCT_TYPE_CASH);
+        m_expense = create_account("Expense", ACCT_TYPE_EXPENSE);
+        m_income = create_account("Income", ACCT_TYPE_INCOME);
+
+        m_rent = create_split(m_bank, m_expense, 15, 1, "Rent", 10000);
+        m_groceries = create_split(m_cash, m_expense, 3, 1, "groceries", 2000);
+        m_store = create_split(m_bank, m_expense, 2, 2, "Grocery Store", 3000);
+        m_salary = create_split(m_cash, m_income, 20, 2, "Salary", -4000);
+        xaccTransSetNotes(xaccSplitGetParent(m_rent), "paid late");
+        m_splits = {m_rent, m_groceries, m_store, m_salary};
+    }
+    void TearDown() {
+        xaccAccountBeginEdit(m_root);
+        xaccAccountDestroy(m_root);
+        gnc_commodity_destroy(m_currency);
+        qof_book_destroy(m_book);
+    }
+
+    Account* create_account(const char* name, GNCAccountType type)
+    {
+        auto account = xaccMallocAccount(m_book);
+        xaccAccountBeginEdit(account);
+        xaccAccountSetName(account, name);
+        xaccAccountSetType(account, type);
+        xaccAccountSetCommodity(account, m_currency);
+        gnc_account_append_child(m_root, account);
+        xaccAccountCommitEdit(account);
+        return account;
+    }
+
+    /* Returns the split of a balanced transaction in account. */
+    Split* create_split(Account* account, Account* other, int day, int month,
+                        const char* description, gint64 amount)
+    {
+        auto trans = xaccMallocTransaction(m_book);
+        xaccTransBeginEdit(trans);
+        xaccTransSetCurrency(trans, m_currency);
+        xaccTransSetDescription(trans, description);
+        xaccTransSetDatePostedSecs(trans, gnc_dmy2time64_neutral(day, month, 2023));
+        auto value = gnc_numeric_create(amount, 100);
+        auto split = xaccMallocSplit(m_book);
+        xaccSplitSetParent(split, trans);
+        xaccSplitSetAccount(split, account);
+        xaccSplitSetAmount(split, value);
+        xaccSplitSetValue(split, value);
+        auto balance = xaccMallocSplit(m_book);
+        xaccSplitSetParent(balance, trans);
+        xaccSplitSetAccount(balance, other);
+        xaccSplitSetAmount(balance, gnc_numeric_neg(value));
+        xaccSplitSetValue(balance, gnc_numeric_neg(value));
+        xaccTransCommitEdit(trans);
+        return split;
+    }
+
+    GncSplitTable* new_table()
+    {
+        GList* splits = nullptr;
+        for (auto it = m_splits.rbegin(); it != m_splits.rend(); ++it)
+            splits = g_list_prepend(splits, *it);
+        auto table = gnc_split_table_new(splits);
+        g_list_free(splits);
+        return table;
+    }
+
+    static SplitVec rows(const GncSplitTable* table)
+    {
+        SplitVec rv;
+        auto splits = gnc_split_table_get_splits(table);
+        for (auto node = splits; node; node = node->next)
+            rv.push_back(GNC_SPLIT(node->data));
+        g_list_free(splits);
+        return rv;
+    }
+
+    QofBook* m_book {};
+    gnc_commodity* m_currency {};
+    Account* m_root {};
+    Account* m_bank {};
+    Account* m_cash {};
+    Account* m_expense {};
+    Account* m_income {};
+    Split* m_rent {};
+    Split* m_groceries {};
+    Split* m_store {};
+    Split* m_salary {};
+    SplitVec m_splits;
+};
+
+TEST_F(SplitTableTest, filter_other_accounts)
+{
+    auto accounts = g_list_prepend(nullptr, m_income);
+    auto table = new_table();
+    gnc_split_table_filter_other_accounts(table, accounts, FALSE);
+    EXPECT_EQ(SplitVec({m_salary}), rows(table));
+    gnc_split_table_free(table);
+
+    table = new_table();
+    gnc_split_table_filter_other_accounts(table, accounts, TRUE);
+    EXPECT_EQ(SplitVec({m_rent, m_groceries, m_store}), rows(table));
+    gnc_split_table_free(table);
+    g_list_free(accounts);
+}
+
+TEST_F(SplitTableTest, filter_text)
+{
+    auto table = new_table();
+    gnc_split_table_filter_text(table, "Grocer", FALSE, FALSE);
+    EXPECT_EQ(SplitVec({m_store}), rows(table));
+    gnc_split_table_free(table);
+
+    table = new_table();
+    gnc_split_table_filter_text(table, "grOCer", TRUE, FALSE);
+    EXPECT_EQ(SplitVec({m_groceries, m_store}), rows(table));
+    gnc_split_table_free(table);
+
+    table = new_table();
+    gnc_split_table_filter_text(table, "LATE", TRUE, TRUE);
+    EXPECT_EQ(SplitVec({m_groceries, m_store, m_salary}), rows(table));
+    gnc_split_table_free(table);
+
+    table = new_table();
+    gnc_split_table_filter_text(table, "", FALSE, TRUE);
+    EXPECT_EQ(m_splits, rows(table));
+    gnc_split_table_free(table);
+}
+
+TEST_F(SplitTableTest, sort)
+{
+    auto table = new_table();
+    gnc_split_table_add_sort_key(table, GNC_SPLIT_TABLE_KEY_ACCOUNT_NAME,
+                                 GNC_SPLIT_TABLE_PERIOD_NONE, FALSE);
+    gnc_split_table_add_sort_key(table, GNC_SPLIT_TABLE_KEY_DATE_POSTED,
+                                 GNC_SPLIT_TABLE_PERIOD_MONTH, TRUE);
+    gnc_split_table_sort(table);
+    EXPECT_EQ(SplitVec({m_groceries, m_salary, m_rent, m_store}), rows(table));
+    gnc_split_table_free(table);
+
+    /* Equal keys keep their order, missing notes come first. */
+    table = new_table();
+    gnc_split_table_add_sort_key(table, GNC_SPLIT_TABLE_KEY_NOTES,
+                                 GNC_SPLIT_TABLE_PERIOD_NONE, TRUE);
+    gnc_split_table_add_sort_key(table, GNC_SPLIT_TABLE_KEY_NONE,
+                                 GNC_SPLIT_TABLE_PERIOD_NONE, TRUE);
+    gnc_split_table_sort(table);
+    EXPECT_EQ(SplitVec({m_groceries, m_store, m_salary, m_rent}), rows(table));
+    gnc_split_table_free(table);
+
+    table = new_table();
+    gnc_split_table_add_sort_key(table, GNC_SPLIT_TABLE_KEY_VALUE,
+                                 GNC_SPLIT_TABLE_PERIOD_NONE, FALSE);
+    gnc_split_table_sort(table);
+    EXPECT_EQ(SplitVec({m_rent, m_store, m_groceries, m_salary}), rows(table));
+    gnc_split_table_free(table);
+}
+
+TEST_F(SplitTableTest, group_ends)
+{
+    auto table = new_table();
+    gnc_split_table_add_sort_key(table, GNC_SPLIT_TABLE_KEY_ACCOUNT_NAME,
+                                 GNC_SPLIT_TABLE_PERIOD_NONE, TRUE);
+    gnc_split_table_sort(table);
+    gnc_split_table_set_group_key(table, 0, GNC_SPLIT_TABLE_KEY_ACCOUNT_NAME,
+                                  GNC_SPLIT_TABLE_PERIOD_NONE);
+    gnc_split_table_set_group_key(table, 1, GNC_SPLIT_TABLE_KEY_DATE_POSTED,
+                                  GNC_SPLIT_TABLE_PERIOD_YEAR);
+    ASSERT_EQ(4u, gnc_split_table_get_size(table));
+    EXPECT_EQ(SplitVec({m_rent, m_store, m_groceries, m_salary}), rows(table));
+    EXPECT_FALSE(gnc_split_table_group_ends(table, 0, 0));
+    EXPECT_TRUE(gnc_split_table_group_ends(table, 1, 0));
+    EXPECT_FALSE(gnc_split_table_group_ends(table, 2, 0));
+    EXPECT_TRUE(gnc_split_table_group_ends(table, 3, 0));
+    EXPECT_FALSE(gnc_split_table_group_ends(table, 1, 1));
+    EXPECT_TRUE(gnc_split_table_group_ends(table, 3, 1));
+    EXPECT_FALSE(gnc_split_table_group_ends(table, 4, 0));
+
+    gnc_split_table_set_group_key(table, 1, GNC_SPLIT_TABLE_KEY_NONE,
+                                  GNC_SPLIT_TABLE_PERIOD_NONE);
+    EXPECT_FALSE(gnc_split_table_group_ends(table, 3, 1));
+    gnc_split_table_free(table);
+}
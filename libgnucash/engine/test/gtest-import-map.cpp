@@ -322,6 +322,36 @@ TEST_F(ImapBayesTest, AddAccountBayes)
     g_free (acct2_guid);
 }
 
+TEST_F(ImapBayesTest, FindAccountBayesAfterChanges)
+{
+    // prevent the embedded beginedit/committedit from doing anything
+    qof_instance_increase_editlevel(QOF_INSTANCE(t_bank_account));
+    gnc_account_imap_add_account_bayes(t_acc, t_list1, t_expense_account1);
+    EXPECT_EQ(t_expense_account1, gnc_account_imap_find_account_bayes(t_acc, t_list1));
+    EXPECT_EQ(nullptr, gnc_account_imap_find_account_bayes(t_acc, t_list2));
+
+    // The lookups above must see what's added after them.
+    gnc_account_imap_add_account_bayes(t_acc, t_list1, t_expense_account2);
+    EXPECT_EQ(nullptr, gnc_account_imap_find_account_bayes(t_acc, t_list1));
+    for (int i = 0; i < 3; ++i)
+        gnc_account_imap_add_account_bayes(t_acc, t_list1, t_expense_account2);
+    EXPECT_EQ(t_expense_account2, gnc_account_imap_find_account_bayes(t_acc, t_list1));
+    gnc_account_imap_add_account_bayes(t_acc, t_list2, t_expense_account1);
+    EXPECT_EQ(t_expense_account1, gnc_account_imap_find_account_bayes(t_acc, t_list2));
+
+    auto root = qof_instance_get_slots(QOF_INSTANCE(t_bank_account));
+    auto acct2_guid = guid_to_string (xaccAccountGetGUID(t_expense_account2));
+    auto value = root->get_slot({std::string{IMAP_FRAME_BAYES} + "/" + foo + "/" + acct2_guid});
+    EXPECT_EQ(4, value->get<int64_t>());
+
+    gnc_account_delete_all_bayes_maps(t_acc);
+    EXPECT_EQ(nullptr, gnc_account_imap_find_account_bayes(t_acc, t_list1));
+    EXPECT_EQ(nullptr, gnc_account_imap_find_account_bayes(t_acc, t_list2));
+    qof_instance_mark_clean(QOF_INSTANCE(t_bank_account));
+    qof_instance_reset_editlevel(QOF_INSTANCE(t_bank_account));
+    g_free (acct2_guid);
+}
+
 TEST_F(ImapBayesTest, ConvertBayesData)
 {
     auto root = qof_instance_get_slots(QOF_INSTANCE(t_bank_account));
@@ -28,6 +28,7 @@
 #include "../qofevent.h"
 #include "../qofevent-p.h"
 #include <gtest/gtest.h>
+#include <vector>
 
 static void
 easy_handler (QofInstance *ent,  QofEventId event_type,
@@ -134,3 +135,143 @@ TEST (qofevent, compound_events)
     qof_event_unregister_handler (id5);
 }
 
+
+struct BatchCounts
+{
+    int events = 0;
+    int batches = 0;
+    std::vector<QofEventBatchEntry> entries;
+};
+
+static void
+batch_event_handler (QofInstance *ent,  QofEventId event_type,
+                     gpointer handler_data, gpointer event_data)
+{
+    auto counts = static_cast<BatchCounts*>(handler_data);
+    ++counts->events;
+}
+
+static void
+batch_handler (const QofEventBatchEntry *entries, guint n_entries,
+               gpointer handler_data)
+{
+    auto counts = static_cast<BatchCounts*>(handler_data);
+    ++counts->batches;
+    counts->entries.assign (entries, entries + n_entries);
+}
+
+TEST (qofevent, batch_events)
+{
+    auto book = qof_book_new ();
+    auto inst1 = static_cast<QofInstance*>(g_object_new (QOF_TYPE_INSTANCE, nullptr));
+    auto inst2 = static_cast<QofInstance*>(g_object_new (QOF_TYPE_INSTANCE, nullptr));
+    auto inst3 = static_cast<QofInstance*>(g_object_new (QOF_TYPE_INSTANCE, nullptr));
+    qof_instance_init_data (inst1, "Zebra", book);
+    qof_instance_init_data (inst2, "Aardvark", book);
+    qof_instance_init_data (inst3, "Zebra", book);
+    BatchCounts plain, batched;
+
+    auto id1 = qof_event_register_handler (batch_event_handler, &plain);
+    auto id2 = qof_event_register_batch_handler (batch_event_handler,
+                                                 batch_handler, QOF_EVENT_NONE,
+                                                 &batched);
+
+    // Outside of a batch both get every event.
+    qof_event_gen (inst1, QOF_EVENT_MODIFY, nullptr);
+    EXPECT_EQ (plain.events, 1);
+    EXPECT_EQ (batched.events, 1);
+    EXPECT_EQ (batched.batches, 0);
+
+    qof_event_begin_batch ();
+    qof_event_gen (inst1, QOF_EVENT_CREATE, nullptr);
+    qof_event_gen (inst2, QOF_EVENT_MODIFY, nullptr);
+    qof_event_begin_batch ();
+    qof_event_gen (inst3, QOF_EVENT_MODIFY, nullptr);
+    qof_event_gen (inst1, QOF_EVENT_MODIFY, nullptr);
+    qof_event_end_batch ();
+    // Nested end doesn't deliver the batch.
+    EXPECT_EQ (batched.batches, 0);
+    qof_event_gen (inst1, QOF_EVENT_DESTROY, nullptr);
+    qof_event_end_batch ();
+
+    EXPECT_EQ (plain.events, 6);
+    EXPECT_EQ (batched.events, 1);
+    EXPECT_EQ (batched.batches, 1);
+    // One entry per entity, grouped by type, first-event order within type.
+    ASSERT_EQ (batched.entries.size (), 3u);
+    EXPECT_TRUE (guid_equal (&batched.entries[0].guid,
+                             qof_instance_get_guid (inst2)));
+    EXPECT_EQ (batched.entries[0].event_mask, QOF_EVENT_MODIFY);
+    EXPECT_TRUE (guid_equal (&batched.entries[1].guid,
+                             qof_instance_get_guid (inst1)));
+    EXPECT_EQ (batched.entries[1].event_mask,
+               QOF_EVENT_CREATE | QOF_EVENT_MODIFY | QOF_EVENT_DESTROY);
+    EXPECT_STREQ (batched.entries[1].type, "Zebra");
+    EXPECT_TRUE (guid_equal (&batched.entries[2].guid,
+                             qof_instance_get_guid (inst3)));
+
+    // Forced events bypass the batch.
+    qof_event_begin_batch ();
+    qof_event_force (inst1, QOF_EVENT_DESTROY, nullptr);
+    EXPECT_EQ (batched.events, 2);
+    qof_event_end_batch ();
+    EXPECT_EQ (batched.batches, 1);
+
+    // Suspended events aren't collected.
+    qof_event_suspend ();
+    qof_event_begin_batch ();
+    qof_event_gen (inst1, QOF_EVENT_MODIFY, nullptr);
+    qof_event_end_batch ();
+    qof_event_resume ();
+    EXPECT_EQ (batched.batches, 1);
+
+    qof_event_unregister_handler (id2);
+    qof_event_unregister_handler (id1);
+    g_object_unref (inst1);
+    g_object_unref (inst2);
+    g_object_unref (inst3);
+    qof_book_destroy (book);
+}
+
+TEST (qofevent, batch_immediate_events)
+{
+    auto book = qof_book_new ();
+    auto inst1 = static_cast<QofInstance*>(g_object_new (QOF_TYPE_INSTANCE, nullptr));
+    auto inst2 = static_cast<QofInstance*>(g_object_new (QOF_TYPE_INSTANCE, nullptr));
+    qof_instance_init_data (inst1, "Zebra", book);
+    qof_instance_init_data (inst2, "Zebra", book);
+    BatchCounts batched;
+
+    auto id = qof_event_register_batch_handler (batch_event_handler,
+                                                batch_handler,
+                                                QOF_EVENT_ADD | QOF_EVENT_REMOVE,
+                                                &batched);
+
+    qof_event_begin_batch ();
+    qof_event_gen (inst1, QOF_EVENT_ADD, nullptr);
+    qof_event_gen (inst1, QOF_EVENT_MODIFY, nullptr);
+    qof_event_gen (inst1, QOF_EVENT_MODIFY, nullptr);
+    qof_event_gen (inst2, QOF_EVENT_REMOVE, nullptr);
+    // The immediate events are delivered as they happen...
+    EXPECT_EQ (batched.events, 2);
+    qof_event_end_batch ();
+
+    // ... and the batch only holds the deferred ones.
+    EXPECT_EQ (batched.batches, 1);
+    ASSERT_EQ (batched.entries.size (), 1u);
+    EXPECT_TRUE (guid_equal (&batched.entries[0].guid,
+                             qof_instance_get_guid (inst1)));
+    EXPECT_EQ (batched.entries[0].event_mask, QOF_EVENT_MODIFY);
+
+    // A batch of immediate events only isn't delivered at all.
+    qof_event_begin_batch ();
+    qof_event_gen (inst2, QOF_EVENT_ADD, nullptr);
+    qof_event_end_batch ();
+    EXPECT_EQ (batched.events, 3);
+    EXPECT_EQ (batched.batches, 1);
+
+    qof_event_unregister_handler (id);
+    g_object_unref (inst1);
+    g_object_unref (inst2);
+    qof_book_destroy (book);
+}
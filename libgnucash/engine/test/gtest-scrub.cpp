@@ -0,0 +1,166 @@
+/********************************************************************
+ * gtest-scrub.cpp: Test resuming an aborted Check & Repair.        *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+#include <config.h>
+#include "../Account.h"
+#include "../Scrub.h"
+#include "../Split.h"
+#include "../Transaction.h"
+#include "../gnc-commodity.h"
+#include "../gnc-session.h"
+#include <qof.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+static int repair_progress_calls;
+static int check_progress_calls;
+static int abort_after;
+
+static void
+count_progress (const char* message, double percent)
+{
+    if (!message)
+        return;
+    std::string msg {message};
+    if (msg.rfind ("Repairing", 0) == 0)
+    {
+        if (++repair_progress_calls == abort_after)
+            gnc_set_abort_scrub (TRUE);
+    }
+    else
+        ++check_progress_calls;
+}
+
+class ScrubTest : public testing::Test
+{
+protected:
+    void SetUp() {
+        m_book = qof_session_get_book(gnc_get_current_session());
+        m_currency = gnc_commodity_new(m_book, "US Dollar", "CURRENCY",
+                                       "USD", "840", 100);
+        m_root = gnc_book_get_root_account(m_book);
+        m_bank = xaccMallocAccount(m_book);
+        xaccAccountBeginEdit(m_bank);
+        xaccAccountSetName(m_bank, "Bank");
+        xaccAccountSetType(m_bank, ACCT_TYPE_BANK);
+        xaccAccountSetCommodity(m_bank, m_currency);
+        gnc_account_append_child(m_root, m_bank);
+        xaccAccountCommitEdit(m_bank);
+
+        for (int i = 0; i < 250; ++i)
+            m_transactions.push_back(create_unbalanced(i + 1));
+
+        repair_progress_calls = check_progress_calls = abort_after = 0;
+        gnc_set_abort_scrub (FALSE);
+    }
+    void TearDown() {
+        gnc_set_abort_scrub (FALSE);
+        gnc_clear_current_session();
+    }
+
+    Transaction* create_unbalanced(gint64 amount)
+    {
+        auto trans = xaccMallocTransaction(m_book);
+        xaccTransBeginEdit(trans);
+        xaccTransSetCurrency(trans, m_currency);
+        xaccTransSetDatePostedSecs(trans, gnc_dmy2time64_neutral(1, 1, 2023));
+        auto value = gnc_numeric_create(amount, 100);
+        auto split = xaccMallocSplit(m_book);
+        xaccSplitSetParent(split, trans);
+        xaccSplitSetAccount(split, m_bank);
+        xaccSplitSetAmount(split, value);
+        xaccSplitSetValue(split, value);
+        xaccTransCommitEdit(trans);
+        return trans;
+    }
+
+    long balanced() const
+    {
+        return std::count_if(m_transactions.begin(), m_transactions.end(),
+                             [](auto trans){ return xaccTransIsBalanced(trans); });
+    }
+
+    QofBook* m_book {};
+    gnc_commodity* m_currency {};
+    Account* m_root {};
+    Account* m_bank {};
+    std::vector<Transaction*> m_transactions;
+};
+
+TEST_F(ScrubTest, imbalance)
+{
+    EXPECT_EQ(0, balanced());
+    xaccAccountScrubImbalance(m_bank, count_progress);
+    EXPECT_EQ(250, balanced());
+    EXPECT_GT(check_progress_calls, 0);
+    EXPECT_EQ(3, repair_progress_calls);
+}
+
+TEST_F(ScrubTest, resume_imbalance)
+{
+    /* Stop after the first batch of repairs. */
+    abort_after = 2;
+    xaccAccountScrubImbalance(m_bank, count_progress);
+    EXPECT_EQ(100, balanced());
+
+    /* Running it again doesn't check the transactions again. */
+    gnc_set_abort_scrub (FALSE);
+    repair_progress_calls = check_progress_calls = abort_after = 0;
+    xaccAccountScrubImbalance(m_bank, count_progress);
+    EXPECT_EQ(250, balanced());
+    EXPECT_EQ(0, check_progress_calls);
+    EXPECT_EQ(2, repair_progress_calls);
+
+    /* Nor is there anything left to resume afterwards. */
+    xaccAccountScrubImbalance(m_bank, count_progress);
+    EXPECT_GT(check_progress_calls, 0);
+    EXPECT_EQ(2, repair_progress_calls);
+}
+
+TEST_F(ScrubTest, resume_after_edit)
+{
+    abort_after = 2;
+    xaccAccountScrubImbalance(m_bank, count_progress);
+    EXPECT_EQ(100, balanced());
+
+    /* Unbalance one of the transactions the aborted run repaired. */
+    auto trans = *std::find_if(m_transactions.begin(), m_transactions.end(),
+                               [](auto trans){ return xaccTransIsBalanced(trans); });
+    auto value = gnc_numeric_create(1, 100);
+    xaccTransBeginEdit(trans);
+    auto split = xaccMallocSplit(m_book);
+    xaccSplitSetParent(split, trans);
+    xaccSplitSetAccount(split, m_bank);
+    xaccSplitSetAmount(split, value);
+    xaccSplitSetValue(split, value);
+    xaccTransCommitEdit(trans);
+    EXPECT_EQ(99, balanced());
+
+    /* The edit makes it check all of them again. */
+    gnc_set_abort_scrub (FALSE);
+    repair_progress_calls = check_progress_calls = abort_after = 0;
+    xaccAccountScrubImbalance(m_bank, count_progress);
+    EXPECT_GT(check_progress_calls, 0);
+    EXPECT_EQ(250, balanced());
+}
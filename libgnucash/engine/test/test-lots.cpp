@@ -32,6 +32,7 @@
 #include "Account.h"
 #include "gnc-lot.h"
 #include "Scrub3.h"
+#include "cap-gains.h"
 #include "cashobjects.h"
 #include "test-stuff.h"
 #include "test-engine-stuff.h"
@@ -82,6 +83,70 @@ test_lot_kvp ()
     qof_session_destroy (sess);
 }
 
+/* The lot finders as they were before the account kept an index. */
+static GNCLot *
+find_open_lot_by_scan (Account *acc, gboolean positive,
+                       gnc_commodity *currency, gboolean latest)
+{
+    GNCLot *found = NULL;
+    time64 found_time = latest ? G_MININT64 : G_MAXINT64;
+    GList *lots = xaccAccountGetLotList (acc);
+
+    for (GList *node = lots; node; node = node->next)
+    {
+        GNCLot *lot = GNC_LOT (node->data);
+        if (gnc_lot_is_closed (lot)) continue;
+        Split *s = gnc_lot_get_earliest_split (lot);
+        if (!s) continue;
+        gnc_numeric amount = xaccSplitGetAmount (s);
+        if (!(positive ? gnc_numeric_negative_p (amount) : gnc_numeric_positive_p (amount)))
+            continue;
+        if (gnc_numeric_positive_p (amount) != gnc_numeric_positive_p (gnc_lot_get_balance (lot)))
+            continue;
+        Transaction *trans = xaccSplitGetParent (s);
+        if (currency && !gnc_commodity_equiv (currency, xaccTransGetCurrency (trans)))
+            continue;
+        time64 posted = xaccTransRetDatePosted (trans);
+        if (latest ? found_time < posted : found_time > posted)
+        {
+            found_time = posted;
+            found = lot;
+        }
+    }
+    g_list_free (lots);
+    return found;
+}
+
+static void
+check_open_lot_finders (Account *acc)
+{
+    gnc_numeric signs[] = { gnc_numeric_create (1, 1), gnc_numeric_create (-1, 1) };
+    GList *lots = xaccAccountGetLotList (acc);
+    gnc_commodity *currency = NULL;
+
+    if (lots && gnc_lot_get_earliest_split (GNC_LOT (lots->data)))
+        currency = xaccTransGetCurrency (xaccSplitGetParent (gnc_lot_get_earliest_split (GNC_LOT (lots->data))));
+    g_list_free (lots);
+
+    for (auto sign : signs)
+    {
+        gboolean positive = gnc_numeric_positive_p (sign);
+        do_test (xaccAccountFindEarliestOpenLot (acc, sign, NULL) ==
+                 find_open_lot_by_scan (acc, positive, NULL, FALSE),
+                 "earliest open lot");
+        do_test (xaccAccountFindLatestOpenLot (acc, sign, NULL) ==
+                 find_open_lot_by_scan (acc, positive, NULL, TRUE),
+                 "latest open lot");
+        if (!currency) continue;
+        do_test (xaccAccountFindEarliestOpenLot (acc, sign, currency) ==
+                 find_open_lot_by_scan (acc, positive, currency, FALSE),
+                 "earliest open lot in currency");
+        do_test (xaccAccountFindLatestOpenLot (acc, sign, currency) ==
+                 find_open_lot_by_scan (acc, positive, currency, TRUE),
+                 "latest open lot in currency");
+    }
+}
+
 static void
 run_test (void)
 {
@@ -101,6 +166,11 @@ run_test (void)
     root = gnc_book_get_root_account (book);
     xaccAccountTreeScrubLots (root);
 
+    GList *accounts = gnc_account_get_descendants (root);
+    for (GList *node = accounts; node; node = node->next)
+        check_open_lot_finders (GNC_ACCOUNT (node->data));
+    g_list_free (accounts);
+
     /* --------------------------------------------------------- */
     /* In the second test, we create an account with unrealized gains,
      * and see if that gets fixed correctly, with the correct balances,
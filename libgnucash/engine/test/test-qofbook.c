@@ -696,6 +696,24 @@ test_book_get_session_dirty_time( Fixture *fixture, gconstpointer pData )
 
 }
 
+static void
+test_book_get_generation( Fixture *fixture, gconstpointer pData )
+{
+    Account *root = gnc_account_create_root( fixture->book );
+    guint64 generation = qof_book_get_generation( fixture->book );
+
+    g_test_message( "Testing generation grows on each committed change" );
+    xaccAccountBeginEdit( root );
+    xaccAccountSetName( root, "foo" );
+    xaccAccountCommitEdit( root );
+    g_assert_cmpuint( qof_book_get_generation( fixture->book ), > , generation );
+    generation = qof_book_get_generation( fixture->book );
+    xaccAccountBeginEdit( root );
+    xaccAccountSetName( root, "bar" );
+    xaccAccountCommitEdit( root );
+    g_assert_cmpuint( qof_book_get_generation( fixture->book ), > , generation );
+}
+
 static void
 test_book_set_dirty_cb( Fixture *fixture, gconstpointer pData )
 {
@@ -986,6 +1004,7 @@ test_suite_qofbook ( void )
     GNC_TEST_ADD( suitename, "use split action for num field", Fixture, NULL, setup, test_book_use_split_action_for_num_field, teardown );
     GNC_TEST_ADD( suitename, "mark session dirty", Fixture, NULL, setup, test_book_mark_session_dirty, teardown );
     GNC_TEST_ADD( suitename, "session dirty time", Fixture, NULL, setup, test_book_get_session_dirty_time, teardown );
+    GNC_TEST_ADD( suitename, "generation", Fixture, NULL, setup, test_book_get_generation, teardown );
     GNC_TEST_ADD( suitename, "set dirty callback", Fixture, NULL, setup, test_book_set_dirty_cb, teardown );
     GNC_TEST_ADD( suitename, "shutting down", Fixture, NULL, setup, test_book_shutting_down, teardown );
     GNC_TEST_ADD( suitename, "set get data", Fixture, NULL, setup, test_book_set_get_data, teardown );
@@ -26,6 +26,8 @@
 #include "qof.h"
 #include "cashobjects.h"
 #include "Transaction.h"
+#include "Account.h"
+#include "Query.h"
 #include "TransLog.h"
 #include "gnc-engine.h"
 #include "test-engine-stuff.h"
@@ -64,6 +66,121 @@ test_trans_query (Transaction *trans, gpointer data)
     return 0;
 }
 
+static int
+collect_splits (Transaction *trans, gpointer data)
+{
+    auto splits = static_cast<GList**>(data);
+    for (GList *node = xaccTransGetSplitList (trans); node; node = node->next)
+        *splits = g_list_prepend (*splits, node->data);
+    return 0;
+}
+
+static gboolean
+same_list (GList *a, GList *b)
+{
+    for (; a && b; a = a->next, b = b->next)
+        if (a->data != b->data)
+            return FALSE;
+    return !a && !b;
+}
+
+static int
+collect_transactions (Transaction *trans, gpointer data)
+{
+    g_hash_table_add (static_cast<GHashTable*>(data), trans);
+    return 0;
+}
+
+static gboolean
+any_in_list (GList *a, GList *b)
+{
+    for (; a; a = a->next)
+        if (g_list_find (b, a->data))
+            return TRUE;
+    return FALSE;
+}
+
+/* Updating the results with the changed splits gives the same list as
+ * running the query again. */
+static void
+test_update_results (QofBook *book, Account *root)
+{
+    /* Query the account with the most splits, so that there are likely
+     * some left after destroying one of its transactions. */
+    GList *accounts = gnc_account_get_descendants (root);
+    Account *acc = NULL;
+    guint most_splits = 0;
+    for (GList *node = accounts; node; node = node->next)
+    {
+        guint num_splits = g_list_length (xaccAccountGetSplitList (GNC_ACCOUNT (node->data)));
+        if (num_splits > most_splits)
+        {
+            acc = GNC_ACCOUNT (node->data);
+            most_splits = num_splits;
+        }
+    }
+    g_list_free (accounts);
+    if (most_splits < 2)
+        return;
+
+    QofQuery *q = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (q, book);
+    GList *match = g_list_prepend (NULL, acc);
+    xaccQueryAddAccountMatch (q, match, QOF_GUID_MATCH_ANY, QOF_QUERY_AND);
+    g_list_free (match);
+    GList *old_results = g_list_copy (qof_query_run (q));
+
+    /* Destroy the transaction of the first result, clone the one of the
+     * last so that the results get a new split sorting right next to an
+     * old one, and add some random ones. */
+    Transaction *destroyed = xaccSplitGetParent (GNC_SPLIT (old_results->data));
+    Transaction *cloned = xaccSplitGetParent (GNC_SPLIT (g_list_last (old_results)->data));
+    if (cloned == destroyed)
+    {
+        g_list_free (old_results);
+        qof_query_destroy (q);
+        return;
+    }
+    GList *removed = g_list_copy (xaccTransGetSplitList (destroyed));
+    xaccTransBeginEdit (destroyed);
+    xaccTransDestroy (destroyed);
+    xaccTransCommitEdit (destroyed);
+
+    GHashTable *old_transactions = g_hash_table_new (g_direct_hash, g_direct_equal);
+    xaccAccountTreeForEachTransaction (root, collect_transactions, old_transactions);
+    xaccTransClone (cloned);
+    add_random_transactions_to_book (book, 5);
+
+    /* The candidates are the splits of the new transactions only. */
+    GHashTable *transactions = g_hash_table_new (g_direct_hash, g_direct_equal);
+    xaccAccountTreeForEachTransaction (root, collect_transactions, transactions);
+    GList *candidates = NULL;
+    GHashTableIter iter;
+    gpointer trans;
+    g_hash_table_iter_init (&iter, transactions);
+    while (g_hash_table_iter_next (&iter, &trans, NULL))
+        if (!g_hash_table_contains (old_transactions, trans))
+            collect_splits (GNC_TRANSACTION (trans), &candidates);
+    g_hash_table_destroy (transactions);
+    g_hash_table_destroy (old_transactions);
+
+    GList *results = qof_query_update_results (q, removed, candidates);
+    do_test (any_in_list (results, old_results),
+             "updated query results keep old results");
+    do_test (any_in_list (results, candidates),
+             "updated query results get new results");
+
+    QofQuery *fresh = qof_query_copy (q);
+    do_test (same_list (results, qof_query_run (fresh)),
+             "updated query results");
+
+    g_list_free (candidates);
+    g_list_free (removed);
+    g_list_free (old_results);
+    qof_query_destroy (fresh);
+    qof_query_destroy (q);
+}
+
 static void
 run_test (void)
 {
@@ -78,6 +195,7 @@ run_test (void)
     add_random_transactions_to_book (book, 20);
 
     xaccAccountTreeForEachTransaction (root, test_trans_query, book);
+    test_update_results (book, root);
 
     qof_session_destroy (session);
 }
@@ -34,6 +34,7 @@
 #include "../Split.h"
 #include "../Transaction.h"
 #include "../gnc-lot.h"
+#include "../gnc-split-cursor.h"
 
 #if defined(__clang__) && (__clang_major__ == 5 || (__clang_major__ == 3 && __clang_minor__ < 5))
 #define USE_CLANG_FUNC_SIG 1
@@ -43,6 +44,8 @@ extern "C" void test_suite_account (void);
 
 #include <qofinstance-p.h>
 #include <kvp-frame.hpp>
+#include <algorithm>
+#include <vector>
 
 typedef struct
 {
@@ -2251,6 +2254,80 @@ test_xaccAccountGetBalanceAsOfDate (Fixture *fixture, gconstpointer pData)
     dval = gnc_numeric_to_double (val);
     g_assert_cmpfloat (dval, == , dbal);
 }
+/* xaccAccountGetSplitsAtDates
+void
+xaccAccountGetSplitsAtDates (Account *acc, size_t n_dates, const time64 *dates, Split **splits)
+xaccAccountGetBalancesAtDates (Account *acc, size_t n_dates, const time64 *dates, gnc_numeric *balances)
+*/
+static void
+test_xaccAccountGetBalancesAtDates (Fixture *fixture, gconstpointer pData)
+{
+    std::vector<time64> dates;
+    xaccAccountRecomputeBalance (fixture->acct);
+    for (auto node = xaccAccountGetSplitList (fixture->acct); node; node = node->next)
+    {
+        auto date = xaccTransGetDate (xaccSplitGetParent (static_cast<Split*>(node->data)));
+        dates.insert (dates.end(), { date - 1, date, date + 1 });
+    }
+    std::sort (dates.begin(), dates.end());
+    dates.insert (dates.begin(), dates.front());
+    g_assert_cmpint (dates.size(), >, 3);
+
+    std::vector<Split*> splits (dates.size());
+    std::vector<gnc_numeric> balances (dates.size());
+    xaccAccountGetSplitsAtDates (fixture->acct, dates.size(), dates.data(), splits.data());
+    xaccAccountGetBalancesAtDates (fixture->acct, dates.size(), dates.data(), balances.data());
+    g_assert_null (splits.front());
+    for (size_t i = 0; i < dates.size(); i++)
+    {
+        /* xaccAccountGetBalanceAsOfDate excludes the date itself. */
+        auto expected = xaccAccountGetBalanceAsOfDate (fixture->acct, dates[i] + 1);
+        g_assert_true (gnc_numeric_equal (balances[i], expected));
+        if (splits[i])
+        {
+            g_assert_true (gnc_numeric_equal (xaccSplitGetBalance (splits[i]), expected));
+            g_assert_cmpint (xaccTransGetDate (xaccSplitGetParent (splits[i])), <=, dates[i]);
+        }
+    }
+}
+/* gnc_split_cursor_new_for_account
+GncSplitCursor *
+gnc_split_cursor_new_for_account (Account *acc)
+size_t
+gnc_split_cursor_next (GncSplitCursor *cursor, size_t n, Split **splits)
+*/
+static void
+test_gnc_split_cursor (Fixture *fixture, gconstpointer pData)
+{
+    auto list = xaccAccountGetSplitList (fixture->acct);
+    g_assert_cmpint (g_list_length (list), >=, 3);
+
+    std::vector<Split*> walked;
+    Split *batch[2];
+    auto cursor = gnc_split_cursor_new_for_account (fixture->acct);
+    while (auto count = gnc_split_cursor_next (cursor, 2, batch))
+        walked.insert (walked.end(), batch, batch + count);
+    g_assert_cmpint (gnc_split_cursor_next (cursor, 2, batch), ==, 0);
+    gnc_split_cursor_free (cursor);
+
+    g_assert_cmpint (walked.size(), ==, g_list_length (list));
+    for (auto split : walked)
+    {
+        g_assert_true (split == list->data);
+        list = list->next;
+    }
+
+    /* Removing a split that wasn't returned yet continues at the same
+     * position instead of following a stale list node. */
+    cursor = gnc_split_cursor_new_for_account (fixture->acct);
+    g_assert_cmpint (gnc_split_cursor_next (cursor, 1, batch), ==, 1);
+    g_assert_true (batch[0] == walked[0]);
+    g_assert_true (gnc_account_remove_split (fixture->acct, walked[1]));
+    g_assert_cmpint (gnc_split_cursor_next (cursor, 1, batch), ==, 1);
+    g_assert_true (batch[0] == walked[2]);
+    gnc_split_cursor_free (cursor);
+    g_assert_true (gnc_account_insert_split (fixture->acct, walked[1]));
+}
 /* xaccAccountGetPresentBalance
 gnc_numeric
 xaccAccountGetPresentBalance (const Account *acc)// C: 4 in 2 */
@@ -2879,6 +2956,8 @@ test_suite_account (void)
     GNC_TEST_ADD (suitename, "gnc account get full name", Fixture, &good_data, setup, test_gnc_account_get_full_name,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetProjectedMinimumBalance", Fixture, &some_data, setup, test_xaccAccountGetProjectedMinimumBalance,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetBalanceAsOfDate", Fixture, &some_data, setup, test_xaccAccountGetBalanceAsOfDate,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountGetBalancesAtDates", Fixture, &some_data, setup, test_xaccAccountGetBalancesAtDates,  teardown );
+    GNC_TEST_ADD (suitename, "gnc split cursor", Fixture, &some_data, setup, test_gnc_split_cursor,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetPresentBalance", Fixture, &some_data, setup, test_xaccAccountGetPresentBalance,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountFindOpenLots", Fixture, &complex_data, setup, test_xaccAccountFindOpenLots,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountForEachLot", Fixture, &complex_data, setup, test_xaccAccountForEachLot,  teardown );
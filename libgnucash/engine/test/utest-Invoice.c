@@ -384,6 +384,61 @@ test_xaccTransGetTxnTypeLink (Fixture *fixture, gconstpointer pData)
     g_assert_cmpint (TXN_TYPE_LINK, ==, xaccTransGetTxnType (fixture->trans2));
 }
 
+static void
+test_owner_balance (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_book_get_root_account (fixture->book);
+    gnc_numeric amt = gnc_numeric_create (400, 100);
+    time64 ts = gnc_time (NULL);
+    GncEntry *entry;
+    GNCLot *lot;
+    Split *split, *payment;
+
+    gnc_account_append_child (root, fixture->account);
+    gnc_account_append_child (root, fixture->account2);
+    gncCustomerSetCurrency (fixture->customer, fixture->commodity);
+    g_assert_true (gnc_numeric_zero_p (gncOwnerGetBalanceInCurrency (&fixture->owner, NULL)));
+
+    gncInvoiceSetCurrency (fixture->invoice, fixture->commodity);
+    gncInvoiceSetOwner (fixture->invoice, &fixture->owner);
+    entry = gncEntryCreate (fixture->book);
+    gncEntrySetDate (entry, ts);
+    gncEntrySetDateEntered (entry, ts);
+    gncEntrySetDocQuantity (entry, gnc_numeric_create (1, 1), FALSE);
+    gncEntrySetInvPrice (entry, gnc_numeric_create (1000, 100));
+    gncEntrySetInvAccount (entry, fixture->account);
+    gncInvoiceAddEntry (fixture->invoice, entry);
+    gncInvoicePostToAccount (fixture->invoice, fixture->account2, ts, ts,
+                             "memo", TRUE, FALSE);
+    lot = gncInvoiceGetPostedLot (fixture->invoice);
+    g_assert_true (gnc_numeric_equal (gnc_numeric_create (1000, 100),
+                                      gncOwnerGetBalanceInCurrency (&fixture->owner, NULL)));
+
+    /* A partial payment added to the lot is picked up from its event. */
+    fixture->trans2 = xaccMallocTransaction (fixture->book);
+    xaccTransBeginEdit (fixture->trans2);
+    xaccTransSetCurrency (fixture->trans2, fixture->commodity);
+    payment = xaccMallocSplit (fixture->book);
+    xaccSplitSetParent (payment, fixture->trans2);
+    xaccSplitSetAccount (payment, fixture->account2);
+    xaccSplitSetValue (payment, gnc_numeric_neg (amt));
+    xaccSplitSetAmount (payment, gnc_numeric_neg (amt));
+    split = xaccMallocSplit (fixture->book);
+    xaccSplitSetParent (split, fixture->trans2);
+    xaccSplitSetAccount (split, fixture->account);
+    xaccSplitSetValue (split, amt);
+    xaccSplitSetAmount (split, amt);
+    xaccTransCommitEdit (fixture->trans2);
+    gnc_lot_add_split (lot, payment);
+    g_assert_true (gnc_numeric_equal (gnc_numeric_create (600, 100),
+                                      gncOwnerGetBalanceInCurrency (&fixture->owner, NULL)));
+
+    xaccTransDestroy (fixture->trans2);
+    fixture->trans2 = NULL;
+    gncInvoiceUnpost (fixture->invoice, TRUE);
+    g_assert_true (gnc_numeric_zero_p (gncOwnerGetBalanceInCurrency (&fixture->owner, NULL)));
+}
+
 
 void
 test_suite_gncInvoice ( void )
@@ -399,6 +454,7 @@ test_suite_gncInvoice ( void )
     GNC_TEST_ADD( suitename, "post trans - customer creditnote", Fixture, &pData, setup_with_invoice, test_invoice_posted_trans, teardown_with_invoice );
     pData.is_cn = FALSE;   // Customer invoice
     GNC_TEST_ADD( suitename, "post trans - customer invoice", Fixture, &pData, setup_with_invoice, test_invoice_posted_trans, teardown_with_invoice );
+    GNC_TEST_ADD( suitename, "owner balance", Fixture, &pData, setup, test_owner_balance, teardown_with_invoice );
 
     /* test txn type heuristics */
     GNC_TEST_ADD( suitename, "tests txntype I & P", Fixture, &pData, setup_with_invoice_and_payment, test_xaccTransGetTxnTypeInvoice, teardown_with_invoice);